@@ -0,0 +1,59 @@
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "binder/binder.h"
+#include "binder/bound_expression.h"
+#include "binder/expressions/bound_constant.h"
+#include "binder/expressions/bound_parameter.h"
+#include "binder/statement/prepare_statement.h"
+#include "common/exception.h"
+
+namespace bustub {
+
+auto Binder::BindPrepare(duckdb_libpgquery::PGPrepareStmt *stmt) -> std::unique_ptr<PrepareStatement> {
+  if (stmt->argtypes != nullptr) {
+    throw NotImplementedException("parameter types are taken from the values passed to EXECUTE");
+  }
+  parameter_count_ = 0;
+  auto statement = BindStatement(stmt->query);
+  switch (statement->type_) {
+    case StatementType::SELECT_STATEMENT:
+    case StatementType::INSERT_STATEMENT:
+    case StatementType::UPDATE_STATEMENT:
+    case StatementType::DELETE_STATEMENT:
+      break;
+    default:
+      throw NotImplementedException(fmt::format("cannot prepare a {} statement", statement->type_));
+  }
+  return std::make_unique<PrepareStatement>(stmt->name, std::move(statement), parameter_count_);
+}
+
+auto Binder::BindExecute(duckdb_libpgquery::PGExecuteStmt *stmt) -> std::unique_ptr<ExecuteStatement> {
+  std::vector<Value> parameters;
+  if (stmt->params != nullptr) {
+    for (auto &expr : BindExpressionList(stmt->params)) {
+      if (expr->type_ != ExpressionType::CONSTANT) {
+        throw NotImplementedException("EXECUTE only supports constant parameters");
+      }
+      parameters.push_back(dynamic_cast<const BoundConstant &>(*expr).val_);
+    }
+  }
+  return std::make_unique<ExecuteStatement>(stmt->name, std::move(parameters));
+}
+
+auto Binder::BindDeallocate(duckdb_libpgquery::PGDeallocateStmt *stmt) -> std::unique_ptr<DeallocateStatement> {
+  return std::make_unique<DeallocateStatement>(stmt->name == nullptr ? "" : stmt->name);
+}
+
+auto Binder::BindParameter(duckdb_libpgquery::PGParamRef *node) -> std::unique_ptr<BoundExpression> {
+  if (node->number < 1) {
+    throw bustub::Exception("parameters are numbered from $1");
+  }
+  parameter_count_ = std::max(parameter_count_, static_cast<size_t>(node->number));
+  return std::make_unique<BoundParameter>(node->number - 1);
+}
+
+}  // namespace bustub
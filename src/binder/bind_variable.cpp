@@ -3,6 +3,7 @@
 #include "binder/binder.h"
 #include "binder/bound_expression.h"
 #include "binder/expressions/bound_constant.h"
+#include "binder/statement/analyze_statement.h"
 #include "binder/statement/set_show_statement.h"
 #include "common/exception.h"
 namespace bustub {
@@ -23,4 +24,22 @@ auto Binder::BindVariableShow(duckdb_libpgquery::PGVariableShowStmt *stmt) -> st
   return std::make_unique<VariableShowStatement>(stmt->name);
 }
 
+auto Binder::BindAnalyze(duckdb_libpgquery::PGVacuumStmt *stmt) -> std::unique_ptr<AnalyzeStatement> {
+  if ((stmt->options & duckdb_libpgquery::PG_VACOPT_ANALYZE) == 0 ||
+      (stmt->options & duckdb_libpgquery::PG_VACOPT_VACUUM) != 0) {
+    throw NotImplementedException("only ANALYZE is supported");
+  }
+  if (stmt->va_cols != nullptr) {
+    throw NotImplementedException("ANALYZE of single columns is not supported");
+  }
+  if (stmt->relation == nullptr) {
+    return std::make_unique<AnalyzeStatement>("");
+  }
+  std::string table_name = stmt->relation->relname;
+  if (catalog_.GetTable(table_name) == nullptr) {
+    throw bustub::Exception(fmt::format("invalid table {}", table_name));
+  }
+  return std::make_unique<AnalyzeStatement>(std::move(table_name));
+}
+
 }  // namespace bustub
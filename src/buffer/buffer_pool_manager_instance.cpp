@@ -13,6 +13,7 @@
 #include "buffer/buffer_pool_manager_instance.h"
 
 #include "common/exception.h"
+#include "common/io_counters.h"
 #include "common/macros.h"
 
 namespace bustub {
@@ -159,6 +160,7 @@ auto BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) -> Page * {
   std::scoped_lock<std::mutex> lock(latch_);
 
   frame_id_t frame_id;
+  thread_io_counters.pages_fetched_++;
   // check if the page is in the buffer pool manager instance
   if (page_table_->Find(page_id, frame_id)) {
     // if the page is in the buffer pool manager instance, return the page pointer
@@ -203,6 +205,7 @@ auto BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) -> Page * {
   // remove the old page from the page table
   page_table_->Remove(frame->GetPageId());
   // read the page from disk
+  thread_io_counters.pages_missed_++;
   disk_manager_->ReadPage(page_id, frame->GetData());
   frame->page_id_ = page_id;
   frame->pin_count_++;
@@ -82,6 +82,7 @@ void TableGenerator::FillTable(TableInfo *info, TableInsertMeta *table_meta) {
       num_inserted++;
     }
   }
+  info->stats_.UpdateRowCount(num_inserted);
 }
 
 void TableGenerator::GenerateTestTables() {
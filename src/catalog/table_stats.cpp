@@ -0,0 +1,155 @@
+#include "catalog/table_stats.h"
+
+#include <algorithm>
+#include <random>
+
+#include "concurrency/transaction.h"
+#include "storage/table/table_heap.h"
+
+namespace bustub {
+
+namespace {
+
+auto IsNumeric(TypeId type_id) -> bool {
+  switch (type_id) {
+    case TypeId::TINYINT:
+    case TypeId::SMALLINT:
+    case TypeId::INTEGER:
+    case TypeId::BIGINT:
+    case TypeId::DECIMAL:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/** Whether `value` can be compared with the values of a column without casting strings */
+auto IsComparable(const Value &column_value, const Value &value) -> bool {
+  return column_value.GetTypeId() == value.GetTypeId() ||
+         (IsNumeric(column_value.GetTypeId()) && IsNumeric(value.GetTypeId()));
+}
+
+auto ToDouble(const Value &value) -> double { return value.CastAs(TypeId::DECIMAL).GetAs<double>(); }
+
+/** Estimates used when the statistics cannot tell, matching the usual textbook defaults */
+constexpr double DEFAULT_EQUAL_SELECTIVITY = 0.005;
+constexpr double DEFAULT_RANGE_SELECTIVITY = 1.0 / 3;
+
+}  // namespace
+
+ColumnStats::ColumnStats(std::vector<Value> sample, const HyperLogLog &distinct, size_t num_buckets)
+    : distinct_count_(distinct.Estimate()) {
+  auto num_sampled = sample.size();
+  sample.erase(std::remove_if(sample.begin(), sample.end(), [](const Value &value) { return value.IsNull(); }),
+               sample.end());
+  if (num_sampled != 0) {
+    null_fraction_ = static_cast<double>(num_sampled - sample.size()) / num_sampled;
+  }
+  if (sample.empty()) {
+    return;
+  }
+  std::sort(sample.begin(), sample.end(), [](const Value &left, const Value &right) {
+    return left.CompareLessThan(right) == CmpBool::CmpTrue;
+  });
+  // There is at least one distinct value, whatever the sketch says.
+  distinct_count_ = std::max<uint64_t>(distinct_count_, 1);
+  num_buckets = std::max<size_t>(std::min(num_buckets, sample.size() - 1), 1);
+  bounds_.reserve(num_buckets + 1);
+  for (size_t i = 0; i <= num_buckets; i++) {
+    bounds_.push_back(sample[std::min(i * sample.size() / num_buckets, sample.size() - 1)]);
+  }
+}
+
+auto ColumnStats::FractionBelow(const Value &value) const -> double {
+  auto it = std::lower_bound(bounds_.begin(), bounds_.end(), value, [](const Value &bound, const Value &value) {
+    return bound.CompareLessThan(value) == CmpBool::CmpTrue;
+  });
+  if (it == bounds_.begin()) {
+    return 0;
+  }
+  if (it == bounds_.end()) {
+    return 1;
+  }
+  auto bucket = static_cast<size_t>(it - bounds_.begin()) - 1;
+  const auto &low = bounds_[bucket];
+  const auto &high = bounds_[bucket + 1];
+  // Values are assumed to be spread evenly within a bucket. Only numbers can be interpolated, for anything else
+  // the value is placed in the middle of its bucket.
+  double within = 0.5;
+  if (IsNumeric(low.GetTypeId()) && IsNumeric(value.GetTypeId())) {
+    auto width = ToDouble(high) - ToDouble(low);
+    within = width > 0 ? (ToDouble(value) - ToDouble(low)) / width : 0;
+  }
+  return (bucket + std::clamp(within, 0.0, 1.0)) / (bounds_.size() - 1);
+}
+
+auto ColumnStats::EstimateEqual(const Value &value) const -> double {
+  if (value.IsNull() || bounds_.empty()) {
+    return 0;
+  }
+  if (!IsComparable(bounds_.front(), value)) {
+    return DEFAULT_EQUAL_SELECTIVITY;
+  }
+  if (value.CompareLessThan(bounds_.front()) == CmpBool::CmpTrue ||
+      value.CompareGreaterThan(bounds_.back()) == CmpBool::CmpTrue) {
+    return 0;
+  }
+  return (1 - null_fraction_) / distinct_count_;
+}
+
+auto ColumnStats::EstimateLess(const Value &value, bool or_equal) const -> double {
+  if (value.IsNull() || bounds_.empty()) {
+    return 0;
+  }
+  if (!IsComparable(bounds_.front(), value)) {
+    return DEFAULT_RANGE_SELECTIVITY;
+  }
+  auto fraction = FractionBelow(value) * (1 - null_fraction_) + (or_equal ? EstimateEqual(value) : 0);
+  return std::clamp(fraction, 0.0, 1 - null_fraction_);
+}
+
+auto ColumnStats::EstimateGreater(const Value &value, bool or_equal) const -> double {
+  if (value.IsNull() || bounds_.empty()) {
+    return 0;
+  }
+  if (!IsComparable(bounds_.front(), value)) {
+    return DEFAULT_RANGE_SELECTIVITY;
+  }
+  return std::max(1 - null_fraction_ - EstimateLess(value, !or_equal), 0.0);
+}
+
+void TableStats::Analyze(TableHeap *table, const Schema &schema, Transaction *txn) {
+  auto num_columns = schema.GetColumnCount();
+  std::vector<HyperLogLog> sketches(num_columns);
+  std::vector<std::vector<Value>> samples(num_columns);
+  // A fixed seed keeps plans stable when the same data is analyzed twice.
+  std::mt19937_64 generator(0);
+  int64_t row_count = 0;
+  for (auto it = table->Begin(txn); it != table->End(); ++it) {
+    const auto &tuple = *it;
+    // Reservoir sampling: the n-th row replaces a random sampled row with probability SAMPLE_SIZE / n.
+    auto slot = static_cast<size_t>(row_count);
+    if (slot >= SAMPLE_SIZE) {
+      slot = std::uniform_int_distribution<size_t>(0, row_count)(generator);
+    }
+    row_count++;
+    for (uint32_t i = 0; i < num_columns; i++) {
+      auto value = tuple.GetValue(&schema, i);
+      sketches[i].Add(value);
+      if (slot < samples[i].size()) {
+        samples[i][slot] = std::move(value);
+      } else if (slot < SAMPLE_SIZE) {
+        samples[i].push_back(std::move(value));
+      }
+    }
+  }
+
+  columns_.clear();
+  columns_.reserve(num_columns);
+  for (uint32_t i = 0; i < num_columns; i++) {
+    columns_.emplace_back(std::move(samples[i]), sketches[i], HISTOGRAM_BUCKETS);
+  }
+  row_count_ = row_count;
+}
+
+}  // namespace bustub
@@ -0,0 +1,51 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arena.cpp
+//
+// Identification: src/common/arena.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/arena.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+void Arena::Clear() {
+  blocks_.clear();
+  cursor_ = nullptr;
+  remaining_ = 0;
+  next_block_size_ = MIN_BLOCK_SIZE;
+  memory_usage_ = 0;
+}
+
+void Arena::Reset() {
+  if (blocks_.empty()) {
+    return;
+  }
+  blocks_.resize(1);
+  cursor_ = blocks_[0].get();
+  remaining_ = first_block_size_;
+  next_block_size_ = std::min(MIN_BLOCK_SIZE * 2, MAX_BLOCK_SIZE);
+  memory_usage_ = first_block_size_;
+}
+
+void Arena::NewBlock(size_t size) {
+  auto block_size = std::max(size, next_block_size_);
+  next_block_size_ = std::min(next_block_size_ * 2, MAX_BLOCK_SIZE);
+  // new[] of char is aligned to at least alignof(std::max_align_t).
+  if (blocks_.empty()) {
+    first_block_size_ = block_size;
+  }
+  blocks_.emplace_back(new char[block_size]);
+  cursor_ = blocks_.back().get();
+  remaining_ = block_size;
+  memory_usage_ += block_size;
+}
+
+}  // namespace bustub
@@ -1,14 +1,19 @@
+#include <algorithm>
+#include <chrono>  // NOLINT
 #include <optional>
 #include <shared_mutex>
 #include <string>
+#include <thread>  // NOLINT
 #include <tuple>
 
 #include "binder/binder.h"
 #include "binder/bound_expression.h"
 #include "binder/bound_statement.h"
+#include "binder/statement/analyze_statement.h"
 #include "binder/statement/create_statement.h"
 #include "binder/statement/explain_statement.h"
 #include "binder/statement/index_statement.h"
+#include "binder/statement/prepare_statement.h"
 #include "binder/statement/select_statement.h"
 #include "binder/statement/set_show_statement.h"
 #include "buffer/buffer_pool_manager_instance.h"
@@ -17,6 +22,7 @@
 #include "common/bustub_instance.h"
 #include "common/enums/statement_type.h"
 #include "common/exception.h"
+#include "common/task_scheduler.h"
 #include "common/util/string_util.h"
 #include "concurrency/lock_manager.h"
 #include "concurrency/transaction.h"
@@ -38,7 +44,32 @@
 namespace bustub {
 
 auto BustubInstance::MakeExecutorContext(Transaction *txn) -> std::unique_ptr<ExecutorContext> {
-  return std::make_unique<ExecutorContext>(txn, catalog_, buffer_pool_manager_, txn_manager_, lock_manager_);
+  return std::make_unique<ExecutorContext>(txn, catalog_, buffer_pool_manager_, txn_manager_, lock_manager_,
+                                           task_scheduler_, GetExecutionThreads(), GetQueryMemoryLimit());
+}
+
+auto BustubInstance::GetQueryMemoryLimit() -> size_t {
+  auto variable = GetSessionVariable("query_memory_limit");
+  if (!variable.empty()) {
+    try {
+      return std::max<int64_t>(std::stoll(variable), 0);
+    } catch (const std::exception &) {
+      // Fall back to the default on garbage input.
+    }
+  }
+  return query_memory_limit;
+}
+
+auto BustubInstance::GetExecutionThreads() -> size_t {
+  auto variable = GetSessionVariable("execution_threads");
+  if (!variable.empty()) {
+    try {
+      return std::max<int64_t>(std::stoll(variable), 1);
+    } catch (const std::exception &) {
+      // Fall back to the default on garbage input.
+    }
+  }
+  return task_scheduler_->GetWorkerCount();
 }
 
 BustubInstance::BustubInstance(const std::string &db_file_name) {
@@ -71,6 +102,9 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
 
   // Execution engine.
   execution_engine_ = new ExecutionEngine(buffer_pool_manager_, txn_manager_, catalog_);
+
+  // Worker threads for parallel query execution.
+  task_scheduler_ = new TaskScheduler(std::thread::hardware_concurrency());
 }
 
 BustubInstance::BustubInstance() {
@@ -103,6 +137,9 @@ BustubInstance::BustubInstance() {
 
   // Execution engine.
   execution_engine_ = new ExecutionEngine(buffer_pool_manager_, txn_manager_, catalog_);
+
+  // Worker threads for parallel query execution.
+  task_scheduler_ = new TaskScheduler(std::thread::hardware_concurrency());
 }
 
 void BustubInstance::CmdDisplayTables(ResultWriter &writer) {
@@ -174,10 +211,17 @@ see the execution plan of your query.
 
 auto BustubInstance::ExecuteSql(const std::string &sql, ResultWriter &writer) -> bool {
   auto txn = txn_manager_->Begin();
-  auto result = ExecuteSqlTxn(sql, writer, txn);
-  txn_manager_->Commit(txn);
-  delete txn;
-  return result;
+  try {
+    auto result = ExecuteSqlTxn(sql, writer, txn);
+    txn_manager_->Commit(txn);
+    delete txn;
+    return result;
+  } catch (...) {
+    // A statement that fails to bind or plan, e.g. an EXECUTE of an unknown statement, must not leak its transaction.
+    txn_manager_->Abort(txn);
+    delete txn;
+    throw;
+  }
 }
 
 auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer, Transaction *txn) -> bool {
@@ -198,6 +242,12 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
     throw Exception(fmt::format("unsupported internal command: {}", sql));
   }
 
+  // A statement run before skips parsing, binding, planning and optimization.
+  auto cache_key = PlanCache::Normalize(sql);
+  if (auto cached = plan_cache_.Get(cache_key, catalog_->GetVersion()); cached.has_value()) {
+    return ExecutePlan(cached->plan_, *cached->output_schema_, writer, txn);
+  }
+
   bool is_successful = true;
 
   std::shared_lock<std::shared_mutex> l(catalog_lock_);
@@ -258,6 +308,56 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
       case StatementType::VARIABLE_SET_STATEMENT: {
         const auto &set_stmt = dynamic_cast<const VariableSetStatement &>(*statement);
         session_variables_[set_stmt.variable_] = set_stmt.value_;
+        // The optimizer may read the variable.
+        plan_cache_.Clear();
+        continue;
+      }
+      case StatementType::PREPARE_STATEMENT: {
+        auto prepare_stmt = std::unique_ptr<PrepareStatement>(dynamic_cast<PrepareStatement *>(statement.release()));
+        if (prepared_statements_.count(prepare_stmt->name_) != 0) {
+          throw bustub::Exception(fmt::format("prepared statement {} already exists", prepare_stmt->name_));
+        }
+        prepared_statements_.emplace(prepare_stmt->name_, std::move(prepare_stmt));
+        continue;
+      }
+      case StatementType::EXECUTE_STATEMENT: {
+        const auto &execute_stmt = dynamic_cast<const ExecuteStatement &>(*statement);
+        is_successful &= ExecutePrepared(GetPreparedStatement(execute_stmt), execute_stmt.parameters_, writer, txn);
+        continue;
+      }
+      case StatementType::DEALLOCATE_STATEMENT: {
+        const auto &deallocate_stmt = dynamic_cast<const DeallocateStatement &>(*statement);
+        // The plan of a statement must not outlive it, as the name may be prepared again.
+        if (deallocate_stmt.name_.empty()) {
+          for (const auto &[name, prepared] : prepared_statements_) {
+            plan_cache_.ErasePrepared(name);
+          }
+          prepared_statements_.clear();
+        } else if (prepared_statements_.erase(deallocate_stmt.name_) == 0) {
+          throw bustub::Exception(fmt::format("prepared statement {} does not exist", deallocate_stmt.name_));
+        } else {
+          plan_cache_.ErasePrepared(deallocate_stmt.name_);
+        }
+        continue;
+      }
+      case StatementType::ANALYZE_STATEMENT: {
+        const auto &analyze_stmt = dynamic_cast<const AnalyzeStatement &>(*statement);
+
+        std::unique_lock<std::shared_mutex> l(catalog_lock_);
+        auto table_names = analyze_stmt.table_.empty() ? catalog_->GetTableNames()
+                                                       : std::vector<std::string>{analyze_stmt.table_};
+        size_t num_analyzed = 0;
+        for (const auto &table_name : table_names) {
+          // Mock tables have no heap to scan.
+          auto *table_info = catalog_->GetTable(table_name);
+          if (table_info != nullptr && table_info->table_ != nullptr) {
+            catalog_->AnalyzeTable(txn, table_info);
+            num_analyzed++;
+          }
+        }
+        l.unlock();
+
+        WriteOneCell(fmt::format("Analyzed {} table(s)", num_analyzed), writer);
         continue;
       }
       case StatementType::EXPLAIN_STATEMENT: {
@@ -272,10 +372,19 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
           output += "\n";
         }
 
+        // EXPLAIN EXECUTE shows the plan of the prepared statement for parameters of the types given.
+        const BoundStatement *explained_stmt = explain_stmt.statement_.get();
+        std::shared_ptr<std::vector<Value>> parameters;
+        if (explained_stmt->type_ == StatementType::EXECUTE_STATEMENT) {
+          const auto &execute_stmt = dynamic_cast<const ExecuteStatement &>(*explained_stmt);
+          explained_stmt = GetPreparedStatement(execute_stmt).statement_.get();
+          parameters = std::make_shared<std::vector<Value>>(execute_stmt.parameters_);
+        }
+
         std::shared_lock<std::shared_mutex> l(catalog_lock_);
 
-        bustub::Planner planner(*catalog_);
-        planner.PlanQuery(*explain_stmt.statement_);
+        bustub::Planner planner(*catalog_, std::move(parameters));
+        planner.PlanQuery(*explained_stmt);
 
         bool show_schema = (explain_stmt.options_ & ExplainOptions::SCHEMA) != 0;
 
@@ -300,6 +409,28 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
           output += "\n";
         }
 
+        // Run the query, discarding its output, and print the optimized plan with what every executor did.
+        if ((explain_stmt.options_ & ExplainOptions::ANALYZE) != 0) {
+          auto exec_ctx = MakeExecutorContext(txn);
+          exec_ctx->EnableProfiling();
+          auto start = std::chrono::steady_clock::now();
+          is_successful &= execution_engine_->Execute(
+              optimized_plan, [](const Tuple &tuple) {}, txn, exec_ctx.get());
+          auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+          const auto *profile = exec_ctx->GetProfile();
+          output += "=== ANALYZE ===";
+          output += "\n";
+          output += optimized_plan->ToString([profile](const AbstractPlanNode &plan) {
+            auto iter = profile->find(&plan);
+            // Plan nodes run inside a parallel pipeline have no executor of their own.
+            return iter == profile->end() ? std::string{"(not instrumented)"} : iter->second.ToString();
+          });
+          output += "\n";
+          output += fmt::format("Execution time: {:.3f}ms, peak memory: {} bytes", elapsed.count(),
+                                exec_ctx->GetMemoryContext()->GetPeakUsage());
+          output += "\n";
+        }
+
         WriteOneCell(output, writer);
 
         continue;
@@ -308,45 +439,95 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
         break;
     }
 
-    std::shared_lock<std::shared_mutex> l(catalog_lock_);
+    // Only a text holding a single statement can be answered from the plan cache.
+    is_successful &=
+        PlanAndExecute(*statement, binder.statement_nodes_.size() == 1 ? &cache_key : nullptr, writer, txn);
+  }
 
-    // Plan the query.
-    bustub::Planner planner(*catalog_);
-    planner.PlanQuery(*statement);
+  return is_successful;
+}
 
-    // Optimize the query.
-    bustub::Optimizer optimizer(*catalog_, IsForceStarterRule());
-    auto optimized_plan = optimizer.Optimize(planner.plan_);
+auto BustubInstance::GetPreparedStatement(const ExecuteStatement &execute_stmt) -> const PrepareStatement & {
+  auto prepared = prepared_statements_.find(execute_stmt.name_);
+  if (prepared == prepared_statements_.end()) {
+    throw bustub::Exception(fmt::format("prepared statement {} does not exist", execute_stmt.name_));
+  }
+  if (execute_stmt.parameters_.size() != prepared->second->parameter_count_) {
+    throw bustub::Exception(fmt::format("prepared statement {} takes {} parameters, {} given", execute_stmt.name_,
+                                        prepared->second->parameter_count_, execute_stmt.parameters_.size()));
+  }
+  return *prepared->second;
+}
 
-    l.unlock();
+auto BustubInstance::PlanAndExecute(const BoundStatement &statement, const std::string *cache_key,
+                                    ResultWriter &writer, Transaction *txn) -> bool {
+  std::shared_lock<std::shared_mutex> l(catalog_lock_);
+  auto catalog_version = catalog_->GetVersion();
 
-    // Execute the query.
-    auto exec_ctx = MakeExecutorContext(txn);
-    std::vector<Tuple> result_set{};
-    is_successful &= execution_engine_->Execute(optimized_plan, &result_set, txn, exec_ctx.get());
+  // Plan the query.
+  bustub::Planner planner(*catalog_);
+  planner.PlanQuery(statement);
 
-    // Return the result set as a vector of string.
-    auto schema = planner.plan_->OutputSchema();
+  // Optimize the query.
+  bustub::Optimizer optimizer(*catalog_, IsForceStarterRule());
+  auto optimized_plan = optimizer.Optimize(planner.plan_);
 
-    // Generate header for the result set.
-    writer.BeginTable(false);
-    writer.BeginHeader();
-    for (const auto &column : schema.GetColumns()) {
-      writer.WriteHeaderCell(column.GetName());
-    }
-    writer.EndHeader();
+  l.unlock();
 
-    // Transforming result set into strings.
-    for (const auto &tuple : result_set) {
-      writer.BeginRow();
-      for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
-        writer.WriteCell(tuple.GetValue(&schema, i).ToString());
-      }
-      writer.EndRow();
-    }
-    writer.EndTable();
+  if (cache_key != nullptr) {
+    plan_cache_.Put(*cache_key, CachedPlan{optimized_plan, planner.plan_->output_schema_, catalog_version, nullptr});
   }
+  return ExecutePlan(optimized_plan, planner.plan_->OutputSchema(), writer, txn);
+}
+
+auto BustubInstance::ExecutePrepared(const PrepareStatement &prepared, const std::vector<Value> &parameters,
+                                     ResultWriter &writer, Transaction *txn) -> bool {
+  // The plan reads the parameters when it runs, binding the values is all an EXECUTE with a cached plan does.
+  if (auto cached = plan_cache_.GetPrepared(prepared.name_, catalog_->GetVersion(), parameters); cached.has_value()) {
+    *cached->parameters_ = parameters;
+    return ExecutePlan(cached->plan_, *cached->output_schema_, writer, txn);
+  }
+
+  std::shared_lock<std::shared_mutex> l(catalog_lock_);
+  auto catalog_version = catalog_->GetVersion();
+  auto bound_parameters = std::make_shared<std::vector<Value>>(parameters);
+  bustub::Planner planner(*catalog_, bound_parameters);
+  planner.PlanQuery(*prepared.statement_);
+  bustub::Optimizer optimizer(*catalog_, IsForceStarterRule());
+  auto optimized_plan = optimizer.Optimize(planner.plan_);
+  l.unlock();
+
+  // A plan made for the values of some parameters, e.g. of `LIMIT $1`, cannot be run with other values.
+  if (!planner.uses_parameter_values_) {
+    plan_cache_.PutPrepared(prepared.name_, CachedPlan{optimized_plan, planner.plan_->output_schema_, catalog_version,
+                                                       std::move(bound_parameters)});
+  }
+  return ExecutePlan(optimized_plan, planner.plan_->OutputSchema(), writer, txn);
+}
 
+auto BustubInstance::ExecutePlan(const AbstractPlanNodeRef &plan, const Schema &schema, ResultWriter &writer,
+                                 Transaction *txn) -> bool {
+  // Generate header for the result set.
+  writer.BeginTable(false);
+  writer.BeginHeader();
+  for (const auto &column : schema.GetColumns()) {
+    writer.WriteHeaderCell(column.GetName());
+  }
+  writer.EndHeader();
+
+  // Execute the query, streaming rows into the writer as they are produced.
+  auto exec_ctx = MakeExecutorContext(txn);
+  auto is_successful = execution_engine_->Execute(
+      plan,
+      [&schema, &writer](const Tuple &tuple) {
+        writer.BeginRow();
+        for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+          writer.WriteCell(tuple.GetValue(&schema, i).ToString());
+        }
+        writer.EndRow();
+      },
+      txn, exec_ctx.get());
+  writer.EndTable();
   return is_successful;
 }
 
@@ -392,6 +573,7 @@ BustubInstance::~BustubInstance() {
     log_manager_->StopFlushThread();
   }
   delete execution_engine_;
+  delete task_scheduler_;
   delete catalog_;
   delete checkpoint_manager_;
   delete log_manager_;
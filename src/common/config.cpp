@@ -20,4 +20,8 @@ std::chrono::duration<int64_t> log_timeout = std::chrono::seconds(1);
 
 std::chrono::milliseconds cycle_detection_interval = std::chrono::milliseconds(50);
 
+std::atomic<size_t> operator_memory_limit(64 << 20);
+
+std::atomic<size_t> query_memory_limit(256 << 20);
+
 }  // namespace bustub
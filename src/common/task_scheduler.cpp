@@ -0,0 +1,201 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// task_scheduler.cpp
+//
+// Identification: src/common/task_scheduler.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/task_scheduler.h"
+
+#include <chrono>  // NOLINT
+#include <utility>
+
+#include "common/logger.h"
+
+namespace bustub {
+
+namespace {
+/** The scheduler owning the calling thread, if any. */
+thread_local const TaskScheduler *current_scheduler = nullptr;
+/** The worker index of the calling thread within `current_scheduler`. */
+thread_local size_t current_worker_idx = 0;
+}  // namespace
+
+TaskScheduler::TaskScheduler(size_t num_workers) {
+  if (num_workers == 0) {
+    num_workers = 1;
+  }
+  queues_.reserve(num_workers);
+  for (size_t i = 0; i < num_workers; i++) {
+    queues_.emplace_back(std::make_unique<WorkerQueue>());
+  }
+  workers_.reserve(num_workers);
+  for (size_t i = 0; i < num_workers; i++) {
+    workers_.emplace_back([this, i] { WorkerLoop(i); });
+  }
+}
+
+TaskScheduler::~TaskScheduler() {
+  {
+    std::scoped_lock<std::mutex> guard(sleep_latch_);
+    stopped_ = true;
+  }
+  sleep_cv_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+void TaskScheduler::Submit(Task task) {
+  size_t queue_idx;
+  if (current_scheduler == this) {
+    // Spawned by a worker: keep it local, other workers will steal it if they run dry.
+    queue_idx = current_worker_idx;
+  } else {
+    queue_idx = next_queue_.fetch_add(1) % queues_.size();
+  }
+  {
+    auto &queue = *queues_[queue_idx];
+    std::scoped_lock<std::mutex> guard(queue.latch_);
+    queue.tasks_.emplace_back(std::move(task));
+  }
+  pending_.fetch_add(1);
+  // Taking the sleep latch makes sure that a worker checking `pending_` cannot miss this notification.
+  std::scoped_lock<std::mutex> guard(sleep_latch_);
+  sleep_cv_.notify_one();
+}
+
+auto TaskScheduler::RunOneTask() -> bool {
+  Task task;
+  auto start_idx = current_scheduler == this ? current_worker_idx : 0;
+  if ((current_scheduler == this && PopLocal(start_idx, &task)) || Steal(start_idx, &task)) {
+    task();
+    return true;
+  }
+  return false;
+}
+
+auto TaskScheduler::GetCurrentWorkerIndex() const -> size_t {
+  if (current_scheduler == this) {
+    return current_worker_idx;
+  }
+  return workers_.size();
+}
+
+void TaskScheduler::WorkerLoop(size_t worker_idx) {
+  current_scheduler = this;
+  current_worker_idx = worker_idx;
+  while (!stopped_) {
+    Task task;
+    if (PopLocal(worker_idx, &task) || Steal(worker_idx + 1, &task)) {
+      try {
+        task();
+      } catch (const std::exception &ex) {
+        LOG_ERROR("Uncaught exception in scheduled task: %s", ex.what());
+      }
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleep_latch_);
+    sleep_cv_.wait(lock, [this] { return stopped_ || pending_ > 0; });
+  }
+}
+
+auto TaskScheduler::PopLocal(size_t worker_idx, Task *task) -> bool {
+  auto &queue = *queues_[worker_idx];
+  std::scoped_lock<std::mutex> guard(queue.latch_);
+  if (queue.tasks_.empty()) {
+    return false;
+  }
+  *task = std::move(queue.tasks_.back());
+  queue.tasks_.pop_back();
+  pending_.fetch_sub(1);
+  return true;
+}
+
+auto TaskScheduler::Steal(size_t start_idx, Task *task) -> bool {
+  if (pending_ == 0) {
+    return false;
+  }
+  for (size_t i = 0; i < queues_.size(); i++) {
+    auto &queue = *queues_[(start_idx + i) % queues_.size()];
+    std::scoped_lock<std::mutex> guard(queue.latch_);
+    if (!queue.tasks_.empty()) {
+      *task = std::move(queue.tasks_.front());
+      queue.tasks_.pop_front();
+      pending_.fetch_sub(1);
+      return true;
+    }
+  }
+  return false;
+}
+
+TaskGroup::~TaskGroup() { WaitQuietly(); }
+
+void TaskGroup::Run(TaskScheduler::Task task) {
+  if (scheduler_ == nullptr) {
+    try {
+      task();
+    } catch (...) {
+      std::scoped_lock<std::mutex> guard(state_->latch_);
+      if (state_->error_ == nullptr) {
+        state_->error_ = std::current_exception();
+      }
+    }
+    return;
+  }
+
+  {
+    std::scoped_lock<std::mutex> guard(state_->latch_);
+    state_->outstanding_++;
+  }
+  scheduler_->Submit([state = state_, task = std::move(task)] {
+    std::exception_ptr error = nullptr;
+    try {
+      task();
+    } catch (...) {
+      error = std::current_exception();
+    }
+    std::scoped_lock<std::mutex> guard(state->latch_);
+    if (error != nullptr && state->error_ == nullptr) {
+      state->error_ = error;
+    }
+    state->outstanding_--;
+    state->cv_.notify_all();
+  });
+}
+
+void TaskGroup::Wait() {
+  WaitQuietly();
+  std::exception_ptr error = nullptr;
+  {
+    std::scoped_lock<std::mutex> guard(state_->latch_);
+    std::swap(error, state_->error_);
+  }
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
+}
+
+void TaskGroup::WaitQuietly() {
+  while (true) {
+    {
+      std::scoped_lock<std::mutex> guard(state_->latch_);
+      if (state_->outstanding_ == 0) {
+        return;
+      }
+    }
+    // Help out with queued work instead of blocking the thread.
+    if (scheduler_ != nullptr && scheduler_->RunOneTask()) {
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(state_->latch_);
+    state_->cv_.wait_for(lock, std::chrono::milliseconds(1), [this] { return state_->outstanding_ == 0; });
+  }
+}
+
+}  // namespace bustub
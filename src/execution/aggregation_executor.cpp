@@ -1,29 +1,540 @@
-//===----------------------------------------------------------------------===//
-//
-//                         BusTub
-//
-// aggregation_executor.cpp
-//
-// Identification: src/execution/aggregation_executor.cpp
-//
-// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
-//
-//===----------------------------------------------------------------------===//
-#include <memory>
-#include <vector>
-
-#include "execution/executors/aggregation_executor.h"
-
-namespace bustub {
-
-AggregationExecutor::AggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan,
-                                         std::unique_ptr<AbstractExecutor> &&child)
-    : AbstractExecutor(exec_ctx) {}
-
-void AggregationExecutor::Init() {}
-
-auto AggregationExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
-
-auto AggregationExecutor::GetChildExecutor() const -> const AbstractExecutor * { return child_.get(); }
-
-}  // namespace bustub
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregation_executor.cpp
+//
+// Identification: src/execution/aggregation_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "execution/executors/aggregation_executor.h"
+#include "type/type_util.h"
+
+namespace bustub {
+
+namespace {
+auto AlignUp(size_t size) -> size_t { return (size + 7) & ~static_cast<size_t>(7); }
+
+auto IsIntegral(TypeId type) -> bool {
+  return type == TypeId::TINYINT || type == TypeId::SMALLINT || type == TypeId::INTEGER || type == TypeId::BIGINT ||
+         type == TypeId::TIMESTAMP;
+}
+
+template <class T>
+auto CheckedCast(int64_t value) -> T {
+  if (value < std::numeric_limits<T>::min() || value > std::numeric_limits<T>::max()) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
+  }
+  return static_cast<T>(value);
+}
+}  // namespace
+
+AggregationHashTable::AggregationHashTable(const std::vector<AbstractExpressionRef> &group_bys,
+                                           const std::vector<AbstractExpressionRef> &agg_exprs,
+                                           const std::vector<AggregationType> &agg_types)
+    : group_bys_(group_bys), agg_exprs_(agg_exprs) {
+  for (size_t i = 0; i < agg_types.size(); i++) {
+    switch (agg_types[i]) {
+      case AggregationType::CountStarAggregate:
+        kernels_.push_back(Kernel::CountStar);
+        agg_output_types_.push_back(TypeId::INTEGER);
+        continue;
+      case AggregationType::CountAggregate:
+        kernels_.push_back(Kernel::Count);
+        agg_output_types_.push_back(TypeId::INTEGER);
+        continue;
+      case AggregationType::SumAggregate:
+      case AggregationType::MinAggregate:
+      case AggregationType::MaxAggregate:
+        break;
+    }
+    auto type = agg_exprs[i]->GetReturnType();
+    if (type == TypeId::VARCHAR && agg_types[i] != AggregationType::SumAggregate) {
+      kernels_.push_back(agg_types[i] == AggregationType::MinAggregate ? Kernel::MinVarchar : Kernel::MaxVarchar);
+      agg_output_types_.push_back(type);
+      continue;
+    }
+    if (type != TypeId::DECIMAL && !IsIntegral(type)) {
+      throw NotImplementedException(
+          fmt::format("aggregate {} over {} is not supported", agg_types[i], Type::TypeIdToString(type)));
+    }
+    auto decimal = type == TypeId::DECIMAL;
+    switch (agg_types[i]) {
+      case AggregationType::SumAggregate:
+        kernels_.push_back(decimal ? Kernel::SumDecimal : Kernel::SumInt);
+        break;
+      case AggregationType::MinAggregate:
+        kernels_.push_back(decimal ? Kernel::MinDecimal : Kernel::MinInt);
+        break;
+      default:
+        kernels_.push_back(decimal ? Kernel::MaxDecimal : Kernel::MaxInt);
+        break;
+    }
+    agg_output_types_.push_back(type);
+  }
+
+  // Lay out the row: key null flags, fixed-size keys, VARCHAR keys, accumulator null flags, accumulators.
+  key_types_.reserve(group_bys.size());
+  key_offsets_.resize(group_bys.size());
+  auto offset = AlignUp(group_bys.size());
+  for (size_t i = 0; i < group_bys.size(); i++) {
+    key_types_.push_back(group_bys[i]->GetReturnType());
+    if (key_types_[i] != TypeId::VARCHAR) {
+      key_offsets_[i] = offset;
+      offset += sizeof(uint64_t);
+    }
+  }
+  fixed_key_size_ = offset;
+  for (size_t i = 0; i < group_bys.size(); i++) {
+    if (key_types_[i] == TypeId::VARCHAR) {
+      key_offsets_[i] = offset;
+      offset += sizeof(VarcharSlot);
+    }
+  }
+  key_size_ = offset;
+  agg_null_offset_ = offset;
+  agg_offset_ = agg_null_offset_ + AlignUp(kernels_.size());
+  row_size_ = std::max(agg_offset_ + kernels_.size() * sizeof(uint64_t), sizeof(uint64_t));
+}
+
+void AggregationHashTable::Update(char *row, const Tuple &tuple, const Schema &schema) {
+  for (size_t i = 0; i < kernels_.size(); i++) {
+    auto *slot = row + agg_offset_ + i * sizeof(uint64_t);
+    if (kernels_[i] == Kernel::CountStar) {
+      Store<int64_t>(slot, Load<int64_t>(slot) + 1);
+      continue;
+    }
+    auto value = agg_exprs_[i]->Evaluate(&tuple, schema);
+    if (value.IsNull()) {
+      continue;
+    }
+    auto &is_null = row[agg_null_offset_ + i];
+    auto first = is_null != 0;
+    is_null = 0;
+    switch (kernels_[i]) {
+      case Kernel::CountStar:
+        break;
+      case Kernel::Count:
+        Store<int64_t>(slot, first ? 1 : Load<int64_t>(slot) + 1);
+        break;
+      case Kernel::SumInt:
+        Store<int64_t>(slot, first ? AsInt(value) : Load<int64_t>(slot) + AsInt(value));
+        break;
+      case Kernel::MinInt:
+        Store<int64_t>(slot, first ? AsInt(value) : std::min(Load<int64_t>(slot), AsInt(value)));
+        break;
+      case Kernel::MaxInt:
+        Store<int64_t>(slot, first ? AsInt(value) : std::max(Load<int64_t>(slot), AsInt(value)));
+        break;
+      case Kernel::SumDecimal:
+        Store<double>(slot, first ? AsDecimal(value) : Load<double>(slot) + AsDecimal(value));
+        break;
+      case Kernel::MinDecimal:
+        Store<double>(slot, first ? AsDecimal(value) : std::min(Load<double>(slot), AsDecimal(value)));
+        break;
+      case Kernel::MaxDecimal:
+        Store<double>(slot, first ? AsDecimal(value) : std::max(Load<double>(slot), AsDecimal(value)));
+        break;
+      case Kernel::MinVarchar:
+      case Kernel::MaxVarchar:
+        if (first || VarcharReplaces(kernels_[i], Load<const char *>(slot), value.GetData(), value.GetLength())) {
+          Store(slot, CopyVarchar(value.GetData(), value.GetLength()));
+        }
+        break;
+    }
+  }
+}
+
+void AggregationHashTable::MergeFrom(const AggregationHashTable &other) {
+  for (const auto &other_slot : other.slots_) {
+    if (other_slot.row_ == nullptr) {
+      continue;
+    }
+    // A row starts with its key, so it can be looked up as is.
+    MergeRow(Lookup(other_slot.row_, other_slot.hash_, true), other_slot.row_);
+  }
+}
+
+void AggregationHashTable::MergeRow(char *row, const char *other_row) {
+  for (size_t i = 0; i < kernels_.size(); i++) {
+    if (other_row[agg_null_offset_ + i] != 0) {
+      continue;
+    }
+    auto *slot = row + agg_offset_ + i * sizeof(uint64_t);
+    const auto *other_slot = other_row + agg_offset_ + i * sizeof(uint64_t);
+    auto &is_null = row[agg_null_offset_ + i];
+    if (kernels_[i] == Kernel::MinVarchar || kernels_[i] == Kernel::MaxVarchar) {
+      // The other table may drop its arena first, so the winner is copied into this one.
+      const auto *other_data = Load<const char *>(other_slot) + sizeof(uint32_t);
+      auto length = Load<uint32_t>(Load<const char *>(other_slot));
+      if (is_null != 0 || VarcharReplaces(kernels_[i], Load<const char *>(slot), other_data, length)) {
+        Store(slot, CopyVarchar(other_data, length));
+      }
+      is_null = 0;
+      continue;
+    }
+    if (is_null != 0) {
+      std::memcpy(slot, other_slot, sizeof(uint64_t));
+      is_null = 0;
+      continue;
+    }
+    switch (kernels_[i]) {
+      case Kernel::CountStar:
+      case Kernel::Count:
+      case Kernel::SumInt:
+        Store<int64_t>(slot, Load<int64_t>(slot) + Load<int64_t>(other_slot));
+        break;
+      case Kernel::MinInt:
+        Store<int64_t>(slot, std::min(Load<int64_t>(slot), Load<int64_t>(other_slot)));
+        break;
+      case Kernel::MaxInt:
+        Store<int64_t>(slot, std::max(Load<int64_t>(slot), Load<int64_t>(other_slot)));
+        break;
+      case Kernel::SumDecimal:
+        Store<double>(slot, Load<double>(slot) + Load<double>(other_slot));
+        break;
+      case Kernel::MinDecimal:
+        Store<double>(slot, std::min(Load<double>(slot), Load<double>(other_slot)));
+        break;
+      case Kernel::MaxDecimal:
+        Store<double>(slot, std::max(Load<double>(slot), Load<double>(other_slot)));
+        break;
+      case Kernel::MinVarchar:
+      case Kernel::MaxVarchar:
+        break;
+    }
+  }
+}
+
+auto AggregationHashTable::CopyVarchar(const char *data, uint32_t length) -> const char * {
+  auto *copy = arena_.Allocate(sizeof(uint32_t) + length);
+  Store(copy, length);
+  std::memcpy(copy + sizeof(uint32_t), data, length);
+  return copy;
+}
+
+auto AggregationHashTable::VarcharReplaces(Kernel kernel, const char *accumulated, const char *data, uint32_t length)
+    -> bool {
+  // Like VARCHAR comparisons, the lengths include the terminating null byte, which is not compared.
+  auto cmp = TypeUtil::CompareStrings(data, static_cast<int>(length) - 1, accumulated + sizeof(uint32_t),
+                                      static_cast<int>(Load<uint32_t>(accumulated)) - 1);
+  return kernel == Kernel::MinVarchar ? cmp < 0 : cmp > 0;
+}
+
+void AggregationHashTable::InsertEmptyGroup() {
+  BUSTUB_ASSERT(group_bys_.empty(), "only an aggregation without group-bys has an empty group");
+  std::vector<char> key(key_size_, 0);
+  Lookup(key.data(), HashKey(key.data()), true);
+}
+
+auto AggregationHashTable::GetGroupValues(size_t group_idx) const -> std::vector<Value> {
+  const auto *row = rows_[group_idx];
+  std::vector<Value> values;
+  values.reserve(key_types_.size() + kernels_.size());
+  for (size_t i = 0; i < key_types_.size(); i++) {
+    if (row[i] != 0) {
+      values.push_back(ValueFactory::GetNullValueByType(key_types_[i]));
+    } else if (key_types_[i] == TypeId::VARCHAR) {
+      auto varchar = Load<VarcharSlot>(row + key_offsets_[i]);
+      values.push_back(ValueFactory::GetVarcharValue(varchar.data_, static_cast<uint32_t>(varchar.length_), true));
+    } else {
+      values.push_back(DecodeFixed(key_types_[i], Load<uint64_t>(row + key_offsets_[i])));
+    }
+  }
+  for (size_t i = 0; i < kernels_.size(); i++) {
+    const auto *slot = row + agg_offset_ + i * sizeof(uint64_t);
+    auto is_varchar = kernels_[i] == Kernel::MinVarchar || kernels_[i] == Kernel::MaxVarchar;
+    if (row[agg_null_offset_ + i] != 0) {
+      // Like the initial value of the aggregate, the null is an integer unless the output column is a VARCHAR.
+      values.push_back(ValueFactory::GetNullValueByType(is_varchar ? TypeId::VARCHAR : TypeId::INTEGER));
+    } else if (is_varchar) {
+      const auto *varchar = Load<const char *>(slot);
+      values.push_back(ValueFactory::GetVarcharValue(varchar + sizeof(uint32_t), Load<uint32_t>(varchar), true));
+    } else {
+      values.push_back(DecodeFixed(agg_output_types_[i], Load<uint64_t>(slot)));
+    }
+  }
+  return values;
+}
+
+void AggregationHashTable::Clear() {
+  arena_.Clear();
+  rows_ = std::vector<char *>{};
+  slots_ = std::vector<Slot>{};
+}
+
+void AggregationHashTable::Reset() {
+  arena_.Reset();
+  rows_.clear();
+  std::fill(slots_.begin(), slots_.end(), Slot{0, nullptr});
+}
+
+auto AggregationHashTable::AsInt(const Value &value) -> int64_t {
+  switch (value.GetTypeId()) {
+    case TypeId::BOOLEAN:
+    case TypeId::TINYINT:
+      return value.GetAs<int8_t>();
+    case TypeId::SMALLINT:
+      return value.GetAs<int16_t>();
+    case TypeId::INTEGER:
+      return value.GetAs<int32_t>();
+    case TypeId::BIGINT:
+      return value.GetAs<int64_t>();
+    case TypeId::TIMESTAMP:
+      return static_cast<int64_t>(value.GetAs<uint64_t>());
+    case TypeId::DECIMAL:
+      return static_cast<int64_t>(value.GetAs<double>());
+    default:
+      throw Exception(ExceptionType::MISMATCH_TYPE, "value is not numeric");
+  }
+}
+
+auto AggregationHashTable::AsDecimal(const Value &value) -> double {
+  if (value.GetTypeId() == TypeId::DECIMAL) {
+    return value.GetAs<double>();
+  }
+  return static_cast<double>(AsInt(value));
+}
+
+auto AggregationHashTable::EncodeFixed(const Value &value) -> uint64_t {
+  if (value.GetTypeId() == TypeId::DECIMAL) {
+    uint64_t bits;
+    auto decimal = value.GetAs<double>();
+    if (decimal == 0) {
+      // -0.0 compares equal to 0.0 and has to land in the same group.
+      decimal = 0;
+    }
+    std::memcpy(&bits, &decimal, sizeof(bits));
+    return bits;
+  }
+  return static_cast<uint64_t>(AsInt(value));
+}
+
+auto AggregationHashTable::DecodeFixed(TypeId type, uint64_t bits) -> Value {
+  auto integer = static_cast<int64_t>(bits);
+  switch (type) {
+    case TypeId::BOOLEAN:
+      return ValueFactory::GetBooleanValue(static_cast<int8_t>(integer));
+    case TypeId::TINYINT:
+      return ValueFactory::GetTinyIntValue(CheckedCast<int8_t>(integer));
+    case TypeId::SMALLINT:
+      return ValueFactory::GetSmallIntValue(CheckedCast<int16_t>(integer));
+    case TypeId::INTEGER:
+      return ValueFactory::GetIntegerValue(CheckedCast<int32_t>(integer));
+    case TypeId::BIGINT:
+      return ValueFactory::GetBigIntValue(integer);
+    case TypeId::TIMESTAMP:
+      return ValueFactory::GetTimestampValue(integer);
+    case TypeId::DECIMAL: {
+      double decimal;
+      std::memcpy(&decimal, &bits, sizeof(decimal));
+      return ValueFactory::GetDecimalValue(decimal);
+    }
+    default:
+      throw Exception(ExceptionType::MISMATCH_TYPE, "value is not fixed-size");
+  }
+}
+
+void AggregationHashTable::EncodeKey(const Tuple &tuple, const Schema &schema, GroupKey *key) const {
+  key->values_.clear();
+  key->bytes_.assign(key_size_, 0);
+  for (const auto &group_by : group_bys_) {
+    key->values_.push_back(group_by->Evaluate(&tuple, schema));
+  }
+  for (size_t i = 0; i < group_bys_.size(); i++) {
+    const auto &value = key->values_[i];
+    auto *slot = key->bytes_.data() + key_offsets_[i];
+    if (value.IsNull()) {
+      key->bytes_[i] = 1;
+    } else if (key_types_[i] == TypeId::VARCHAR) {
+      Store(slot, VarcharSlot{value.GetData(), value.GetLength()});
+    } else {
+      Store(slot, EncodeFixed(value));
+    }
+  }
+  key->hash_ = HashKey(key->bytes_.data());
+}
+
+auto AggregationHashTable::HashKey(const char *key) const -> hash_t {
+  constexpr hash_t multiplier = 0x9e3779b97f4a7c15ULL;
+  hash_t hash = 0;
+  for (size_t offset = 0; offset < fixed_key_size_; offset += sizeof(uint64_t)) {
+    hash = (hash ^ Load<uint64_t>(key + offset)) * multiplier;
+  }
+  for (auto offset = fixed_key_size_; offset < key_size_; offset += sizeof(VarcharSlot)) {
+    auto varchar = Load<VarcharSlot>(key + offset);
+    hash = (hash ^ HashUtil::HashBytes(varchar.data_, varchar.length_)) * multiplier;
+  }
+  return HashUtil::MixHash(hash);
+}
+
+auto AggregationHashTable::KeyEquals(const char *row, const char *key) const -> bool {
+  if (std::memcmp(row, key, fixed_key_size_) != 0) {
+    return false;
+  }
+  for (auto offset = fixed_key_size_; offset < key_size_; offset += sizeof(VarcharSlot)) {
+    auto lhs = Load<VarcharSlot>(row + offset);
+    auto rhs = Load<VarcharSlot>(key + offset);
+    if (lhs.length_ != rhs.length_ || std::memcmp(lhs.data_, rhs.data_, lhs.length_) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+auto AggregationHashTable::Lookup(const char *key, hash_t hash, bool insert) -> char * {
+  if (insert && 2 * (rows_.size() + 1) > slots_.size()) {
+    Grow();
+  }
+  if (slots_.empty()) {
+    return nullptr;
+  }
+  auto slot = SlotOf(hash);
+  for (; slots_[slot].row_ != nullptr; slot = (slot + 1) & (slots_.size() - 1)) {
+    if (slots_[slot].hash_ == hash && KeyEquals(slots_[slot].row_, key)) {
+      return slots_[slot].row_;
+    }
+  }
+  if (!insert) {
+    return nullptr;
+  }
+
+  auto *row = arena_.Allocate(row_size_);
+  std::memcpy(row, key, key_size_);
+  for (auto offset = fixed_key_size_; offset < key_size_; offset += sizeof(VarcharSlot)) {
+    auto varchar = Load<VarcharSlot>(row + offset);
+    auto *data = arena_.Allocate(varchar.length_);
+    std::memcpy(data, varchar.data_, varchar.length_);
+    Store(row + offset, VarcharSlot{data, varchar.length_});
+  }
+  std::memset(row + agg_null_offset_, 0, row_size_ - agg_null_offset_);
+  for (size_t i = 0; i < kernels_.size(); i++) {
+    // COUNT(*) starts at zero, all other aggregates at null.
+    row[agg_null_offset_ + i] = kernels_[i] == Kernel::CountStar ? 0 : 1;
+  }
+  slots_[slot] = Slot{hash, row};
+  rows_.push_back(row);
+  return row;
+}
+
+void AggregationHashTable::Grow() {
+  std::vector<Slot> slots(std::max<size_t>(16, 2 * slots_.size()), Slot{0, nullptr});
+  for (const auto &old : slots_) {
+    if (old.row_ == nullptr) {
+      continue;
+    }
+    auto slot = (old.hash_ >> 32) & (slots.size() - 1);
+    while (slots[slot].row_ != nullptr) {
+      slot = (slot + 1) & (slots.size() - 1);
+    }
+    slots[slot] = old;
+  }
+  slots_ = std::move(slots);
+}
+
+SpillingAggregation::SpillingAggregation(ExecutorContext *exec_ctx, const AggregationPlanNode *plan,
+                                         const Schema *input_schema, size_t memory_limit)
+    : exec_ctx_(exec_ctx),
+      input_schema_(input_schema),
+      memory_limit_(memory_limit),
+      table_(plan->GetGroupBys(), plan->GetAggregates(), plan->GetAggregateTypes()),
+      memory_(exec_ctx->GetMemoryContext()->MakeReservation()) {}
+
+void SpillingAggregation::Aggregate(const std::function<bool(Tuple *)> &next_input, size_t depth) {
+  std::vector<std::unique_ptr<SpillFile>> partitions(NUM_PARTITIONS);
+  auto can_spill = depth < MAX_PARTITION_DEPTH;
+  auto spilling = false;
+  Tuple tuple;
+  AggregationHashTable::GroupKey key;
+  while (next_input(&tuple)) {
+    table_.EncodeKey(tuple, *input_schema_, &key);
+    // The budget is shared with other operators and may allow the table to grow again later. A group created after
+    // some of its tuples were spilled would be emitted twice, so no group is created for the rest of the pass.
+    if (can_spill && !spilling) {
+      auto usage = table_.GetMemoryUsage();
+      spilling = !memory_->Resize(usage) || usage > memory_limit_;
+    }
+    auto *group = table_.FindGroup(key, !spilling);
+    if (group != nullptr) {
+      table_.Update(group, tuple, *input_schema_);
+      continue;
+    }
+    auto &partition = partitions[PartitionOf(key.hash_, depth)];
+    if (partition == nullptr) {
+      partition = std::make_unique<SpillFile>(exec_ctx_->GetBufferPoolManager());
+    }
+    partition->Append(tuple);
+  }
+
+  for (auto &partition : partitions) {
+    if (partition != nullptr) {
+      spilled_.push_back(SpilledPartition{std::move(partition), depth + 1});
+    }
+  }
+}
+
+auto SpillingAggregation::AggregateNextSpilled() -> bool {
+  if (spilled_.empty()) {
+    return false;
+  }
+  auto spilled = std::move(spilled_.back());
+  spilled_.pop_back();
+  table_.Clear();
+  memory_->Resize(0);
+  spilled.file_->Rewind();
+  Aggregate([&](Tuple *input) { return spilled.file_->Next(input); }, spilled.depth_);
+  return true;
+}
+
+void SpillingAggregation::Clear() {
+  table_.Clear();
+  memory_->Resize(0);
+  spilled_.clear();
+}
+
+AggregationExecutor::AggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan,
+                                         std::unique_ptr<AbstractExecutor> &&child)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_(std::move(child)),
+      aggregation_(exec_ctx, plan, &child_->GetOutputSchema()) {}
+
+void AggregationExecutor::Init() {
+  child_->Init();
+  aggregation_.Clear();
+
+  RID rid;
+  aggregation_.Aggregate([&](Tuple *tuple) { return child_->Next(tuple, &rid); });
+  auto &table = aggregation_.GetTable();
+  if (table.Size() == 0 && !aggregation_.HasSpilled() && plan_->GetGroupBys().empty()) {
+    // An aggregation without group-bys produces one row even if the input is empty.
+    table.InsertEmptyGroup();
+  }
+  aht_cursor_ = 0;
+}
+
+auto AggregationExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  while (aht_cursor_ == aggregation_.GetTable().Size()) {
+    if (!aggregation_.AggregateNextSpilled()) {
+      return false;
+    }
+    aht_cursor_ = 0;
+  }
+
+  *tuple = Tuple{aggregation_.GetTable().GetGroupValues(aht_cursor_++), &GetOutputSchema()};
+  *rid = RID{};
+  return true;
+}
+
+auto AggregationExecutor::GetChildExecutor() const -> const AbstractExecutor * { return child_.get(); }
+
+}  // namespace bustub
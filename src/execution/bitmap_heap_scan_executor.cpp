@@ -0,0 +1,162 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bitmap_heap_scan_executor.cpp
+//
+// Identification: src/execution/bitmap_heap_scan_executor.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/bitmap_heap_scan_executor.h"
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include "storage/index/b_plus_tree_index.h"
+
+namespace bustub {
+
+namespace {
+
+/** Orders RIDs by page and then by slot */
+auto RidLess(const RID &a, const RID &b) -> bool {
+  return a.GetPageId() < b.GetPageId() || (a.GetPageId() == b.GetPageId() && a.GetSlotNum() < b.GetSlotNum());
+}
+
+}  // namespace
+
+BitmapHeapScanExecutor::BitmapHeapScanExecutor(ExecutorContext *exec_ctx, const BitmapHeapScanPlanNode *plan)
+    : AbstractExecutor(exec_ctx), plan_(plan), table_info_(exec_ctx->GetCatalog()->GetTable(plan->GetTableOid())) {}
+
+void BitmapHeapScanExecutor::Init() {
+  rids_.clear();
+  rid_cursor_ = 0;
+  page_tuples_.clear();
+  page_cursor_ = 0;
+
+  bool first = true;
+  for (const auto &lookup : plan_->GetLookups()) {
+    auto lookup_rids = LookupRids(lookup);
+    if (first) {
+      rids_ = std::move(lookup_rids);
+      first = false;
+      continue;
+    }
+    std::vector<RID> combined;
+    if (plan_->GetCombineType() == LogicType::And) {
+      std::set_intersection(rids_.begin(), rids_.end(), lookup_rids.begin(), lookup_rids.end(),
+                            std::back_inserter(combined), RidLess);
+    } else {
+      std::set_union(rids_.begin(), rids_.end(), lookup_rids.begin(), lookup_rids.end(), std::back_inserter(combined),
+                     RidLess);
+    }
+    rids_ = std::move(combined);
+    if (rids_.empty() && plan_->GetCombineType() == LogicType::And) {
+      break;
+    }
+  }
+}
+
+auto BitmapHeapScanExecutor::LookupRids(const BitmapIndexLookup &lookup) const -> std::vector<RID> {
+  const auto *index_info = exec_ctx_->GetCatalog()->GetIndex(lookup.index_oid_);
+  if (lookup.IsRange()) {
+    return LookupRange(*index_info, lookup);
+  }
+  const auto &key_schema = *index_info->index_->GetKeySchema();
+  std::vector<Tuple> keys;
+  keys.reserve(lookup.keys_.size());
+  for (const auto &key_expr : lookup.keys_) {
+    // Null never compares equal, so it cannot match.
+    if (auto key = key_expr->Evaluate(nullptr, key_schema); !key.IsNull()) {
+      keys.emplace_back(std::vector<Value>{key}, &key_schema);
+    }
+  }
+  std::vector<std::vector<RID>> key_rids;
+  index_info->index_->ScanKeys(keys, &key_rids, exec_ctx_->GetTransaction());
+
+  std::vector<RID> rids;
+  for (const auto &found : key_rids) {
+    rids.insert(rids.end(), found.begin(), found.end());
+  }
+  std::sort(rids.begin(), rids.end(), RidLess);
+  rids.erase(std::unique(rids.begin(), rids.end()), rids.end());
+  return rids;
+}
+
+auto BitmapHeapScanExecutor::LookupRange(const IndexInfo &index_info, const BitmapIndexLookup &lookup) const
+    -> std::vector<RID> {
+  auto *tree = dynamic_cast<BPlusTreeIndexForOneIntegerColumn *>(index_info.index_.get());
+  auto *key_schema = index_info.index_->GetKeySchema();
+  const auto &lower = lookup.lower_;
+  const auto &upper = lookup.upper_;
+  IntegerKeyType lower_key;
+  if (lower.has_value()) {
+    lower_key.SetFromKey(Tuple{std::vector<Value>{lower->key_}, key_schema});
+  }
+
+  // Only RIDs are copied while the iterator latches the leaf pages, the heap is read once they are all sorted.
+  std::vector<RID> rids;
+  for (auto iter = lower.has_value() ? tree->GetBeginIterator(lower_key) : tree->GetBeginIterator();
+       iter != tree->GetEndIterator(); ++iter) {
+    auto key = (*iter).first.ToValue(key_schema, 0);
+    if (key.IsNull()) {
+      continue;
+    }
+    if (lower.has_value() && !lower->inclusive_ && key.CompareEquals(lower->key_) == CmpBool::CmpTrue) {
+      continue;
+    }
+    if (upper.has_value() && (key.CompareGreaterThan(upper->key_) == CmpBool::CmpTrue ||
+                              (!upper->inclusive_ && key.CompareEquals(upper->key_) == CmpBool::CmpTrue))) {
+      break;
+    }
+    rids.push_back((*iter).second);
+  }
+  std::sort(rids.begin(), rids.end(), RidLess);
+  return rids;
+}
+
+auto BitmapHeapScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  while (true) {
+    while (page_cursor_ < page_tuples_.size()) {
+      auto &[page_tuple, page_rid] = page_tuples_[page_cursor_++];
+      if (plan_->filter_predicate_ != nullptr) {
+        auto value = plan_->filter_predicate_->Evaluate(&page_tuple, GetOutputSchema());
+        if (value.IsNull() || !value.GetAs<bool>()) {
+          continue;
+        }
+      }
+      if (!RuntimeFiltersPass(runtime_filters_, page_tuple, GetOutputSchema())) {
+        continue;
+      }
+      *tuple = std::move(page_tuple);
+      *rid = page_rid;
+      return true;
+    }
+    if (!FetchNextPage()) {
+      return false;
+    }
+  }
+}
+
+auto BitmapHeapScanExecutor::FetchNextPage() -> bool {
+  page_tuples_.clear();
+  page_cursor_ = 0;
+  if (rid_cursor_ == rids_.size()) {
+    return false;
+  }
+  auto page_id = rids_[rid_cursor_].GetPageId();
+  auto page_end = rid_cursor_;
+  while (page_end < rids_.size() && rids_[page_end].GetPageId() == page_id) {
+    page_end++;
+  }
+  std::vector<RID> page_rids(rids_.begin() + rid_cursor_, rids_.begin() + page_end);
+  rid_cursor_ = page_end;
+  table_info_->table_->GetPageTuples(page_rids, &page_tuples_, exec_ctx_->GetTransaction());
+  return true;
+}
+
+}  // namespace bustub
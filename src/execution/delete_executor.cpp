@@ -22,7 +22,10 @@ DeleteExecutor::DeleteExecutor(ExecutorContext *exec_ctx, const DeletePlanNode *
   table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->TableOid());
 }
 
-void DeleteExecutor::Init() {}
+void DeleteExecutor::Init() {
+  child_executor_->Init();
+  is_success_ = false;
+}
 
 auto DeleteExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool {
   if (is_success_) {
@@ -42,6 +45,7 @@ auto DeleteExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool {
       }
     }
   }
+  table_info_->stats_.UpdateRowCount(-count);
   // return the number of deleted rows
   std::vector<Value> values;
   values.emplace_back(INTEGER, count);
@@ -17,18 +17,25 @@
 
 #include "execution/executors/abstract_executor.h"
 #include "execution/executors/aggregation_executor.h"
+#include "execution/executors/bitmap_heap_scan_executor.h"
 #include "execution/executors/delete_executor.h"
 #include "execution/executors/filter_executor.h"
+#include "execution/executors/gather_executor.h"
 #include "execution/executors/hash_join_executor.h"
 #include "execution/executors/index_scan_executor.h"
 #include "execution/executors/insert_executor.h"
 #include "execution/executors/limit_executor.h"
+#include "execution/executors/merge_join_executor.h"
 #include "execution/executors/mock_scan_executor.h"
 #include "execution/executors/nested_index_join_executor.h"
 #include "execution/executors/nested_loop_join_executor.h"
+#include "execution/executors/parallel_aggregation_executor.h"
+#include "execution/executors/parallel_topn_executor.h"
+#include "execution/executors/profiling_executor.h"
 #include "execution/executors/projection_executor.h"
 #include "execution/executors/seq_scan_executor.h"
 #include "execution/executors/sort_executor.h"
+#include "execution/executors/stream_aggregation_executor.h"
 #include "execution/executors/topn_executor.h"
 #include "execution/executors/update_executor.h"
 #include "execution/executors/values_executor.h"
@@ -38,12 +45,28 @@
 #include "execution/plans/sort_plan.h"
 #include "execution/plans/topn_plan.h"
 #include "execution/plans/values_plan.h"
+#include "execution/pipeline.h"
 #include "storage/index/generic_key.h"
 
 namespace bustub {
 
 auto ExecutorFactory::CreateExecutor(ExecutorContext *exec_ctx, const AbstractPlanNodeRef &plan)
     -> std::unique_ptr<AbstractExecutor> {
+  auto executor = CreatePlanExecutor(exec_ctx, plan);
+  // Every executor of a profiled query records what it does, see EXPLAIN ANALYZE
+  if (auto *profile = exec_ctx->GetProfile(); profile != nullptr) {
+    return std::make_unique<ProfilingExecutor>(exec_ctx, std::move(executor), &(*profile)[plan.get()]);
+  }
+  return executor;
+}
+
+auto ExecutorFactory::CreatePlanExecutor(ExecutorContext *exec_ctx, const AbstractPlanNodeRef &plan)
+    -> std::unique_ptr<AbstractExecutor> {
+  // Run scan pipelines morsel by morsel on the task scheduler if the query may use more than one worker
+  if (Pipeline::ShouldRunParallel(exec_ctx, *plan)) {
+    return std::make_unique<GatherExecutor>(exec_ctx, plan);
+  }
+
   switch (plan->GetType()) {
     // Create a new sequential scan executor
     case PlanType::SeqScan: {
@@ -55,6 +78,12 @@ auto ExecutorFactory::CreateExecutor(ExecutorContext *exec_ctx, const AbstractPl
       return std::make_unique<IndexScanExecutor>(exec_ctx, dynamic_cast<const IndexScanPlanNode *>(plan.get()));
     }
 
+    // Create a new bitmap heap scan executor
+    case PlanType::BitmapHeapScan: {
+      return std::make_unique<BitmapHeapScanExecutor>(exec_ctx,
+                                                      dynamic_cast<const BitmapHeapScanPlanNode *>(plan.get()));
+    }
+
     // Create a new insert executor
     case PlanType::Insert: {
       auto insert_plan = dynamic_cast<const InsertPlanNode *>(plan.get());
@@ -86,10 +115,20 @@ auto ExecutorFactory::CreateExecutor(ExecutorContext *exec_ctx, const AbstractPl
     // Create a new aggregation executor
     case PlanType::Aggregation: {
       auto agg_plan = dynamic_cast<const AggregationPlanNode *>(plan.get());
+      if (Pipeline::ShouldRunParallel(exec_ctx, *agg_plan->GetChildPlan())) {
+        return std::make_unique<ParallelAggregationExecutor>(exec_ctx, agg_plan);
+      }
       auto child_executor = ExecutorFactory::CreateExecutor(exec_ctx, agg_plan->GetChildPlan());
       return std::make_unique<AggregationExecutor>(exec_ctx, agg_plan, std::move(child_executor));
     }
 
+    // Create a new stream aggregation executor
+    case PlanType::StreamAggregation: {
+      auto stream_agg_plan = dynamic_cast<const StreamAggregationPlanNode *>(plan.get());
+      auto child_executor = ExecutorFactory::CreateExecutor(exec_ctx, stream_agg_plan->GetChildPlan());
+      return std::make_unique<StreamAggregationExecutor>(exec_ctx, stream_agg_plan, std::move(child_executor));
+    }
+
     // Create a new nested-loop join executor
     case PlanType::NestedLoopJoin: {
       auto nested_loop_join_plan = dynamic_cast<const NestedLoopJoinPlanNode *>(plan.get());
@@ -114,6 +153,14 @@ auto ExecutorFactory::CreateExecutor(ExecutorContext *exec_ctx, const AbstractPl
       return std::make_unique<HashJoinExecutor>(exec_ctx, hash_join_plan, std::move(left), std::move(right));
     }
 
+    // Create a new merge join executor
+    case PlanType::MergeJoin: {
+      auto merge_join_plan = dynamic_cast<const MergeJoinPlanNode *>(plan.get());
+      auto left = ExecutorFactory::CreateExecutor(exec_ctx, merge_join_plan->GetLeftPlan());
+      auto right = ExecutorFactory::CreateExecutor(exec_ctx, merge_join_plan->GetRightPlan());
+      return std::make_unique<MergeJoinExecutor>(exec_ctx, merge_join_plan, std::move(left), std::move(right));
+    }
+
     // Create a new mock scan executor
     case PlanType::MockScan: {
       const auto *mock_scan_plan = dynamic_cast<const MockScanPlanNode *>(plan.get());
@@ -150,6 +197,9 @@ auto ExecutorFactory::CreateExecutor(ExecutorContext *exec_ctx, const AbstractPl
       // Create a new topN executor
     case PlanType::TopN: {
       const auto *topn_plan = dynamic_cast<const TopNPlanNode *>(plan.get());
+      if (Pipeline::ShouldRunParallel(exec_ctx, *topn_plan->GetChildPlan())) {
+        return std::make_unique<ParallelTopNExecutor>(exec_ctx, topn_plan);
+      }
       auto child = ExecutorFactory::CreateExecutor(exec_ctx, topn_plan->GetChildPlan());
       return std::make_unique<TopNExecutor>(exec_ctx, topn_plan, std::move(child));
     }
@@ -10,6 +10,7 @@
 #include "execution/plans/limit_plan.h"
 #include "execution/plans/projection_plan.h"
 #include "execution/plans/sort_plan.h"
+#include "execution/plans/stream_aggregation_plan.h"
 #include "execution/plans/topn_plan.h"
 
 namespace bustub {
@@ -31,10 +32,26 @@ auto AbstractPlanNode::ChildrenToString(int indent, bool with_schema) const -> s
   return fmt::format("\n{}", fmt::join(children_str, "\n"));
 }
 
+auto AbstractPlanNode::ToString(const std::function<std::string(const AbstractPlanNode &)> &annotate) const
+    -> std::string {
+  std::vector<std::string> lines{fmt::format("{} {}", PlanNodeToString(), annotate(*this))};
+  auto indent_str = StringUtil::Indent(2);
+  for (const auto &child : children_) {
+    for (auto &line : StringUtil::Split(child->ToString(annotate), '\n')) {
+      lines.push_back(fmt::format("{}{}", indent_str, line));
+    }
+  }
+  return fmt::format("{}", fmt::join(lines, "\n"));
+}
+
 auto AggregationPlanNode::PlanNodeToString() const -> std::string {
   return fmt::format("Agg {{ types={}, aggregates={}, group_by={} }}", agg_types_, aggregates_, group_bys_);
 }
 
+auto StreamAggregationPlanNode::PlanNodeToString() const -> std::string {
+  return fmt::format("StreamAgg {{ types={}, aggregates={}, group_by={} }}", agg_types_, aggregates_, group_bys_);
+}
+
 auto ProjectionPlanNode::PlanNodeToString() const -> std::string {
   return fmt::format("Projection {{ exprs={} }}", expressions_);
 }
@@ -0,0 +1,144 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// gather_executor.cpp
+//
+// Identification: src/execution/gather_executor.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/gather_executor.h"
+
+#include <chrono>  // NOLINT
+
+namespace bustub {
+
+GatherExecutor::GatherExecutor(ExecutorContext *exec_ctx, AbstractPlanNodeRef plan)
+    : AbstractExecutor(exec_ctx), pipeline_(exec_ctx, std::move(plan)) {}
+
+GatherExecutor::~GatherExecutor() { Cancel(); }
+
+void GatherExecutor::Init() {
+  Cancel();
+  morsels_ = pipeline_.MakeMorsels();
+  outputs_ = std::vector<MorselOutput>(morsels_.size());
+  next_morsel_ = 0;
+  current_morsel_ = 0;
+  current_tuples_.clear();
+  current_loaded_ = false;
+  cursor_ = 0;
+  serial_executor_ = nullptr;
+
+  if (morsels_.size() == 1) {
+    // Not worth a round trip through the scheduler.
+    serial_residual_filters_.clear();
+    serial_executor_ = MakeMorselExecutor(morsels_[0], &serial_residual_filters_);
+    serial_executor_->Init();
+    return;
+  }
+  cancelled_ = false;
+  tasks_ = std::make_unique<TaskGroup>(GetExecutorContext()->GetTaskScheduler());
+  ScheduleMorsels();
+}
+
+auto GatherExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  if (serial_executor_ != nullptr) {
+    while (serial_executor_->Next(tuple, rid)) {
+      if (RuntimeFiltersPass(serial_residual_filters_, *tuple, GetOutputSchema())) {
+        return true;
+      }
+    }
+    return false;
+  }
+  while (current_morsel_ < morsels_.size()) {
+    if (!current_loaded_) {
+      WaitForCurrentMorsel();
+      ScheduleMorsels();
+    }
+    if (cursor_ < current_tuples_.size()) {
+      *tuple = std::move(current_tuples_[cursor_].first);
+      *rid = current_tuples_[cursor_].second;
+      cursor_++;
+      return true;
+    }
+    current_morsel_++;
+    current_loaded_ = false;
+  }
+  return false;
+}
+
+void GatherExecutor::ScheduleMorsels() {
+  auto window = 2 * GetExecutorContext()->GetParallelism();
+  while (next_morsel_ < morsels_.size() && next_morsel_ < current_morsel_ + window) {
+    auto morsel_idx = next_morsel_++;
+    tasks_->Run([this, morsel_idx] { RunMorsel(morsel_idx); });
+  }
+}
+
+void GatherExecutor::RunMorsel(size_t morsel_idx) {
+  std::vector<std::pair<Tuple, RID>> tuples;
+  std::exception_ptr error = nullptr;
+  try {
+    std::vector<RuntimeFilterRef> residual_filters;
+    auto executor = MakeMorselExecutor(morsels_[morsel_idx], &residual_filters);
+    executor->Init();
+    Tuple tuple;
+    RID rid;
+    while (!cancelled_ && executor->Next(&tuple, &rid)) {
+      if (RuntimeFiltersPass(residual_filters, tuple, GetOutputSchema())) {
+        tuples.emplace_back(std::move(tuple), rid);
+      }
+    }
+  } catch (...) {
+    error = std::current_exception();
+  }
+  std::scoped_lock<std::mutex> guard(latch_);
+  auto &output = outputs_[morsel_idx];
+  output.tuples_ = std::move(tuples);
+  output.error_ = error;
+  output.done_ = true;
+  cv_.notify_all();
+}
+
+void GatherExecutor::WaitForCurrentMorsel() {
+  auto *scheduler = GetExecutorContext()->GetTaskScheduler();
+  std::unique_lock<std::mutex> lock(latch_);
+  auto &output = outputs_[current_morsel_];
+  while (!output.done_) {
+    lock.unlock();
+    // Help with the queued morsels instead of idling.
+    if (!scheduler->RunOneTask()) {
+      lock.lock();
+      cv_.wait_for(lock, std::chrono::milliseconds(1), [&output] { return output.done_; });
+    } else {
+      lock.lock();
+    }
+  }
+  if (output.error_ != nullptr) {
+    std::rethrow_exception(output.error_);
+  }
+  current_tuples_ = std::move(output.tuples_);
+  current_loaded_ = true;
+  cursor_ = 0;
+}
+
+auto GatherExecutor::MakeMorselExecutor(const Morsel &morsel, std::vector<RuntimeFilterRef> *residual_filters)
+    -> std::unique_ptr<AbstractExecutor> {
+  auto executor = pipeline_.MakeExecutor(morsel);
+  for (const auto &filter : runtime_filters_) {
+    if (!executor->AddRuntimeFilter(filter)) {
+      residual_filters->push_back(filter);
+    }
+  }
+  return executor;
+}
+
+void GatherExecutor::Cancel() {
+  cancelled_ = true;
+  tasks_ = nullptr;
+}
+
+}  // namespace bustub
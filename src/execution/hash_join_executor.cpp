@@ -12,23 +12,314 @@
 
 #include "execution/executors/hash_join_executor.h"
 
-// Note for 2022 Fall: You don't need to implement HashJoinExecutor to pass all tests. You ONLY need to implement it
-// if you want to get faster in leaderboard tests.
+#include <algorithm>
+
+#include "type/value_factory.h"
 
 namespace bustub {
 
+void JoinHashTable::Insert(hash_t hash, Value key, Tuple tuple) {
+  memory_usage_ += sizeof(Entry) + 2 * sizeof(uint32_t) + tuple.GetLength();
+  if (key.GetTypeId() == TypeId::VARCHAR) {
+    memory_usage_ += key.GetLength();
+  }
+  entries_.push_back(Entry{hash, std::move(key), std::move(tuple), 0});
+}
+
+void JoinHashTable::Build() {
+  size_t capacity = 16;
+  while (capacity < 2 * entries_.size()) {
+    capacity <<= 1;
+  }
+  slots_.assign(capacity, 0);
+  // Insert back to front and prepend to the chains, so that every chain ends up in insertion order.
+  for (auto i = entries_.size(); i > 0; i--) {
+    auto &entry = entries_[i - 1];
+    for (auto slot = SlotOf(entry.hash_);; slot = (slot + 1) & (capacity - 1)) {
+      if (slots_[slot] == 0) {
+        slots_[slot] = i;
+        break;
+      }
+      const auto &head = entries_[slots_[slot] - 1];
+      if (head.hash_ == entry.hash_ && head.key_.CompareEquals(entry.key_) == CmpBool::CmpTrue) {
+        entry.next_ = slots_[slot];
+        slots_[slot] = i;
+        break;
+      }
+    }
+  }
+}
+
+auto JoinHashTable::Find(hash_t hash, const Value &key) const -> const Entry * {
+  if (slots_.empty()) {
+    return nullptr;
+  }
+  for (auto slot = SlotOf(hash); slots_[slot] != 0; slot = (slot + 1) & (slots_.size() - 1)) {
+    const auto &head = entries_[slots_[slot] - 1];
+    if (head.hash_ == hash && head.key_.CompareEquals(key) == CmpBool::CmpTrue) {
+      return &head;
+    }
+  }
+  return nullptr;
+}
+
+void JoinHashTable::Clear() {
+  entries_.clear();
+  entries_.shrink_to_fit();
+  slots_.clear();
+  slots_.shrink_to_fit();
+  memory_usage_ = 0;
+}
+
 HashJoinExecutor::HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
                                    std::unique_ptr<AbstractExecutor> &&left_child,
                                    std::unique_ptr<AbstractExecutor> &&right_child)
-    : AbstractExecutor(exec_ctx) {
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      left_child_(std::move(left_child)),
+      right_child_(std::move(right_child)),
+      memory_(exec_ctx->GetMemoryContext()->MakeReservation()) {
   if (!(plan->GetJoinType() == JoinType::LEFT || plan->GetJoinType() == JoinType::INNER)) {
     // Note for 2022 Fall: You ONLY need to implement left join and inner join.
     throw bustub::NotImplementedException(fmt::format("join type {} not supported", plan->GetJoinType()));
   }
+  // Probe tuples without a match are still emitted by a left join, so they cannot be filtered out.
+  if (plan->GetJoinType() == JoinType::INNER) {
+    runtime_filter_ = std::make_shared<RuntimeFilter>(plan->left_key_expression_);
+    if (!left_child_->AddRuntimeFilter(runtime_filter_)) {
+      runtime_filter_ = nullptr;
+    }
+  }
+}
+
+void HashJoinExecutor::Init() {
+  right_child_->Init();
+  spilled_.clear();
+  joining_spilled_ = false;
+  spilled_table_.Clear();
+  spilled_probe_file_ = nullptr;
+  match_ = nullptr;
+  probe_matched_ = false;
+  has_probe_tuple_ = false;
+  BuildPartitions();
+  // The probe side may start producing tuples right away, so it is initialized once the runtime filter is complete.
+  left_child_->Init();
+}
+
+auto HashJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  while (true) {
+    if (has_probe_tuple_) {
+      if (match_ != nullptr) {
+        *tuple = MakeOutputTuple(probe_tuple_, &match_->tuple_);
+        match_ = match_table_->FindNext(match_);
+        probe_matched_ = true;
+        return true;
+      }
+      has_probe_tuple_ = false;
+      if (!probe_matched_ && plan_->GetJoinType() == JoinType::LEFT) {
+        *tuple = MakeOutputTuple(probe_tuple_, nullptr);
+        return true;
+      }
+    }
+    if (!NextProbeTuple()) {
+      return false;
+    }
+  }
+}
+
+void HashJoinExecutor::BuildPartitions() {
+  partitions_ = std::vector<Partition>(NUM_PARTITIONS);
+  memory_usage_ = 0;
+  memory_->Resize(0);
+  if (runtime_filter_ != nullptr) {
+    runtime_filter_->Clear(memory_->GetBudget() / RUNTIME_FILTER_BUDGET_SHARE);
+  }
+  const auto &right_schema = right_child_->GetOutputSchema();
+  Tuple tuple;
+  RID rid;
+  while (right_child_->Next(&tuple, &rid)) {
+    auto key = plan_->RightJoinKeyExpression().Evaluate(&tuple, right_schema);
+    if (key.IsNull()) {
+      // Null keys never match anything.
+      continue;
+    }
+    if (runtime_filter_ != nullptr) {
+      runtime_filter_->Insert(key);
+    }
+    auto hash = HashUtil::HashKey(key);
+    auto &partition = partitions_[PartitionOf(hash, 0)];
+    if (partition.build_file_ != nullptr) {
+      partition.build_file_->Append(tuple);
+      continue;
+    }
+    auto usage_before = partition.table_.GetMemoryUsage();
+    partition.table_.Insert(hash, std::move(key), std::move(tuple));
+    memory_usage_ += partition.table_.GetMemoryUsage() - usage_before;
+    while (!memory_->Resize(BuildMemoryUsage()) && SpillLargestPartition()) {
+    }
+  }
+  for (auto &partition : partitions_) {
+    if (partition.build_file_ == nullptr) {
+      partition.table_.Build();
+    }
+  }
+  if (runtime_filter_ != nullptr) {
+    runtime_filter_->Build();
+    memory_->Resize(BuildMemoryUsage());
+  }
+}
+
+auto HashJoinExecutor::SpillLargestPartition() -> bool {
+  Partition *largest = nullptr;
+  for (auto &partition : partitions_) {
+    if (partition.build_file_ == nullptr && partition.table_.GetMemoryUsage() > 0 &&
+        (largest == nullptr || partition.table_.GetMemoryUsage() > largest->table_.GetMemoryUsage())) {
+      largest = &partition;
+    }
+  }
+  if (largest == nullptr) {
+    return false;
+  }
+  auto *bpm = GetExecutorContext()->GetBufferPoolManager();
+  largest->build_file_ = std::make_unique<SpillFile>(bpm);
+  largest->probe_file_ = std::make_unique<SpillFile>(bpm);
+  for (const auto &entry : largest->table_.GetEntries()) {
+    largest->build_file_->Append(entry.tuple_);
+  }
+  memory_usage_ -= largest->table_.GetMemoryUsage();
+  memory_->Resize(BuildMemoryUsage());
+  largest->table_.Clear();
+  return true;
+}
+
+auto HashJoinExecutor::NextProbeTuple() -> bool {
+  const auto &left_schema = left_child_->GetOutputSchema();
+  probe_matched_ = false;
+  while (!joining_spilled_) {
+    RID rid;
+    if (!left_child_->Next(&probe_tuple_, &rid)) {
+      // The probe side is exhausted, the spilled partitions are next.
+      for (auto &partition : partitions_) {
+        if (partition.build_file_ != nullptr) {
+          spilled_.push_back(SpilledPartition{std::move(partition.build_file_), std::move(partition.probe_file_), 1});
+        }
+      }
+      partitions_.clear();
+      if (runtime_filter_ != nullptr) {
+        // The probe side is done with the filter.
+        runtime_filter_->Clear();
+      }
+      memory_usage_ = 0;
+      memory_->Resize(0);
+      joining_spilled_ = true;
+      break;
+    }
+    auto key = plan_->LeftJoinKeyExpression().Evaluate(&probe_tuple_, left_schema);
+    if (key.IsNull()) {
+      match_ = nullptr;
+      has_probe_tuple_ = true;
+      return true;
+    }
+    auto hash = HashUtil::HashKey(key);
+    auto &partition = partitions_[PartitionOf(hash, 0)];
+    if (partition.probe_file_ != nullptr) {
+      partition.probe_file_->Append(probe_tuple_);
+      continue;
+    }
+    match_table_ = &partition.table_;
+    match_ = match_table_->Find(hash, key);
+    has_probe_tuple_ = true;
+    return true;
+  }
+
+  while (spilled_probe_file_ == nullptr || !spilled_probe_file_->Next(&probe_tuple_)) {
+    if (!LoadSpilledPartition()) {
+      return false;
+    }
+  }
+  // Only tuples with non-null keys are spilled.
+  auto key = plan_->LeftJoinKeyExpression().Evaluate(&probe_tuple_, left_schema);
+  match_table_ = &spilled_table_;
+  match_ = match_table_->Find(HashUtil::HashKey(key), key);
+  has_probe_tuple_ = true;
+  return true;
 }
 
-void HashJoinExecutor::Init() { throw NotImplementedException("HashJoinExecutor is not implemented"); }
+auto HashJoinExecutor::LoadSpilledPartition() -> bool {
+  spilled_probe_file_ = nullptr;
+  spilled_table_.Clear();
+  while (!spilled_.empty()) {
+    auto spilled = std::move(spilled_.back());
+    spilled_.pop_back();
+    if (spilled.probe_file_->GetTupleCount() == 0 ||
+        (spilled.build_file_->GetTupleCount() == 0 && plan_->GetJoinType() == JoinType::INNER)) {
+      // Nothing can come out of this partition.
+      continue;
+    }
+    if (spilled.build_file_->GetSize() > memory_->GetBudget() && spilled.depth_ < MAX_PARTITION_DEPTH) {
+      RepartitionSpilled(std::move(spilled));
+      continue;
+    }
 
-auto HashJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+    const auto &right_schema = right_child_->GetOutputSchema();
+    Tuple tuple;
+    spilled.build_file_->Rewind();
+    while (spilled.build_file_->Next(&tuple)) {
+      auto key = plan_->RightJoinKeyExpression().Evaluate(&tuple, right_schema);
+      auto hash = HashUtil::HashKey(key);
+      spilled_table_.Insert(hash, std::move(key), std::move(tuple));
+    }
+    spilled_table_.Build();
+    memory_->Resize(spilled_table_.GetMemoryUsage());
+    spilled_probe_file_ = std::move(spilled.probe_file_);
+    spilled_probe_file_->Rewind();
+    return true;
+  }
+  return false;
+}
+
+void HashJoinExecutor::RepartitionSpilled(SpilledPartition spilled) {
+  auto *bpm = GetExecutorContext()->GetBufferPoolManager();
+  std::vector<SpilledPartition> children(NUM_PARTITIONS);
+  for (auto &child : children) {
+    child.build_file_ = std::make_unique<SpillFile>(bpm);
+    child.probe_file_ = std::make_unique<SpillFile>(bpm);
+    child.depth_ = spilled.depth_ + 1;
+  }
+  Tuple tuple;
+  spilled.build_file_->Rewind();
+  while (spilled.build_file_->Next(&tuple)) {
+    auto hash = HashUtil::HashKey(plan_->RightJoinKeyExpression().Evaluate(&tuple, right_child_->GetOutputSchema()));
+    children[PartitionOf(hash, spilled.depth_)].build_file_->Append(tuple);
+  }
+  spilled.build_file_ = nullptr;
+  spilled.probe_file_->Rewind();
+  while (spilled.probe_file_->Next(&tuple)) {
+    auto hash = HashUtil::HashKey(plan_->LeftJoinKeyExpression().Evaluate(&tuple, left_child_->GetOutputSchema()));
+    children[PartitionOf(hash, spilled.depth_)].probe_file_->Append(tuple);
+  }
+  spilled.probe_file_ = nullptr;
+  for (auto &child : children) {
+    spilled_.push_back(std::move(child));
+  }
+}
+
+auto HashJoinExecutor::MakeOutputTuple(const Tuple &probe_tuple, const Tuple *build_tuple) const -> Tuple {
+  const auto &left_schema = left_child_->GetOutputSchema();
+  const auto &right_schema = right_child_->GetOutputSchema();
+  std::vector<Value> values;
+  values.reserve(left_schema.GetColumnCount() + right_schema.GetColumnCount());
+  for (uint32_t i = 0; i < left_schema.GetColumnCount(); i++) {
+    values.push_back(probe_tuple.GetValue(&left_schema, i));
+  }
+  for (uint32_t i = 0; i < right_schema.GetColumnCount(); i++) {
+    if (build_tuple != nullptr) {
+      values.push_back(build_tuple->GetValue(&right_schema, i));
+    } else {
+      values.push_back(ValueFactory::GetNullValueByType(right_schema.GetColumn(i).GetType()));
+    }
+  }
+  return {values, &GetOutputSchema()};
+}
 
 }  // namespace bustub
@@ -11,40 +11,92 @@
 //===----------------------------------------------------------------------===//
 #include "execution/executors/index_scan_executor.h"
 
+#include <cstring>
+#include <vector>
+
 namespace bustub {
+
+namespace {
+
+auto KeyOf(const IndexInfo &index_info, const Value &value) -> IntegerKeyType {
+  IntegerKeyType key;
+  key.SetFromKey(Tuple{std::vector<Value>{value}, index_info.index_->GetKeySchema()});
+  return key;
+}
+
+}  // namespace
+
 IndexScanExecutor::IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanPlanNode *plan)
     : AbstractExecutor(exec_ctx),
       plan_{plan},
       index_info_{this->exec_ctx_->GetCatalog()->GetIndex(plan_->index_oid_)},
       table_info_{this->exec_ctx_->GetCatalog()->GetTable(index_info_->table_name_)},
-      tree_{dynamic_cast<BPlusTreeIndexForOneIntegerColumn *>(index_info_->index_.get())},
-      iter_{tree_->GetBeginIterator()} {
-  //  auto index_info = exec_ctx_->GetCatalog()->GetIndex(plan_->GetIndexOid());
-  //  index_ = dynamic_cast<BPlusTreeIndexForOneIntegerColumn *>(index_info->index_.get());
-  //  iter_ = index_->GetBeginIterator();
-  //  table_info_ = exec_ctx_->GetCatalog()->GetTable(index_info->table_name_);
-}
+      tree_{dynamic_cast<BPlusTreeIndexForOneIntegerColumn *>(index_info_->index_.get())} {}
 
-void IndexScanExecutor::Init() {}
+void IndexScanExecutor::Init() {
+  entries_.clear();
+  entry_cursor_ = 0;
+  last_key_.reset();
+  index_exhausted_ = false;
+}
 
 auto IndexScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-  if (iter_ == tree_->GetEndIterator()) {
-    return false;
+  while (entry_cursor_ < entries_.size() || FetchBatch()) {
+    const auto &[index_key, entry_rid] = entries_[entry_cursor_++];
+    if (plan_->lower_.has_value() || plan_->upper_.has_value()) {
+      // The scan starts at the first key not smaller than the lower bound and stops at the first key past the upper
+      // bound.
+      auto key = index_key.ToValue(index_info_->index_->GetKeySchema(), 0);
+      if (key.IsNull()) {
+        continue;
+      }
+      const auto &lower = plan_->lower_;
+      const auto &upper = plan_->upper_;
+      if (lower.has_value() && !lower->inclusive_ && key.CompareEquals(lower->key_) == CmpBool::CmpTrue) {
+        continue;
+      }
+      if (upper.has_value() && (key.CompareGreaterThan(upper->key_) == CmpBool::CmpTrue ||
+                                (!upper->inclusive_ && key.CompareEquals(upper->key_) == CmpBool::CmpTrue))) {
+        entries_.clear();
+        entry_cursor_ = 0;
+        index_exhausted_ = true;
+        return false;
+      }
+    }
+    *rid = entry_rid;
+    auto result = table_info_->table_->GetTuple(*rid, tuple, exec_ctx_->GetTransaction());
+    if (!result || RuntimeFiltersPass(runtime_filters_, *tuple, GetOutputSchema())) {
+      return result;
+    }
   }
+  return false;
+}
 
-  *rid = (*iter_).second;
-  auto result = table_info_->table_->GetTuple(*rid, tuple, exec_ctx_->GetTransaction());
-  ++iter_;
-
-  return result;
-  //  if (iterator_ != index_->GetEndIterator()) {
-  //    *rid = (*iterator_).second;
-  //    if (table_info_->table_->GetTuple(*rid, tuple, exec_ctx_->GetTransaction())) {
-  //      ++iterator_;
-  //      return true;
-  //    }
-  //  }
-  //  return false;
+auto IndexScanExecutor::FetchBatch() -> bool {
+  entries_.clear();
+  entry_cursor_ = 0;
+  if (index_exhausted_) {
+    return false;
+  }
+  // The iterator holds a latch on its leaf page, it only lives while the batch is copied.
+  auto iter = last_key_.has_value()        ? tree_->GetBeginIterator(*last_key_)
+              : plan_->lower_.has_value() ? tree_->GetBeginIterator(KeyOf(*index_info_, plan_->lower_->key_))
+                                          : tree_->GetBeginIterator();
+  // Keys are unique, and the last key copied may have been removed from the index in the meantime.
+  if (last_key_.has_value() && iter != tree_->GetEndIterator() &&
+      std::memcmp(&(*iter).first, &*last_key_, sizeof(IntegerKeyType)) == 0) {
+    ++iter;
+  }
+  while (entries_.size() < BATCH_SIZE && iter != tree_->GetEndIterator()) {
+    entries_.emplace_back((*iter).first, (*iter).second);
+    ++iter;
+  }
+  index_exhausted_ = entries_.size() < BATCH_SIZE;
+  if (entries_.empty()) {
+    return false;
+  }
+  last_key_ = entries_.back().first;
+  return true;
 }
 
 }  // namespace bustub
@@ -23,7 +23,10 @@ InsertExecutor::InsertExecutor(ExecutorContext *exec_ctx, const InsertPlanNode *
   table_info_ = exec_ctx->GetCatalog()->GetTable(plan_->TableOid());
 }
 
-void InsertExecutor::Init() {}
+void InsertExecutor::Init() {
+  child_->Init();
+  is_success_ = false;
+}
 
 auto InsertExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool {
   if (is_success_) {
@@ -45,6 +48,7 @@ auto InsertExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool {
       }
     }
   }
+  table_info_->stats_.UpdateRowCount(count);
   // return the number of inserted rows
   std::vector<Value> values;
   values.emplace_back(INTEGER, count);
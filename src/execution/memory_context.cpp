@@ -0,0 +1,46 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// memory_context.cpp
+//
+// Identification: src/execution/memory_context.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/memory_context.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+auto MemoryReservation::Resize(size_t bytes) -> bool {
+  if (bytes != bytes_) {
+    context_->Update(bytes_, bytes);
+    bytes_ = bytes;
+    peak_bytes_ = std::max(peak_bytes_, bytes);
+  }
+  return context_->GetUsage() <= context_->GetLimit() && bytes_ <= operator_memory_limit;
+}
+
+auto MemoryReservation::GetBudget() const -> size_t {
+  auto usage = context_->GetUsage();
+  auto others = usage - std::min(usage, bytes_);
+  auto query_budget = context_->GetLimit() - std::min(context_->GetLimit(), others);
+  return std::min<size_t>(query_budget, operator_memory_limit);
+}
+
+void MemoryContext::Update(size_t old_bytes, size_t new_bytes) {
+  if (new_bytes < old_bytes) {
+    usage_ -= old_bytes - new_bytes;
+    return;
+  }
+  auto usage = usage_ += new_bytes - old_bytes;
+  auto peak = peak_usage_.load();
+  while (usage > peak && !peak_usage_.compare_exchange_weak(peak, usage)) {
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,129 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// merge_join_executor.cpp
+//
+// Identification: src/execution/merge_join_executor.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/merge_join_executor.h"
+
+#include "type/value_factory.h"
+
+namespace bustub {
+
+MergeJoinExecutor::MergeJoinExecutor(ExecutorContext *exec_ctx, const MergeJoinPlanNode *plan,
+                                     std::unique_ptr<AbstractExecutor> &&left_child,
+                                     std::unique_ptr<AbstractExecutor> &&right_child)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      left_child_(std::move(left_child)),
+      right_child_(std::move(right_child)) {
+  if (!(plan->GetJoinType() == JoinType::LEFT || plan->GetJoinType() == JoinType::INNER)) {
+    throw bustub::NotImplementedException(fmt::format("join type {} not supported", plan->GetJoinType()));
+  }
+}
+
+void MergeJoinExecutor::Init() {
+  left_child_->Init();
+  right_child_->Init();
+  mark_.clear();
+  mark_key_ = std::nullopt;
+  mark_cursor_ = 0;
+  restoring_ = false;
+  AdvanceLeft();
+  AdvanceRight();
+}
+
+auto MergeJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  while (true) {
+    if (restoring_) {
+      if (mark_cursor_ < mark_.size()) {
+        *tuple = MakeOutputTuple(left_tuple_, &mark_[mark_cursor_++]);
+        return true;
+      }
+      restoring_ = false;
+      AdvanceLeft();
+    }
+    if (!left_key_.has_value()) {
+      return false;
+    }
+
+    const auto &left_key = *left_key_;
+    if (!left_key.IsNull()) {
+      // Left keys never decrease, so a mark with the same key is still valid for this left tuple.
+      if (mark_key_.has_value() && left_key.CompareEquals(*mark_key_) == CmpBool::CmpTrue) {
+        restoring_ = true;
+        mark_cursor_ = 0;
+        continue;
+      }
+      // Skip the right tuples that are too small (or null) to match this or any later left tuple.
+      while (right_key_.has_value() &&
+             (right_key_->IsNull() || right_key_->CompareLessThan(left_key) == CmpBool::CmpTrue)) {
+        AdvanceRight();
+      }
+      if (right_key_.has_value() && right_key_->CompareEquals(left_key) == CmpBool::CmpTrue) {
+        // Mark the run of right tuples with this key.
+        mark_.clear();
+        mark_key_ = *right_key_;
+        while (right_key_.has_value() && right_key_->CompareEquals(*mark_key_) == CmpBool::CmpTrue) {
+          mark_.push_back(right_tuple_);
+          AdvanceRight();
+        }
+        restoring_ = true;
+        mark_cursor_ = 0;
+        continue;
+      }
+    }
+
+    // This left tuple has no match.
+    if (plan_->GetJoinType() == JoinType::LEFT) {
+      *tuple = MakeOutputTuple(left_tuple_, nullptr);
+      AdvanceLeft();
+      return true;
+    }
+    AdvanceLeft();
+  }
+}
+
+void MergeJoinExecutor::AdvanceLeft() {
+  RID rid;
+  if (left_child_->Next(&left_tuple_, &rid)) {
+    left_key_ = plan_->LeftJoinKeyExpression().Evaluate(&left_tuple_, left_child_->GetOutputSchema());
+  } else {
+    left_key_ = std::nullopt;
+  }
+}
+
+void MergeJoinExecutor::AdvanceRight() {
+  RID rid;
+  if (right_child_->Next(&right_tuple_, &rid)) {
+    right_key_ = plan_->RightJoinKeyExpression().Evaluate(&right_tuple_, right_child_->GetOutputSchema());
+  } else {
+    right_key_ = std::nullopt;
+  }
+}
+
+auto MergeJoinExecutor::MakeOutputTuple(const Tuple &left_tuple, const Tuple *right_tuple) const -> Tuple {
+  const auto &left_schema = left_child_->GetOutputSchema();
+  const auto &right_schema = right_child_->GetOutputSchema();
+  std::vector<Value> values;
+  values.reserve(left_schema.GetColumnCount() + right_schema.GetColumnCount());
+  for (uint32_t i = 0; i < left_schema.GetColumnCount(); i++) {
+    values.push_back(left_tuple.GetValue(&left_schema, i));
+  }
+  for (uint32_t i = 0; i < right_schema.GetColumnCount(); i++) {
+    if (right_tuple != nullptr) {
+      values.push_back(right_tuple->GetValue(&right_schema, i));
+    } else {
+      values.push_back(ValueFactory::GetNullValueByType(right_schema.GetColumn(i).GetType()));
+    }
+  }
+  return {values, &GetOutputSchema()};
+}
+
+}  // namespace bustub
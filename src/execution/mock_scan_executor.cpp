@@ -380,9 +380,12 @@ auto GetFunctionOf(const MockScanPlanNode *plan) -> std::function<Tuple(size_t)>
 }
 
 MockScanExecutor::MockScanExecutor(ExecutorContext *exec_ctx, const MockScanPlanNode *plan)
-    : AbstractExecutor{exec_ctx}, plan_{plan}, func_(GetFunctionOf(plan)), size_(GetSizeOf(plan)) {
+    : MockScanExecutor(exec_ctx, plan, Morsel{{}, 0, GetSizeOf(plan)}) {}
+
+MockScanExecutor::MockScanExecutor(ExecutorContext *exec_ctx, const MockScanPlanNode *plan, const Morsel &morsel)
+    : AbstractExecutor{exec_ctx}, plan_{plan}, func_(GetFunctionOf(plan)), begin_(morsel.begin_), size_(morsel.end_) {
   if (GetShuffled(plan)) {
-    for (size_t i = 0; i < size_; i++) {
+    for (size_t i = begin_; i < size_; i++) {
       shuffled_idx_.push_back(i);
     }
     std::random_device rd;
@@ -393,22 +396,24 @@ MockScanExecutor::MockScanExecutor(ExecutorContext *exec_ctx, const MockScanPlan
 
 void MockScanExecutor::Init() {
   // Reset the cursor
-  cursor_ = 0;
+  cursor_ = begin_;
 }
 
 auto MockScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-  if (cursor_ == size_) {
-    // Scan complete
-    return EXECUTOR_EXHAUSTED;
-  }
-  if (shuffled_idx_.empty()) {
-    *tuple = func_(cursor_);
-  } else {
-    *tuple = func_(shuffled_idx_[cursor_]);
-  }
-  ++cursor_;
-  *rid = MakeDummyRID();
-  return EXECUTOR_ACTIVE;
+  while (cursor_ != size_) {
+    if (shuffled_idx_.empty()) {
+      *tuple = func_(cursor_);
+    } else {
+      *tuple = func_(shuffled_idx_[cursor_ - begin_]);
+    }
+    ++cursor_;
+    if (RuntimeFiltersPass(runtime_filters_, *tuple, GetOutputSchema())) {
+      *rid = MakeDummyRID();
+      return EXECUTOR_ACTIVE;
+    }
+  }
+  // Scan complete
+  return EXECUTOR_EXHAUSTED;
 }
 
 auto MockScanExecutor::MakeDummyRID() -> RID { return RID{0}; }
@@ -11,20 +11,149 @@
 //===----------------------------------------------------------------------===//
 
 #include "execution/executors/nested_index_join_executor.h"
+#include "common/exception.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
 NestIndexJoinExecutor::NestIndexJoinExecutor(ExecutorContext *exec_ctx, const NestedIndexJoinPlanNode *plan,
                                              std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_executor_(std::move(child_executor)),
+      index_info_(exec_ctx->GetCatalog()->GetIndex(plan->GetIndexOid())),
+      table_info_(exec_ctx->GetCatalog()->GetTable(plan->GetInnerTableOid())) {
   if (!(plan->GetJoinType() == JoinType::LEFT || plan->GetJoinType() == JoinType::INNER)) {
     // Note for 2022 Fall: You ONLY need to implement left join and inner join.
     throw bustub::NotImplementedException(fmt::format("join type {} not supported", plan->GetJoinType()));
   }
 }
 
-void NestIndexJoinExecutor::Init() { throw NotImplementedException("NestIndexJoinExecutor is not implemented"); }
+NestIndexJoinExecutor::~NestIndexJoinExecutor() {
+  // The probe tasks read the plan and the outer schema, they have to finish before the executor goes away.
+  prefetches_.clear();
+}
+
+void NestIndexJoinExecutor::Init() {
+  prefetches_.clear();
+  child_executor_->Init();
+  batch_ = {};
+  batch_cursor_ = 0;
+  inner_cursor_ = 0;
+  outer_exhausted_ = false;
+  PrefetchBatches();
+}
+
+auto NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  while (true) {
+    if (batch_cursor_ >= batch_.outer_.size()) {
+      if (!TakeBatch()) {
+        return false;
+      }
+      continue;
+    }
+    const auto &outer_tuple = batch_.outer_[batch_cursor_];
+    const auto &inner_tuples = batch_.inner_[batch_cursor_];
+    if (inner_cursor_ < inner_tuples.size()) {
+      *tuple = MakeOutputTuple(outer_tuple, &inner_tuples[inner_cursor_++]);
+      return true;
+    }
+    bool emit_unmatched = inner_tuples.empty() && plan_->GetJoinType() == JoinType::LEFT;
+    batch_cursor_++;
+    inner_cursor_ = 0;
+    if (emit_unmatched) {
+      *tuple = MakeOutputTuple(outer_tuple, nullptr);
+      return true;
+    }
+  }
+}
 
-auto NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+void NestIndexJoinExecutor::PrefetchBatches() {
+  Tuple outer_tuple;
+  RID outer_rid;
+  // The outer side is pulled here, the probe tasks only touch the index and the inner table.
+  while (!outer_exhausted_ && prefetches_.size() < PREFETCH_DEPTH) {
+    auto prefetch = std::make_unique<Prefetch>(exec_ctx_->GetTaskScheduler(), *exec_ctx_->GetTransaction());
+    auto &outer = prefetch->batch_.outer_;
+    while (outer.size() < BATCH_SIZE) {
+      if (!child_executor_->Next(&outer_tuple, &outer_rid)) {
+        outer_exhausted_ = true;
+        break;
+      }
+      outer.push_back(std::move(outer_tuple));
+    }
+    if (outer.empty()) {
+      return;
+    }
+    auto *raw = prefetch.get();
+    prefetches_.push_back(std::move(prefetch));
+    raw->probe_.Run([this, raw] { ProbeBatch(&raw->batch_, &raw->txn_); });
+  }
+}
+
+auto NestIndexJoinExecutor::TakeBatch() -> bool {
+  if (prefetches_.empty()) {
+    return false;
+  }
+  auto prefetch = std::move(prefetches_.front());
+  prefetches_.pop_front();
+  prefetch->probe_.Wait();
+  if (prefetch->txn_.GetState() == TransactionState::ABORTED) {
+    exec_ctx_->GetTransaction()->SetState(TransactionState::ABORTED);
+  }
+  batch_ = std::move(prefetch->batch_);
+  batch_cursor_ = 0;
+  inner_cursor_ = 0;
+  PrefetchBatches();
+  return true;
+}
+
+void NestIndexJoinExecutor::ProbeBatch(Batch *batch, Transaction *txn) const {
+  // Null keys never match, so they are left out of the probe.
+  const auto &key_schema = *index_info_->index_->GetKeySchema();
+  std::vector<Tuple> keys;
+  std::vector<size_t> key_owner;
+  keys.reserve(batch->outer_.size());
+  key_owner.reserve(batch->outer_.size());
+  for (size_t i = 0; i < batch->outer_.size(); i++) {
+    auto key = plan_->KeyPredicate()->Evaluate(&batch->outer_[i], child_executor_->GetOutputSchema());
+    if (key.IsNull()) {
+      continue;
+    }
+    keys.emplace_back(std::vector<Value>{std::move(key)}, &key_schema);
+    key_owner.push_back(i);
+  }
+  std::vector<std::vector<RID>> key_rids;
+  index_info_->index_->ScanKeys(keys, &key_rids, txn);
+
+  batch->inner_.assign(batch->outer_.size(), {});
+  for (size_t i = 0; i < key_owner.size(); i++) {
+    auto &inner_tuples = batch->inner_[key_owner[i]];
+    for (const auto &inner_rid : key_rids[i]) {
+      Tuple inner_tuple;
+      if (table_info_->table_->GetTuple(inner_rid, &inner_tuple, txn)) {
+        inner_tuples.push_back(std::move(inner_tuple));
+      }
+    }
+  }
+}
+
+auto NestIndexJoinExecutor::MakeOutputTuple(const Tuple &outer_tuple, const Tuple *inner_tuple) const -> Tuple {
+  const auto &outer_schema = child_executor_->GetOutputSchema();
+  const auto &inner_schema = plan_->InnerTableSchema();
+  std::vector<Value> values;
+  values.reserve(outer_schema.GetColumnCount() + inner_schema.GetColumnCount());
+  for (uint32_t i = 0; i < outer_schema.GetColumnCount(); i++) {
+    values.push_back(outer_tuple.GetValue(&outer_schema, i));
+  }
+  for (uint32_t i = 0; i < inner_schema.GetColumnCount(); i++) {
+    if (inner_tuple != nullptr) {
+      values.push_back(inner_tuple->GetValue(&inner_schema, i));
+    } else {
+      values.push_back(ValueFactory::GetNullValueByType(inner_schema.GetColumn(i).GetType()));
+    }
+  }
+  return {values, &GetOutputSchema()};
+}
 
 }  // namespace bustub
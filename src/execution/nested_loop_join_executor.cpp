@@ -13,21 +13,120 @@
 #include "execution/executors/nested_loop_join_executor.h"
 #include "binder/table_ref/bound_join_ref.h"
 #include "common/exception.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
 NestedLoopJoinExecutor::NestedLoopJoinExecutor(ExecutorContext *exec_ctx, const NestedLoopJoinPlanNode *plan,
                                                std::unique_ptr<AbstractExecutor> &&left_executor,
                                                std::unique_ptr<AbstractExecutor> &&right_executor)
-    : AbstractExecutor(exec_ctx) {
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      left_executor_(std::move(left_executor)),
+      right_executor_(std::move(right_executor)),
+      memory_(exec_ctx->GetMemoryContext()->MakeReservation()) {
   if (!(plan->GetJoinType() == JoinType::LEFT || plan->GetJoinType() == JoinType::INNER)) {
     // Note for 2022 Fall: You ONLY need to implement left join and inner join.
     throw bustub::NotImplementedException(fmt::format("join type {} not supported", plan->GetJoinType()));
   }
 }
 
-void NestedLoopJoinExecutor::Init() { throw NotImplementedException("NestedLoopJoinExecutor is not implemented"); }
+void NestedLoopJoinExecutor::Init() {
+  left_executor_->Init();
+  left_exhausted_ = false;
+  has_pending_tuple_ = false;
+  LoadBlock();
+}
+
+auto NestedLoopJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  const auto &left_schema = left_executor_->GetOutputSchema();
+  const auto &right_schema = right_executor_->GetOutputSchema();
+  while (!block_.empty()) {
+    if (has_right_tuple_) {
+      while (block_cursor_ < block_.size()) {
+        auto idx = block_cursor_++;
+        auto value = plan_->Predicate().EvaluateJoin(&block_[idx], left_schema, &right_tuple_, right_schema);
+        if (!value.IsNull() && value.GetAs<bool>()) {
+          block_matched_[idx] = true;
+          *tuple = MakeOutputTuple(block_[idx], &right_tuple_);
+          return true;
+        }
+      }
+      has_right_tuple_ = false;
+    }
 
-auto NestedLoopJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+    RID right_rid;
+    if (right_executor_->Next(&right_tuple_, &right_rid)) {
+      has_right_tuple_ = true;
+      block_cursor_ = 0;
+      continue;
+    }
+
+    // The right side is exhausted for this block.
+    if (plan_->GetJoinType() == JoinType::LEFT) {
+      while (unmatched_cursor_ < block_.size()) {
+        auto idx = unmatched_cursor_++;
+        if (!block_matched_[idx]) {
+          *tuple = MakeOutputTuple(block_[idx], nullptr);
+          return true;
+        }
+      }
+    }
+    LoadBlock();
+  }
+  return false;
+}
+
+auto NestedLoopJoinExecutor::LoadBlock() -> bool {
+  block_.clear();
+  has_right_tuple_ = false;
+  block_cursor_ = 0;
+  unmatched_cursor_ = 0;
+  size_t block_memory = 0;
+  memory_->Resize(0);
+  RID rid;
+  while (has_pending_tuple_ || !left_exhausted_) {
+    if (!has_pending_tuple_) {
+      if (!left_executor_->Next(&pending_tuple_, &rid)) {
+        left_exhausted_ = true;
+        break;
+      }
+      has_pending_tuple_ = true;
+    }
+    auto tuple_memory = sizeof(Tuple) + pending_tuple_.GetLength();
+    // Always take at least one tuple, so that the join makes progress under any budget.
+    if (!block_.empty() && block_memory + tuple_memory > memory_->GetBudget()) {
+      break;
+    }
+    block_memory += tuple_memory;
+    memory_->Resize(block_memory);
+    block_.push_back(std::move(pending_tuple_));
+    has_pending_tuple_ = false;
+  }
+  block_matched_.assign(block_.size(), false);
+  if (block_.empty()) {
+    return false;
+  }
+  right_executor_->Init();
+  return true;
+}
+
+auto NestedLoopJoinExecutor::MakeOutputTuple(const Tuple &left_tuple, const Tuple *right_tuple) const -> Tuple {
+  const auto &left_schema = left_executor_->GetOutputSchema();
+  const auto &right_schema = right_executor_->GetOutputSchema();
+  std::vector<Value> values;
+  values.reserve(left_schema.GetColumnCount() + right_schema.GetColumnCount());
+  for (uint32_t i = 0; i < left_schema.GetColumnCount(); i++) {
+    values.push_back(left_tuple.GetValue(&left_schema, i));
+  }
+  for (uint32_t i = 0; i < right_schema.GetColumnCount(); i++) {
+    if (right_tuple != nullptr) {
+      values.push_back(right_tuple->GetValue(&right_schema, i));
+    } else {
+      values.push_back(ValueFactory::GetNullValueByType(right_schema.GetColumn(i).GetType()));
+    }
+  }
+  return {values, &GetOutputSchema()};
+}
 
 }  // namespace bustub
@@ -0,0 +1,168 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_aggregation_executor.cpp
+//
+// Identification: src/execution/parallel_aggregation_executor.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/parallel_aggregation_executor.h"
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+namespace bustub {
+
+ParallelAggregationExecutor::ParallelAggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      pipeline_(exec_ctx, plan->GetChildPlan()),
+      memory_(exec_ctx->GetMemoryContext()->MakeReservation()) {}
+
+void ParallelAggregationExecutor::Init() {
+  morsels_ = pipeline_.MakeMorsels();
+  next_morsel_ = 0;
+  partitions_.clear();
+  partition_cursor_ = 0;
+  group_cursor_ = 0;
+
+  auto num_tasks = std::max<size_t>(1, std::min(GetExecutorContext()->GetParallelism(), morsels_.size()));
+  locals_ = std::vector<LocalState>(num_tasks);
+  for (auto &local : locals_) {
+    local.tables_.reserve(NUM_PARTITIONS);
+    for (size_t i = 0; i < NUM_PARTITIONS; i++) {
+      local.tables_.push_back(MakeTable());
+    }
+    local.spill_files_.resize(NUM_PARTITIONS);
+    local.memory_usage_ = std::accumulate(local.tables_.begin(), local.tables_.end(), size_t{0},
+                                          [](size_t sum, const auto &table) { return sum + table.GetMemoryUsage(); });
+    local.memory_ = GetExecutorContext()->GetMemoryContext()->MakeReservation();
+    local.memory_->Resize(local.memory_usage_);
+  }
+
+  {
+    TaskGroup tasks(GetExecutorContext()->GetTaskScheduler());
+    auto memory_limit = memory_->GetBudget() / num_tasks;
+    for (auto &local : locals_) {
+      tasks.Run([this, &local, memory_limit] { PreAggregate(&local, memory_limit); });
+    }
+    tasks.Wait();
+  }
+
+  // The partials move into the final tables, a merged table takes no more memory than its partials did.
+  const auto *schema = &pipeline_.GetPlan()->OutputSchema();
+  std::vector<size_t> partial_usage(NUM_PARTITIONS, 0);
+  for (auto &local : locals_) {
+    for (size_t i = 0; i < NUM_PARTITIONS; i++) {
+      partial_usage[i] += local.tables_[i].GetMemoryUsage();
+    }
+    local.memory_->Resize(0);
+  }
+  auto memory_limit = memory_->GetBudget() / NUM_PARTITIONS;
+  partitions_.reserve(NUM_PARTITIONS);
+  for (size_t i = 0; i < NUM_PARTITIONS; i++) {
+    partitions_.emplace_back(GetExecutorContext(), plan_, schema, memory_limit);
+    partitions_.back().Reserve(partial_usage[i]);
+  }
+  {
+    TaskGroup tasks(GetExecutorContext()->GetTaskScheduler());
+    for (size_t i = 0; i < NUM_PARTITIONS; i++) {
+      tasks.Run([this, i] { Finalize(i); });
+    }
+    tasks.Wait();
+  }
+  locals_.clear();
+
+  auto empty = std::all_of(partitions_.begin(), partitions_.end(), [](auto &partition) {
+    return partition.GetTable().Size() == 0 && !partition.HasSpilled();
+  });
+  if (plan_->GetGroupBys().empty() && empty) {
+    // An aggregation without group-bys produces one row even if the input is empty.
+    partitions_[0].GetTable().InsertEmptyGroup();
+  }
+}
+
+auto ParallelAggregationExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  while (partition_cursor_ < partitions_.size()) {
+    auto &partition = partitions_[partition_cursor_];
+    if (group_cursor_ < partition.GetTable().Size()) {
+      *tuple = Tuple{partition.GetTable().GetGroupValues(group_cursor_++), &GetOutputSchema()};
+      *rid = RID{};
+      return true;
+    }
+    group_cursor_ = 0;
+    if (!partition.AggregateNextSpilled()) {
+      partition.Clear();
+      partition_cursor_++;
+    }
+  }
+  return false;
+}
+
+void ParallelAggregationExecutor::PreAggregate(LocalState *local, size_t memory_limit) {
+  const auto &schema = pipeline_.GetPlan()->OutputSchema();
+  Tuple tuple;
+  RID rid;
+  AggregationHashTable::GroupKey key;
+  for (auto morsel_idx = next_morsel_++; morsel_idx < morsels_.size(); morsel_idx = next_morsel_++) {
+    auto executor = pipeline_.MakeExecutor(morsels_[morsel_idx]);
+    executor->Init();
+    while (executor->Next(&tuple, &rid)) {
+      local->tables_[0].EncodeKey(tuple, schema, &key);
+      auto partition = PartitionOf(key.hash_);
+      auto &table = local->tables_[partition];
+      auto memory_before = table.GetMemoryUsage();
+      auto within_budget = local->memory_->Resize(local->memory_usage_) && local->memory_usage_ <= memory_limit;
+      auto *group = table.FindGroup(key, within_budget);
+      if (group != nullptr) {
+        table.Update(group, tuple, schema);
+        local->memory_usage_ += table.GetMemoryUsage() - memory_before;
+        continue;
+      }
+      auto &spill_file = local->spill_files_[partition];
+      if (spill_file == nullptr) {
+        spill_file = std::make_unique<SpillFile>(GetExecutorContext()->GetBufferPoolManager());
+      }
+      spill_file->Append(tuple);
+    }
+  }
+}
+
+void ParallelAggregationExecutor::Finalize(size_t partition) {
+  // The table has reserved what its partials held, the merge can only make it smaller.
+  auto &aggregation = partitions_[partition];
+  for (auto &local : locals_) {
+    aggregation.GetTable().MergeFrom(local.tables_[partition]);
+    local.tables_[partition].Clear();
+  }
+  aggregation.Reserve(aggregation.GetTable().GetMemoryUsage());
+
+  // Tuples that did not fit into the partials of their task. Their groups are aggregated within the share of the
+  // budget of this partition, the rest is spilled again and aggregated while the partition is emitted.
+  size_t file_idx = 0;
+  std::vector<SpillFile *> spill_files;
+  for (auto &local : locals_) {
+    if (local.spill_files_[partition] != nullptr) {
+      local.spill_files_[partition]->Rewind();
+      spill_files.push_back(local.spill_files_[partition].get());
+    }
+  }
+  aggregation.Aggregate([&](Tuple *tuple) {
+    for (; file_idx < spill_files.size(); file_idx++) {
+      if (spill_files[file_idx]->Next(tuple)) {
+        return true;
+      }
+    }
+    return false;
+  });
+  for (auto &local : locals_) {
+    local.spill_files_[partition] = nullptr;
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,99 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_topn_executor.cpp
+//
+// Identification: src/execution/parallel_topn_executor.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/parallel_topn_executor.h"
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+namespace bustub {
+
+ParallelTopNExecutor::ParallelTopNExecutor(ExecutorContext *exec_ctx, const TopNPlanNode *plan)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      pipeline_(exec_ctx, plan->GetChildPlan()),
+      memory_(exec_ctx->GetMemoryContext()->MakeReservation()) {}
+
+void ParallelTopNExecutor::Init() {
+  morsels_ = pipeline_.MakeMorsels();
+  next_morsel_ = 0;
+  bound_.clear();
+  bound_version_ = 0;
+  entries_.clear();
+  cursor_ = 0;
+
+  auto num_tasks = std::max<size_t>(1, std::min(GetExecutorContext()->GetParallelism(), morsels_.size()));
+  std::vector<TopNHeap> locals(num_tasks, TopNHeap(plan_->GetOrderBy(), plan_->GetN()));
+  {
+    TaskGroup tasks(GetExecutorContext()->GetTaskScheduler());
+    for (auto &local : locals) {
+      tasks.Run([this, &local] { Collect(&local); });
+    }
+    tasks.Wait();
+  }
+  // Every local heap holds at most n tuples, which cannot spill.
+  memory_->Resize(std::accumulate(locals.begin(), locals.end(), size_t{0},
+                                  [](size_t sum, const TopNHeap &local) { return sum + local.GetMemoryUsage(); }));
+
+  for (size_t i = 1; i < locals.size(); i++) {
+    locals[0].MergeFrom(std::move(locals[i]));
+  }
+  entries_ = locals[0].Finish();
+  memory_->Resize(entries_.capacity() * sizeof(TopNHeap::Entry));
+}
+
+auto ParallelTopNExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  if (cursor_ >= entries_.size()) {
+    return false;
+  }
+  auto &entry = entries_[cursor_++];
+  *rid = entry.tuple_.GetRid();
+  *tuple = std::move(entry.tuple_);
+  return true;
+}
+
+void ParallelTopNExecutor::Collect(TopNHeap *local) {
+  const auto &schema = pipeline_.GetPlan()->OutputSchema();
+  // A task-local copy of the shared bound, refreshed when its version changes.
+  std::vector<Value> bound;
+  size_t bound_version = 0;
+  Tuple tuple;
+  RID rid;
+  for (auto morsel_idx = next_morsel_++; morsel_idx < morsels_.size(); morsel_idx = next_morsel_++) {
+    auto executor = pipeline_.MakeExecutor(morsels_[morsel_idx]);
+    executor->Init();
+    while (executor->Next(&tuple, &rid)) {
+      if (bound_version_.load() != bound_version) {
+        std::scoped_lock lock(bound_mutex_);
+        bound = bound_;
+        bound_version = bound_version_.load();
+      }
+      auto keys = local->MakeKeys(tuple, schema);
+      if (!bound.empty() && !local->KeysLess(keys, bound)) {
+        continue;
+      }
+      if (!local->Push(std::move(keys), std::move(tuple)) || !local->IsFull()) {
+        continue;
+      }
+      std::scoped_lock lock(bound_mutex_);
+      if (bound_.empty() || local->KeysLess(local->Top(), bound_)) {
+        bound_ = local->Top();
+        bound_version_++;
+      }
+      bound = bound_;
+      bound_version = bound_version_.load();
+    }
+  }
+}
+
+}  // namespace bustub
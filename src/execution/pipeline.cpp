@@ -0,0 +1,100 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pipeline.cpp
+//
+// Identification: src/execution/pipeline.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/pipeline.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "execution/executors/filter_executor.h"
+#include "execution/executors/mock_scan_executor.h"
+#include "execution/executors/projection_executor.h"
+#include "execution/executors/seq_scan_executor.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/mock_scan_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+
+namespace bustub {
+
+Pipeline::Pipeline(ExecutorContext *exec_ctx, AbstractPlanNodeRef plan) : exec_ctx_(exec_ctx), plan_(std::move(plan)) {
+  BUSTUB_ASSERT(IsParallelizable(*plan_), "pipeline must be a chain of filters and projections over a scan");
+  source_ = plan_.get();
+  while (!source_->GetChildren().empty()) {
+    source_ = source_->GetChildAt(0).get();
+  }
+}
+
+auto Pipeline::IsParallelizable(const AbstractPlanNode &plan) -> bool {
+  switch (plan.GetType()) {
+    case PlanType::SeqScan:
+    case PlanType::MockScan:
+      return true;
+    case PlanType::Filter:
+    case PlanType::Projection:
+      return IsParallelizable(*plan.GetChildAt(0));
+    default:
+      return false;
+  }
+}
+
+auto Pipeline::ShouldRunParallel(ExecutorContext *exec_ctx, const AbstractPlanNode &plan) -> bool {
+  return exec_ctx->GetTaskScheduler() != nullptr && exec_ctx->GetParallelism() > 1 && IsParallelizable(plan);
+}
+
+auto Pipeline::MakeMorsels() const -> std::vector<Morsel> {
+  std::vector<Morsel> morsels;
+  if (source_->GetType() == PlanType::MockScan) {
+    auto size = GetSizeOf(dynamic_cast<const MockScanPlanNode *>(source_));
+    for (size_t begin = 0; begin < size; begin += MORSEL_SIZE_IN_TUPLES) {
+      morsels.push_back(Morsel{{}, begin, std::min(begin + MORSEL_SIZE_IN_TUPLES, size)});
+    }
+    return morsels;
+  }
+
+  const auto *scan_plan = dynamic_cast<const SeqScanPlanNode *>(source_);
+  auto *table_info = exec_ctx_->GetCatalog()->GetTable(scan_plan->GetTableOid());
+  auto page_ids = table_info->table_->GetPageIds(exec_ctx_->GetTransaction());
+  for (size_t begin = 0; begin < page_ids.size(); begin += MORSEL_SIZE_IN_PAGES) {
+    auto end = std::min(begin + MORSEL_SIZE_IN_PAGES, page_ids.size());
+    morsels.push_back(Morsel{{page_ids.begin() + begin, page_ids.begin() + end}, 0, 0});
+  }
+  return morsels;
+}
+
+auto Pipeline::MakeExecutor(const Morsel &morsel) const -> std::unique_ptr<AbstractExecutor> {
+  return MakeExecutor(plan_, morsel);
+}
+
+auto Pipeline::MakeExecutor(const AbstractPlanNodeRef &plan, const Morsel &morsel) const
+    -> std::unique_ptr<AbstractExecutor> {
+  switch (plan->GetType()) {
+    case PlanType::SeqScan:
+      return std::make_unique<SeqScanExecutor>(exec_ctx_, dynamic_cast<const SeqScanPlanNode *>(plan.get()), morsel);
+    case PlanType::MockScan:
+      return std::make_unique<MockScanExecutor>(exec_ctx_, dynamic_cast<const MockScanPlanNode *>(plan.get()), morsel);
+    case PlanType::Filter: {
+      const auto *filter_plan = dynamic_cast<const FilterPlanNode *>(plan.get());
+      auto child = MakeExecutor(filter_plan->GetChildPlan(), morsel);
+      return std::make_unique<FilterExecutor>(exec_ctx_, filter_plan, std::move(child));
+    }
+    case PlanType::Projection: {
+      const auto *projection_plan = dynamic_cast<const ProjectionPlanNode *>(plan.get());
+      auto child = MakeExecutor(projection_plan->GetChildPlan(), morsel);
+      return std::make_unique<ProjectionExecutor>(exec_ctx_, projection_plan, std::move(child));
+    }
+    default:
+      UNREACHABLE("Unsupported plan type in pipeline.");
+  }
+}
+
+}  // namespace bustub
@@ -74,9 +74,22 @@ auto AggregationPlanNode::InferAggSchema(const std::vector<AbstractExpressionRef
   }
   for (size_t idx = 0; idx < aggregates.size(); idx++) {
     // TODO(chi): correctly infer agg call return type
-    output.emplace_back(Column("<unnamed>", TypeId::INTEGER));
+    auto type = InferAggType(agg_types[idx], aggregates[idx]);
+    if (type == TypeId::VARCHAR) {
+      output.emplace_back(Column("<unnamed>", type, VARCHAR_DEFAULT_LENGTH));
+    } else {
+      output.emplace_back(Column("<unnamed>", type));
+    }
   }
   return Schema(output);
 }
 
+auto AggregationPlanNode::InferAggType(AggregationType agg_type, const AbstractExpressionRef &aggregate) -> TypeId {
+  if ((agg_type == AggregationType::MinAggregate || agg_type == AggregationType::MaxAggregate) &&
+      aggregate->GetReturnType() == TypeId::VARCHAR) {
+    return TypeId::VARCHAR;
+  }
+  return TypeId::INTEGER;
+}
+
 }  // namespace bustub
@@ -0,0 +1,70 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// profiling_executor.cpp
+//
+// Identification: src/execution/profiling_executor.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/profiling_executor.h"
+
+#include <chrono>  // NOLINT
+
+#include "common/io_counters.h"
+#include "common/macros.h"
+#include "fmt/format.h"
+
+namespace bustub {
+
+namespace {
+
+/** Adds the time and page traffic between its construction and destruction to a profile */
+class ProfileScope {
+ public:
+  ProfileScope(ExecutorProfile *profile, uint64_t *ns)
+      : profile_(profile), ns_(ns), start_(std::chrono::steady_clock::now()), start_io_(thread_io_counters) {}
+
+  ~ProfileScope() {
+    const auto &io = thread_io_counters;
+    *ns_ += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count();
+    profile_->pages_fetched_ += io.pages_fetched_ - start_io_.pages_fetched_;
+    profile_->pages_missed_ += io.pages_missed_ - start_io_.pages_missed_;
+    profile_->bytes_spilled_ += io.bytes_spilled_ - start_io_.bytes_spilled_;
+  }
+
+  DISALLOW_COPY_AND_MOVE(ProfileScope);
+
+ private:
+  ExecutorProfile *profile_;
+  uint64_t *ns_;
+  std::chrono::steady_clock::time_point start_;
+  IoCounters start_io_;
+};
+
+}  // namespace
+
+auto ExecutorProfile::ToString() const -> std::string {
+  return fmt::format("(rows={}, init={:.3f}ms, next={:.3f}ms, pages={}, misses={}, spilled={})", rows_,
+                     static_cast<double>(init_ns_) / 1e6, static_cast<double>(next_ns_) / 1e6, pages_fetched_,
+                     pages_missed_, bytes_spilled_);
+}
+
+void ProfilingExecutor::Init() {
+  ProfileScope scope(profile_, &profile_->init_ns_);
+  executor_->Init();
+}
+
+auto ProfilingExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  ProfileScope scope(profile_, &profile_->next_ns_);
+  if (!executor_->Next(tuple, rid)) {
+    return false;
+  }
+  profile_->rows_++;
+  return true;
+}
+
+}  // namespace bustub
@@ -0,0 +1,87 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// runtime_filter.cpp
+//
+// Identification: src/execution/runtime_filter.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/runtime_filter.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+void RuntimeFilter::Clear(size_t memory_limit) {
+  memory_limit_ = memory_limit;
+  hashes_ = {};
+  words_ = {};
+  min_ = std::nullopt;
+  max_ = std::nullopt;
+  built_ = false;
+}
+
+void RuntimeFilter::Insert(const Value &key) {
+  auto hash = HashUtil::HashKey(key);
+  if (words_.empty() && hashes_.size() == hashes_.capacity() &&
+      std::max<size_t>(1, hashes_.capacity() * 2) * sizeof(hash_t) > memory_limit_ / 2) {
+    // Growing the buffer would take more than its half of the limit, the filter gets as large as it may.
+    AllocateWords(MAX_WORDS);
+  }
+  if (words_.empty()) {
+    hashes_.push_back(hash);
+  } else {
+    words_[hash & (words_.size() - 1)] |= MaskOf(hash);
+  }
+  if (!min_.has_value() || key.CompareLessThan(*min_) == CmpBool::CmpTrue) {
+    min_ = key;
+  }
+  if (!max_.has_value() || key.CompareGreaterThan(*max_) == CmpBool::CmpTrue) {
+    max_ = key;
+  }
+}
+
+void RuntimeFilter::Build() {
+  if (words_.empty()) {
+    // About 16 bits per key, which keeps the false positive rate below one percent.
+    AllocateWords((hashes_.size() + 3) / 4);
+  }
+  built_ = true;
+}
+
+void RuntimeFilter::AllocateWords(size_t num_words) {
+  // The number of words is a power of two, so that the word of a key is picked by masking its hash. The filter takes
+  // at most half of the limit, the buffered hashes being folded into it take the other half.
+  auto max_words = std::min(MAX_WORDS, memory_limit_ / 2 / sizeof(uint64_t));
+  size_t words = 1;
+  while (words * 2 <= max_words && words < num_words) {
+    words *= 2;
+  }
+  words_.assign(words, 0);
+  for (auto hash : hashes_) {
+    words_[hash & (words - 1)] |= MaskOf(hash);
+  }
+  hashes_ = {};
+}
+
+auto RuntimeFilter::MayContain(const Tuple &tuple, const Schema &schema) const -> bool {
+  if (!built_) {
+    return true;
+  }
+  auto key = key_expr_->Evaluate(&tuple, schema);
+  if (key.IsNull() || !min_.has_value()) {
+    return false;
+  }
+  if (key.CompareLessThan(*min_) == CmpBool::CmpTrue || key.CompareGreaterThan(*max_) == CmpBool::CmpTrue) {
+    return false;
+  }
+  auto hash = HashUtil::HashKey(key);
+  auto mask = MaskOf(hash);
+  return (words_[hash & (words_.size() - 1)] & mask) == mask;
+}
+
+}  // namespace bustub
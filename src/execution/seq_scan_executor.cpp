@@ -17,24 +17,59 @@ namespace bustub {
 SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan)
     : AbstractExecutor(exec_ctx), plan_(plan) {
   table_info_ = exec_ctx->GetCatalog()->GetTable(plan_->GetTableOid());
-  table_iterator_ = table_info_->table_->Begin(exec_ctx->GetTransaction());
 }
 
-/**
- * Initialize the sequential scan
- * Already initialized in constructor
- * So do nothing here
- */
-void SeqScanExecutor::Init() {}
+SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan, Morsel morsel)
+    : AbstractExecutor(exec_ctx), plan_(plan), morsel_(std::move(morsel)) {
+  table_info_ = exec_ctx->GetCatalog()->GetTable(plan_->GetTableOid());
+}
+
+void SeqScanExecutor::Init() {
+  next_page_id_ = table_info_->table_->GetFirstPageId();
+  next_morsel_page_ = 0;
+  page_tuples_.clear();
+  page_cursor_ = 0;
+}
 
 auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-  if (table_iterator_ != table_info_->table_->End()) {
-    *tuple = *table_iterator_;
-    *rid = table_iterator_->GetRid();
-    ++table_iterator_;
+  while (true) {
+    while (page_cursor_ < page_tuples_.size()) {
+      auto &[page_tuple, page_rid] = page_tuples_[page_cursor_++];
+      if (plan_->filter_predicate_ != nullptr) {
+        auto value = plan_->filter_predicate_->Evaluate(&page_tuple, GetOutputSchema());
+        if (value.IsNull() || !value.GetAs<bool>()) {
+          continue;
+        }
+      }
+      if (!RuntimeFiltersPass(runtime_filters_, page_tuple, GetOutputSchema())) {
+        continue;
+      }
+      *tuple = std::move(page_tuple);
+      *rid = page_rid;
+      return true;
+    }
+    if (!FetchNextPage()) {
+      return false;
+    }
+  }
+}
+
+auto SeqScanExecutor::FetchNextPage() -> bool {
+  page_tuples_.clear();
+  page_cursor_ = 0;
+  auto *txn = GetExecutorContext()->GetTransaction();
+  if (morsel_.has_value()) {
+    if (next_morsel_page_ == morsel_->page_ids_.size()) {
+      return false;
+    }
+    table_info_->table_->GetPageTuples(morsel_->page_ids_[next_morsel_page_++], &page_tuples_, txn);
     return true;
   }
-  return false;
+  if (next_page_id_ == INVALID_PAGE_ID) {
+    return false;
+  }
+  next_page_id_ = table_info_->table_->GetPageTuples(next_page_id_, &page_tuples_, txn);
+  return true;
 }
 
 }  // namespace bustub
@@ -1,13 +1,315 @@
 #include "execution/executors/sort_executor.h"
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <utility>
+
 namespace bustub {
 
+namespace {
+
+constexpr uint64_t SIGN_BIT = uint64_t{1} << 63;
+
+/**
+ * @return the key encoded into an integer ordering like the key in ascending order, nulls first. Numbers are encoded
+ * exactly, with the sign bit flipped so that negative numbers come first. Strings are encoded by their first eight
+ * bytes, so equal prefixes only mean equal strings for short strings.
+ */
+auto NormalizeKey(const Value &key) -> uint64_t {
+  if (key.IsNull()) {
+    return 0;
+  }
+  switch (key.GetTypeId()) {
+    case TypeId::BOOLEAN:
+      return static_cast<uint64_t>(key.GetAs<int8_t>()) + 1;
+    case TypeId::TINYINT:
+      return static_cast<uint64_t>(int64_t{key.GetAs<int8_t>()}) ^ SIGN_BIT;
+    case TypeId::SMALLINT:
+      return static_cast<uint64_t>(int64_t{key.GetAs<int16_t>()}) ^ SIGN_BIT;
+    case TypeId::INTEGER:
+      return static_cast<uint64_t>(int64_t{key.GetAs<int32_t>()}) ^ SIGN_BIT;
+    case TypeId::BIGINT:
+      // The smallest value is the null value, so no value is encoded as 0.
+      return static_cast<uint64_t>(key.GetAs<int64_t>()) ^ SIGN_BIT;
+    case TypeId::TIMESTAMP:
+      return key.GetAs<uint64_t>() + 1;
+    case TypeId::DECIMAL: {
+      // Negative numbers have all bits flipped, since a larger magnitude must come first. -0 is equal to 0.
+      auto value = key.GetAs<double>();
+      if (value == 0) {
+        value = 0;
+      }
+      uint64_t bits;
+      std::memcpy(&bits, &value, sizeof(bits));
+      return std::max<uint64_t>((bits & SIGN_BIT) != 0 ? ~bits : bits | SIGN_BIT, 1);
+    }
+    case TypeId::VARCHAR: {
+      // Bytes past the end compare as 0, which sorts a string before every longer string starting with it.
+      uint64_t prefix = 0;
+      auto len = std::min<size_t>(key.GetLength() - 1, sizeof(prefix));
+      for (size_t i = 0; i < len; i++) {
+        prefix |= static_cast<uint64_t>(static_cast<uint8_t>(key.GetData()[i])) << (8 * (sizeof(prefix) - 1 - i));
+      }
+      return prefix;
+    }
+    default:
+      return 0;
+  }
+}
+
+/** @return whether keys of a type are equal if their encodings are */
+auto IsNormalizedExactly(TypeId type) -> bool {
+  switch (type) {
+    case TypeId::BOOLEAN:
+    case TypeId::TINYINT:
+    case TypeId::SMALLINT:
+    case TypeId::INTEGER:
+    case TypeId::BIGINT:
+    case TypeId::TIMESTAMP:
+    case TypeId::DECIMAL:
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
 SortExecutor::SortExecutor(ExecutorContext *exec_ctx, const SortPlanNode *plan,
                            std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_executor_(std::move(child_executor)),
+      prefix_exact_(!plan->GetOrderBy().empty() && IsNormalizedExactly(plan->GetOrderBy()[0].second->GetReturnType())),
+      memory_(exec_ctx->GetMemoryContext()->MakeReservation()) {}
+
+void SortExecutor::Init() {
+  child_executor_->Init();
+  buffer_.clear();
+  buffer_memory_ = 0;
+  memory_->Resize(0);
+  spilled_runs_.clear();
+  merge_runs_.clear();
+  merge_tree_ = nullptr;
+
+  Tuple tuple;
+  RID rid;
+  while (child_executor_->Next(&tuple, &rid)) {
+    auto entry = MakeEntry(std::move(tuple));
+    buffer_memory_ += sizeof(SortEntry) + sizeof(SortKey) + entry.tuple_.GetLength();
+    for (const auto &key : entry.keys_) {
+      buffer_memory_ += sizeof(Value) + (key.GetTypeId() == TypeId::VARCHAR && !key.IsNull() ? key.GetLength() : 0);
+    }
+    buffer_.push_back(std::move(entry));
+    if (!memory_->Resize(buffer_memory_)) {
+      SpillBuffer();
+    }
+  }
+
+  // Every merge input holds one page of its run in memory, so the budget bounds how many runs are merged at once.
+  auto fan_in = std::clamp<size_t>(memory_->GetBudget() / BUSTUB_PAGE_SIZE, 2, MAX_MERGE_FAN_IN);
+  size_t next_run = 0;
+  while (spilled_runs_.size() - next_run > fan_in) {
+    std::vector<Run> runs(fan_in);
+    for (auto &run : runs) {
+      run.file_ = std::move(spilled_runs_[next_run++]);
+    }
+    StartMerge(std::move(runs));
+    auto merged = std::make_unique<SpillFile>(exec_ctx_->GetBufferPoolManager());
+    SortEntry entry;
+    while (NextMerged(&entry)) {
+      merged->Append(entry.tuple_);
+    }
+    merge_runs_.clear();
+    spilled_runs_.push_back(std::move(merged));
+  }
+
+  SortBuffer();
+  std::vector<Run> runs(spilled_runs_.size() - next_run + 1);
+  for (size_t i = 0; i + 1 < runs.size(); i++) {
+    runs[i].file_ = std::move(spilled_runs_[next_run + i]);
+  }
+  runs.back().entries_ = std::move(buffer_);
+  buffer_.clear();
+  buffer_memory_ = 0;
+  spilled_runs_.clear();
+  StartMerge(std::move(runs));
+}
+
+auto SortExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  SortEntry entry;
+  if (!NextMerged(&entry)) {
+    return false;
+  }
+  *rid = entry.tuple_.GetRid();
+  *tuple = std::move(entry.tuple_);
+  return true;
+}
+
+auto SortExecutor::MakeEntry(Tuple tuple) const -> SortEntry {
+  SortEntry entry;
+  entry.keys_.reserve(plan_->GetOrderBy().size());
+  for (const auto &[type, expr] : plan_->GetOrderBy()) {
+    entry.keys_.push_back(expr->Evaluate(&tuple, child_executor_->GetOutputSchema()));
+  }
+  if (!entry.keys_.empty()) {
+    entry.prefix_ = NormalizeKey(entry.keys_[0]);
+    if (plan_->GetOrderBy()[0].first == OrderByType::DESC) {
+      entry.prefix_ = ~entry.prefix_;
+    }
+  }
+  entry.tuple_ = std::move(tuple);
+  return entry;
+}
+
+auto SortExecutor::EntryLess(const SortEntry &lhs, const SortEntry &rhs) const -> bool {
+  if (lhs.prefix_ != rhs.prefix_) {
+    return lhs.prefix_ < rhs.prefix_;
+  }
+  const auto &order_bys = plan_->GetOrderBy();
+  for (size_t i = prefix_exact_ ? 1 : 0; i < order_bys.size(); i++) {
+    const auto &left = lhs.keys_[i];
+    const auto &right = rhs.keys_[i];
+    int cmp;
+    if (left.IsNull() || right.IsNull()) {
+      // Nulls sort first in ascending order.
+      if (left.IsNull() && right.IsNull()) {
+        continue;
+      }
+      cmp = left.IsNull() ? -1 : 1;
+    } else if (left.CompareLessThan(right) == CmpBool::CmpTrue) {
+      cmp = -1;
+    } else if (left.CompareGreaterThan(right) == CmpBool::CmpTrue) {
+      cmp = 1;
+    } else {
+      continue;
+    }
+    return order_bys[i].first == OrderByType::DESC ? cmp > 0 : cmp < 0;
+  }
+  return false;
+}
+
+void SortExecutor::RadixSort(std::vector<SortKey> *keys) {
+  std::array<std::array<size_t, 256>, sizeof(uint64_t)> counts{};
+  for (const auto &[prefix, position] : *keys) {
+    for (size_t byte = 0; byte < counts.size(); byte++) {
+      counts[byte][(prefix >> (8 * byte)) & 0xFF]++;
+    }
+  }
+  std::vector<SortKey> scattered(keys->size());
+  for (size_t byte = 0; byte < counts.size(); byte++) {
+    // A byte all prefixes share, like the high bytes of small integers, does not need a pass.
+    auto &count = counts[byte];
+    if (std::find(count.begin(), count.end(), keys->size()) != count.end()) {
+      continue;
+    }
+    size_t offset = 0;
+    for (auto &bucket : count) {
+      offset += std::exchange(bucket, offset);
+    }
+    for (const auto &key : *keys) {
+      scattered[count[(key.first >> (8 * byte)) & 0xFF]++] = key;
+    }
+    keys->swap(scattered);
+  }
+}
+
+void SortExecutor::SortBuffer() {
+  // Sorting small pairs moves much less than sorting the entries, which are only moved once into their place.
+  std::vector<SortKey> keys(buffer_.size());
+  for (size_t i = 0; i < buffer_.size(); i++) {
+    keys[i] = {buffer_[i].prefix_, static_cast<uint32_t>(i)};
+  }
+  if (keys.size() < RADIX_SORT_THRESHOLD) {
+    std::sort(keys.begin(), keys.end());
+  } else {
+    RadixSort(&keys);
+  }
+
+  // Entries with equal prefixes are only in buffer order so far, unless the prefix decides the order by itself.
+  if (!prefix_exact_ || plan_->GetOrderBy().size() > 1) {
+    for (auto begin = keys.begin(); begin != keys.end();) {
+      auto end = std::find_if(begin, keys.end(), [&](const SortKey &key) { return key.first != begin->first; });
+      if (end - begin > 1) {
+        std::sort(begin, end, [this](const SortKey &lhs, const SortKey &rhs) {
+          return EntryLess(buffer_[lhs.second], buffer_[rhs.second]);
+        });
+      }
+      begin = end;
+    }
+  }
+
+  std::vector<SortEntry> sorted;
+  sorted.reserve(buffer_.size());
+  for (const auto &[prefix, position] : keys) {
+    sorted.push_back(std::move(buffer_[position]));
+  }
+  buffer_ = std::move(sorted);
+}
+
+void SortExecutor::SpillBuffer() {
+  SortBuffer();
+  auto run = std::make_unique<SpillFile>(exec_ctx_->GetBufferPoolManager());
+  for (const auto &entry : buffer_) {
+    run->Append(entry.tuple_);
+  }
+  spilled_runs_.push_back(std::move(run));
+  buffer_.clear();
+  buffer_memory_ = 0;
+  memory_->Resize(0);
+}
+
+void SortExecutor::AdvanceRun(Run *run) {
+  if (run->file_ != nullptr) {
+    Tuple tuple;
+    if (run->file_->Next(&tuple)) {
+      run->head_ = MakeEntry(std::move(tuple));
+      return;
+    }
+  } else if (run->cursor_ < run->entries_.size()) {
+    run->head_ = std::move(run->entries_[run->cursor_++]);
+    return;
+  }
+  run->exhausted_ = true;
+  run->file_ = nullptr;
+  run->entries_.clear();
+}
 
-void SortExecutor::Init() { throw NotImplementedException("SortExecutor is not implemented"); }
+void SortExecutor::StartMerge(std::vector<Run> runs) {
+  merge_runs_ = std::move(runs);
+  for (auto &run : merge_runs_) {
+    if (run.file_ != nullptr) {
+      run.file_->Rewind();
+    }
+    AdvanceRun(&run);
+  }
+  merge_tree_ = std::make_unique<LoserTree>(merge_runs_.size(), [this](size_t a, size_t b) {
+    const auto &lhs = merge_runs_[a];
+    const auto &rhs = merge_runs_[b];
+    if (lhs.exhausted_ || rhs.exhausted_) {
+      return !lhs.exhausted_ || (rhs.exhausted_ && a < b);
+    }
+    if (EntryLess(lhs.head_, rhs.head_)) {
+      return true;
+    }
+    // Break ties on the run, so that the output order of equal keys does not depend on the tree shape.
+    return !EntryLess(rhs.head_, lhs.head_) && a < b;
+  });
+}
 
-auto SortExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+auto SortExecutor::NextMerged(SortEntry *entry) -> bool {
+  if (merge_tree_ == nullptr) {
+    return false;
+  }
+  auto &run = merge_runs_[merge_tree_->Top()];
+  if (run.exhausted_) {
+    return false;
+  }
+  *entry = std::move(run.head_);
+  AdvanceRun(&run);
+  merge_tree_->Replay();
+  return true;
+}
 
 }  // namespace bustub
@@ -0,0 +1,74 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// stream_aggregation_executor.cpp
+//
+// Identification: src/execution/stream_aggregation_executor.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/stream_aggregation_executor.h"
+
+#include <utility>
+
+namespace bustub {
+
+StreamAggregationExecutor::StreamAggregationExecutor(ExecutorContext *exec_ctx, const StreamAggregationPlanNode *plan,
+                                                     std::unique_ptr<AbstractExecutor> &&child)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_(std::move(child)),
+      aht_(plan_->GetGroupBys(), plan_->GetAggregates(), plan_->GetAggregateTypes()) {}
+
+void StreamAggregationExecutor::Init() {
+  child_->Init();
+  aht_.Reset();
+  has_pending_ = false;
+  input_done_ = false;
+  emitted_ = false;
+}
+
+auto StreamAggregationExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  const auto &schema = child_->GetOutputSchema();
+  while (!input_done_) {
+    if (!has_pending_) {
+      RID child_rid;
+      if (!child_->Next(&pending_, &child_rid)) {
+        input_done_ = true;
+        break;
+      }
+      aht_.EncodeKey(pending_, schema, &pending_key_);
+      has_pending_ = true;
+    }
+    auto *group = aht_.FindGroup(pending_key_, aht_.Size() == 0);
+    if (group == nullptr) {
+      // The pending row starts the next group, it is folded in on the next call.
+      EmitGroup(tuple, rid);
+      return true;
+    }
+    aht_.Update(group, pending_, schema);
+    has_pending_ = false;
+  }
+
+  if (aht_.Size() == 0) {
+    // An aggregation without group-bys produces one row even if the input is empty.
+    if (emitted_ || !plan_->GetGroupBys().empty()) {
+      return false;
+    }
+    aht_.InsertEmptyGroup();
+  }
+  EmitGroup(tuple, rid);
+  return true;
+}
+
+void StreamAggregationExecutor::EmitGroup(Tuple *tuple, RID *rid) {
+  *tuple = Tuple{aht_.GetGroupValues(0), &GetOutputSchema()};
+  *rid = RID{};
+  aht_.Reset();
+  emitted_ = true;
+}
+
+}  // namespace bustub
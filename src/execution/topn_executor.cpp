@@ -1,13 +1,113 @@
 #include "execution/executors/topn_executor.h"
 
+#include <algorithm>
+#include <utility>
+
 namespace bustub {
 
+auto TopNHeap::MakeKeys(const Tuple &tuple, const Schema &schema) const -> std::vector<Value> {
+  std::vector<Value> keys;
+  keys.reserve(order_bys_.size());
+  for (const auto &[type, expr] : order_bys_) {
+    keys.push_back(expr->Evaluate(&tuple, schema));
+  }
+  return keys;
+}
+
+auto TopNHeap::KeysLess(const std::vector<Value> &lhs, const std::vector<Value> &rhs) const -> bool {
+  for (size_t i = 0; i < order_bys_.size(); i++) {
+    const auto &left = lhs[i];
+    const auto &right = rhs[i];
+    int cmp;
+    if (left.IsNull() || right.IsNull()) {
+      if (left.IsNull() && right.IsNull()) {
+        continue;
+      }
+      cmp = left.IsNull() ? -1 : 1;
+    } else if (left.CompareLessThan(right) == CmpBool::CmpTrue) {
+      cmp = -1;
+    } else if (left.CompareGreaterThan(right) == CmpBool::CmpTrue) {
+      cmp = 1;
+    } else {
+      continue;
+    }
+    return order_bys_[i].first == OrderByType::DESC ? cmp > 0 : cmp < 0;
+  }
+  return false;
+}
+
+auto TopNHeap::Push(std::vector<Value> &&keys, Tuple &&tuple) -> bool {
+  auto less = [this](const Entry &lhs, const Entry &rhs) { return KeysLess(lhs.keys_, rhs.keys_); };
+  if (n_ == 0) {
+    return false;
+  }
+  if (entries_.size() == n_) {
+    if (!KeysLess(keys, Top())) {
+      return false;
+    }
+    std::pop_heap(entries_.begin(), entries_.end(), less);
+    tuple_bytes_ -= entries_.back().tuple_.GetLength();
+    entries_.pop_back();
+  }
+  tuple_bytes_ += tuple.GetLength();
+  entries_.push_back(Entry{std::move(keys), std::move(tuple)});
+  std::push_heap(entries_.begin(), entries_.end(), less);
+  return true;
+}
+
+void TopNHeap::MergeFrom(TopNHeap &&other) {
+  for (auto &entry : other.entries_) {
+    Push(std::move(entry.keys_), std::move(entry.tuple_));
+  }
+  other.Clear();
+}
+
+auto TopNHeap::Finish() -> std::vector<Entry> {
+  std::sort_heap(entries_.begin(), entries_.end(),
+                 [this](const Entry &lhs, const Entry &rhs) { return KeysLess(lhs.keys_, rhs.keys_); });
+  auto entries = std::move(entries_);
+  Clear();
+  return entries;
+}
+
+void TopNHeap::Clear() {
+  entries_ = std::vector<Entry>{};
+  tuple_bytes_ = 0;
+}
+
 TopNExecutor::TopNExecutor(ExecutorContext *exec_ctx, const TopNPlanNode *plan,
                            std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_executor_(std::move(child_executor)),
+      memory_(exec_ctx->GetMemoryContext()->MakeReservation()),
+      heap_(plan->GetOrderBy(), plan->GetN()) {}
+
+void TopNExecutor::Init() {
+  child_executor_->Init();
+  heap_.Clear();
+  entries_.clear();
+  cursor_ = 0;
 
-void TopNExecutor::Init() { throw NotImplementedException("TopNExecutor is not implemented"); }
+  const auto &schema = child_executor_->GetOutputSchema();
+  Tuple tuple;
+  RID rid;
+  while (plan_->GetN() > 0 && child_executor_->Next(&tuple, &rid)) {
+    heap_.Push(heap_.MakeKeys(tuple, schema), std::move(tuple));
+  }
+  // The heap holds at most n tuples, which cannot spill.
+  memory_->Resize(heap_.GetMemoryUsage());
+  entries_ = heap_.Finish();
+}
 
-auto TopNExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+auto TopNExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  if (cursor_ >= entries_.size()) {
+    return false;
+  }
+  auto &entry = entries_[cursor_++];
+  *rid = entry.tuple_.GetRid();
+  *tuple = std::move(entry.tuple_);
+  return true;
+}
 
 }  // namespace bustub
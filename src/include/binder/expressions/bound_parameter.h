@@ -0,0 +1,24 @@
+#pragma once
+
+#include <string>
+
+#include "binder/bound_expression.h"
+#include "fmt/format.h"
+
+namespace bustub {
+
+/**
+ * A parameter of a prepared statement, e.g., `$1`. Its plan reads the value passed to EXECUTE when it runs.
+ */
+class BoundParameter : public BoundExpression {
+ public:
+  explicit BoundParameter(size_t index) : BoundExpression(ExpressionType::PARAMETER), index_(index) {}
+
+  auto ToString() const -> std::string override { return fmt::format("${}", index_ + 1); }
+
+  auto HasAggregation() const -> bool override { return false; }
+
+  /** The zero-based position of the parameter, `$1` is 0. */
+  size_t index_;
+};
+}  // namespace bustub
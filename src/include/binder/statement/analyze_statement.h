@@ -0,0 +1,30 @@
+//===----------------------------------------------------------------------===//
+//                         BusTub
+//
+// binder/analyze_statement.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <utility>
+
+#include "binder/bound_statement.h"
+#include "common/enums/statement_type.h"
+#include "fmt/format.h"
+
+namespace bustub {
+
+class AnalyzeStatement : public BoundStatement {
+ public:
+  explicit AnalyzeStatement(std::string table)
+      : BoundStatement(StatementType::ANALYZE_STATEMENT), table_(std::move(table)) {}
+
+  /** The table to analyze, empty for all tables */
+  std::string table_;
+
+  auto ToString() const -> std::string override { return fmt::format("BoundAnalyze {{ table={} }}", table_); }
+};
+
+}  // namespace bustub
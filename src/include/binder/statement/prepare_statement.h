@@ -0,0 +1,73 @@
+//===----------------------------------------------------------------------===//
+//                         BusTub
+//
+// binder/prepare_statement.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "binder/bound_statement.h"
+#include "common/enums/statement_type.h"
+#include "common/util/string_util.h"
+#include "fmt/format.h"
+#include "fmt/ranges.h"
+#include "type/value.h"
+
+namespace bustub {
+
+class PrepareStatement : public BoundStatement {
+ public:
+  explicit PrepareStatement(std::string name, std::unique_ptr<BoundStatement> statement, size_t parameter_count)
+      : BoundStatement(StatementType::PREPARE_STATEMENT),
+        name_(std::move(name)),
+        statement_(std::move(statement)),
+        parameter_count_(parameter_count) {}
+
+  std::string name_;
+  /** The statement to prepare, whose `$n` parameters are bound but not yet known */
+  std::unique_ptr<BoundStatement> statement_;
+  /** The number of values EXECUTE has to pass, the highest `$n` used */
+  size_t parameter_count_;
+
+  auto ToString() const -> std::string override {
+    return fmt::format("BoundPrepare {{\n  name={},\n  parameters={},\n  statement={},\n}}", name_, parameter_count_,
+                       StringUtil::IndentAllLines(statement_->ToString(), 2, true));
+  }
+};
+
+class ExecuteStatement : public BoundStatement {
+ public:
+  explicit ExecuteStatement(std::string name, std::vector<Value> parameters)
+      : BoundStatement(StatementType::EXECUTE_STATEMENT), name_(std::move(name)), parameters_(std::move(parameters)) {}
+
+  std::string name_;
+  /** The values of `$1`, `$2`, ... */
+  std::vector<Value> parameters_;
+
+  auto ToString() const -> std::string override {
+    std::vector<std::string> parameters;
+    for (const auto &parameter : parameters_) {
+      parameters.push_back(parameter.ToString());
+    }
+    return fmt::format("BoundExecute {{ name={}, parameters=[{}] }}", name_, fmt::join(parameters, ", "));
+  }
+};
+
+class DeallocateStatement : public BoundStatement {
+ public:
+  explicit DeallocateStatement(std::string name)
+      : BoundStatement(StatementType::DEALLOCATE_STATEMENT), name_(std::move(name)) {}
+
+  /** The prepared statement to drop, empty for all of them */
+  std::string name_;
+
+  auto ToString() const -> std::string override { return fmt::format("BoundDeallocate {{ name={} }}", name_); }
+};
+
+}  // namespace bustub
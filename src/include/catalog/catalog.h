@@ -20,6 +20,7 @@
 
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/schema.h"
+#include "catalog/table_stats.h"
 #include "container/hash/hash_function.h"
 #include "storage/index/b_plus_tree_index.h"
 #include "storage/index/extendible_hash_table_index.h"
@@ -56,6 +57,8 @@ struct TableInfo {
   std::unique_ptr<TableHeap> table_;
   /** The table OID */
   const table_oid_t oid_;
+  /** The table statistics, used by the optimizer to estimate cardinalities */
+  TableStats stats_;
 };
 
 /**
@@ -150,6 +153,7 @@ class Catalog {
     tables_.emplace(table_oid, std::move(meta));
     table_names_.emplace(table_name, table_oid);
     index_names_.emplace(table_name, std::unordered_map<std::string, index_oid_t>{});
+    version_++;
 
     return tmp;
   }
@@ -246,6 +250,7 @@ class Catalog {
     // Update internal tracking
     indexes_.emplace(index_oid, std::move(index_info));
     table_indexes.emplace(index_name, index_oid);
+    version_++;
 
     return tmp;
   }
@@ -298,7 +303,7 @@ class Catalog {
    * @param index_oid The OID of the index for which to query
    * @return A (non-owning) pointer to the metadata for the index
    */
-  auto GetIndex(index_oid_t index_oid) -> IndexInfo * {
+  auto GetIndex(index_oid_t index_oid) const -> IndexInfo * {
     auto index = indexes_.find(index_oid);
     if (index == indexes_.end()) {
       return NULL_INDEX_INFO;
@@ -341,6 +346,22 @@ class Catalog {
     return result;
   }
 
+  /**
+   * Collect the statistics of a table. Plans made with the old statistics are invalidated.
+   * @param txn The transaction in which the table is scanned
+   * @param table_info The table to analyze
+   */
+  void AnalyzeTable(Transaction *txn, TableInfo *table_info) {
+    table_info->stats_.Analyze(table_info->table_.get(), table_info->schema_, txn);
+    version_++;
+  }
+
+  /**
+   * @return a number that changes whenever a table or index is created or a table is analyzed, so that cached plans
+   * can be checked
+   */
+  auto GetVersion() const -> uint64_t { return version_; }
+
  private:
   [[maybe_unused]] BufferPoolManager *bpm_;
   [[maybe_unused]] LockManager *lock_manager_;
@@ -371,6 +392,9 @@ class Catalog {
 
   /** The next index identifier to be used. */
   std::atomic<index_oid_t> next_index_oid_{0};
+
+  /** The number of changes made to the catalog. */
+  std::atomic<uint64_t> version_{0};
 };
 
 }  // namespace bustub
@@ -0,0 +1,110 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_stats.h
+//
+// Identification: src/include/catalog/table_stats.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/util/hyperloglog.h"
+#include "type/value.h"
+
+namespace bustub {
+
+class TableHeap;
+class Transaction;
+
+/**
+ * The statistics of one column, collected by ANALYZE. Selectivities are fractions of all rows of the table, so the
+ * null fraction is already accounted for.
+ */
+class ColumnStats {
+ public:
+  /**
+   * Summarize a column.
+   * @param sample The values of the column in a random sample of rows, nulls included
+   * @param distinct A sketch of the distinct values of the column over all rows
+   * @param num_buckets The number of histogram buckets
+   */
+  ColumnStats(std::vector<Value> sample, const HyperLogLog &distinct, size_t num_buckets);
+
+  /** @return the fraction of rows where the column is null */
+  auto GetNullFraction() const -> double { return null_fraction_; }
+
+  /** @return the estimated number of distinct non-null values */
+  auto GetDistinctCount() const -> uint64_t { return distinct_count_; }
+
+  /** @return the bounds of the equi-depth histogram, the smallest value first and the largest last */
+  auto GetHistogramBounds() const -> const std::vector<Value> & { return bounds_; }
+
+  /** @return the estimated fraction of rows where the column equals `value` */
+  auto EstimateEqual(const Value &value) const -> double;
+
+  /** @return the estimated fraction of rows where the column is less than (or equal to) `value` */
+  auto EstimateLess(const Value &value, bool or_equal) const -> double;
+
+  /** @return the estimated fraction of rows where the column is greater than (or equal to) `value` */
+  auto EstimateGreater(const Value &value, bool or_equal) const -> double;
+
+ private:
+  /** @return the estimated fraction of non-null values below `value`, ignoring equal ones */
+  auto FractionBelow(const Value &value) const -> double;
+
+  double null_fraction_{0};
+  uint64_t distinct_count_{0};
+  /**
+   * `bounds_[i]` and `bounds_[i + 1]` delimit bucket `i`, and every bucket holds the same share of the non-null
+   * values. Empty if the column has no non-null values.
+   */
+  std::vector<Value> bounds_;
+};
+
+/**
+ * The statistics of a table. The row count is maintained by the executors that insert and delete rows, and is
+ * exact unless transactions abort. The column statistics are only present once the table has been analyzed, and
+ * age as the table changes until it is analyzed again.
+ */
+class TableStats {
+ public:
+  /** The number of rows sampled to build histograms */
+  static constexpr size_t SAMPLE_SIZE = 30000;
+  /** The number of buckets of every histogram */
+  static constexpr size_t HISTOGRAM_BUCKETS = 64;
+
+  /**
+   * Scan a table, counting its rows and building the statistics of every column. Distinct counts are sketched over
+   * all rows, histograms and null fractions are built from a uniform sample of rows.
+   */
+  void Analyze(TableHeap *table, const Schema &schema, Transaction *txn);
+
+  /** Account for rows added (positive) or removed (negative) since the last count */
+  void UpdateRowCount(int64_t delta) { row_count_ += delta; }
+
+  /** @return the number of rows in the table */
+  auto GetRowCount() const -> uint64_t { return std::max<int64_t>(row_count_, 0); }
+
+  /** @return whether the table has been analyzed, i.e. column statistics are present */
+  auto IsAnalyzed() const -> bool { return !columns_.empty(); }
+
+  /** @return the statistics of a column, `nullptr` if the table has not been analyzed */
+  auto GetColumnStats(uint32_t col_idx) const -> const ColumnStats * {
+    return col_idx < columns_.size() ? &columns_[col_idx] : nullptr;
+  }
+
+ private:
+  std::atomic<int64_t> row_count_{0};
+  std::vector<ColumnStats> columns_;
+};
+
+}  // namespace bustub
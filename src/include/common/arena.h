@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arena.h
+//
+// Identification: src/include/common/arena.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * Arena is a bump allocator for many small objects that share a lifetime, e.g. the groups of an aggregation. Memory
+ * is carved out of blocks and only released all at once, so an allocation is just a pointer increment. Blocks start
+ * small and double in size, so that small arenas stay small.
+ */
+class Arena {
+ public:
+  /** The size of the first block */
+  static constexpr size_t MIN_BLOCK_SIZE = 4 << 10;
+  /** Blocks stop growing at this size, larger allocations get a block of their own */
+  static constexpr size_t MAX_BLOCK_SIZE = 256 << 10;
+
+  Arena() = default;
+  ~Arena() = default;
+
+  DISALLOW_COPY(Arena);
+  Arena(Arena &&) = default;
+  auto operator=(Arena &&) -> Arena & = default;
+
+  /**
+   * Allocate uninitialized memory that stays valid until the arena is cleared or destroyed.
+   * @param size the number of bytes to allocate
+   * @return memory aligned to 8 bytes
+   */
+  auto Allocate(size_t size) -> char * {
+    size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    if (size > remaining_) {
+      NewBlock(size);
+    }
+    auto *ptr = cursor_;
+    cursor_ += size;
+    remaining_ -= size;
+    return ptr;
+  }
+
+  /** Release all memory */
+  void Clear();
+
+  /** Make all memory available for new allocations again, keeping the first block and releasing the others */
+  void Reset();
+
+  /** @return the number of bytes held by the arena */
+  auto GetMemoryUsage() const -> size_t { return memory_usage_; }
+
+ private:
+  static constexpr size_t ALIGNMENT = 8;
+
+  /** Start a new block that has room for at least `size` bytes */
+  void NewBlock(size_t size);
+
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  char *cursor_{nullptr};
+  size_t remaining_{0};
+  size_t next_block_size_{MIN_BLOCK_SIZE};
+  size_t first_block_size_{0};
+  size_t memory_usage_{0};
+};
+
+}  // namespace bustub
@@ -26,6 +26,7 @@
 #include "common/config.h"
 #include "common/util/string_util.h"
 #include "libfort/lib/fort.hpp"
+#include "planner/plan_cache.h"
 #include "type/value.h"
 
 namespace bustub {
@@ -39,7 +40,11 @@ class TransactionManager;
 class LogManager;
 class CheckpointManager;
 class Catalog;
+class BoundStatement;
+class PrepareStatement;
+class ExecuteStatement;
 class ExecutionEngine;
+class TaskScheduler;
 
 class ResultWriter {
  public:
@@ -210,6 +215,42 @@ class BustubInstance {
    */
   auto MakeExecutorContext(Transaction *txn) -> std::unique_ptr<ExecutorContext>;
 
+  /**
+   * Get the number of workers a query may use, controlled by the `execution_threads` session variable.
+   * Defaults to the number of scheduler workers.
+   */
+  auto GetExecutionThreads() -> size_t;
+
+  /**
+   * Get the number of bytes the operators of a query may hold together, controlled by the `query_memory_limit`
+   * session variable. Defaults to `query_memory_limit` in config.h.
+   */
+  auto GetQueryMemoryLimit() -> size_t;
+
+  /** @return the statement an EXECUTE refers to, after checking that it is given the right number of parameters */
+  auto GetPreparedStatement(const ExecuteStatement &execute_stmt) -> const PrepareStatement &;
+
+  /**
+   * Plan, optimize and execute a bound statement, writing its result set.
+   * @param statement The statement to run
+   * @param cache_key Where to cache the optimized plan, `nullptr` to not cache it
+   */
+  auto PlanAndExecute(const BoundStatement &statement, const std::string *cache_key, ResultWriter &writer,
+                      Transaction *txn) -> bool;
+
+  /**
+   * Execute a prepared statement, writing its result set. The statement is planned by its first EXECUTE, later ones
+   * bind their values to the cached plan.
+   * @param prepared The statement to run
+   * @param parameters The values of the `$n` parameters of the statement
+   */
+  auto ExecutePrepared(const PrepareStatement &prepared, const std::vector<Value> &parameters, ResultWriter &writer,
+                       Transaction *txn) -> bool;
+
+  /** Execute an optimized plan, writing its result set with the column names of `schema`. */
+  auto ExecutePlan(const AbstractPlanNodeRef &plan, const Schema &schema, ResultWriter &writer, Transaction *txn)
+      -> bool;
+
  public:
   explicit BustubInstance(const std::string &db_file_name);
 
@@ -252,6 +293,7 @@ class BustubInstance {
   CheckpointManager *checkpoint_manager_;
   Catalog *catalog_;
   ExecutionEngine *execution_engine_;
+  TaskScheduler *task_scheduler_;
   std::shared_mutex catalog_lock_;
 
   auto GetSessionVariable(const std::string &key) -> std::string {
@@ -261,6 +303,9 @@ class BustubInstance {
     return "";
   }
 
+  /** @return the cache of optimized plans, e.g. to inspect its hit rate */
+  auto GetPlanCache() -> PlanCache & { return plan_cache_; }
+
   auto IsForceStarterRule() -> bool {
     auto variable = StringUtil::Lower(GetSessionVariable("force_optimizer_starter_rule"));
     return variable == "1" || variable == "true" || variable == "yes";
@@ -272,6 +317,10 @@ class BustubInstance {
   void CmdDisplayHelp(ResultWriter &writer);
   void WriteOneCell(const std::string &cell, ResultWriter &writer);
   std::unordered_map<std::string, std::string> session_variables_;
+  /** The statements prepared in this session, by name */
+  std::unordered_map<std::string, std::unique_ptr<PrepareStatement>> prepared_statements_;
+  /** The optimized plans of recently run statements */
+  PlanCache plan_cache_;
 };
 
 }  // namespace bustub
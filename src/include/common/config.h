@@ -27,6 +27,13 @@ extern std::atomic<bool> enable_logging;
 /** If ENABLE_LOGGING is true, the log should be flushed to disk every LOG_TIMEOUT. */
 extern std::chrono::duration<int64_t> log_timeout;
 
+/** Operators that buffer their input in memory spill to temporary pages once they hold more than this many bytes,
+ * even if the memory budget of their query would allow more. */
+extern std::atomic<size_t> operator_memory_limit;
+
+/** The default number of bytes all operators of one query may hold together before they have to spill. */
+extern std::atomic<size_t> query_memory_limit;
+
 static constexpr int INVALID_PAGE_ID = -1;                                           // invalid page id
 static constexpr int INVALID_TXN_ID = -1;                                            // invalid transaction id
 static constexpr int INVALID_LSN = -1;                                               // invalid log sequence number
@@ -36,6 +43,9 @@ static constexpr int BUFFER_POOL_SIZE = 10;
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * BUSTUB_PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                               // size of extendible hash bucket
 static constexpr int LRUK_REPLACER_K = 10;  // lookback window for lru-k replacer
+static constexpr size_t MORSEL_SIZE_IN_PAGES = 16;     // number of table pages scanned by one parallel task
+static constexpr size_t MORSEL_SIZE_IN_TUPLES = 8192;  // number of mock table rows scanned by one parallel task
+static constexpr size_t PLAN_CACHE_SIZE = 128;         // number of optimized plans kept by a BusTub instance
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
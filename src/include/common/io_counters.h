@@ -0,0 +1,35 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// io_counters.h
+//
+// Identification: src/include/common/io_counters.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+namespace bustub {
+
+/**
+ * Counters of the page traffic caused by one thread. They only ever grow, so EXPLAIN ANALYZE attributes work to an
+ * executor by taking their difference around each call into it.
+ */
+struct IoCounters {
+  /** Pages requested from the buffer pool */
+  uint64_t pages_fetched_{0};
+  /** Requested pages that had to be read from disk */
+  uint64_t pages_missed_{0};
+  /** Bytes written to temporary pages by operators that spill */
+  uint64_t bytes_spilled_{0};
+};
+
+/** The counters of the calling thread */
+inline thread_local IoCounters thread_io_counters;
+
+}  // namespace bustub
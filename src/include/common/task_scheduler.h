@@ -0,0 +1,147 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// task_scheduler.h
+//
+// Identification: src/include/common/task_scheduler.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * TaskScheduler is a work-stealing thread pool used to run the tasks of a parallel query.
+ *
+ * Every worker owns a task deque. A worker pushes and pops tasks at the back of its own deque, so that the most
+ * recently spawned (and most cache-friendly) task runs first. When its deque is empty, a worker steals the oldest
+ * task from the front of another worker's deque. Tasks submitted from a thread outside the pool are distributed over
+ * the workers in round-robin order.
+ */
+class TaskScheduler {
+ public:
+  using Task = std::function<void()>;
+
+  /**
+   * Create a new task scheduler and start its workers.
+   * @param num_workers the number of worker threads, at least one worker is always started
+   */
+  explicit TaskScheduler(size_t num_workers);
+
+  /** Stop all workers. Tasks that are still queued are discarded. */
+  ~TaskScheduler();
+
+  DISALLOW_COPY_AND_MOVE(TaskScheduler);
+
+  /**
+   * Submit a task to the scheduler.
+   * @param task the task to be run on one of the workers
+   */
+  void Submit(Task task);
+
+  /**
+   * Run one queued task on the calling thread, if there is any. Threads that wait for other tasks call this to
+   * help out instead of blocking, which also keeps nested waits from deadlocking the pool.
+   * @return `true` if a task was run
+   */
+  auto RunOneTask() -> bool;
+
+  /** @return the number of worker threads */
+  auto GetWorkerCount() const -> size_t { return workers_.size(); }
+
+  /**
+   * @return the index of the worker running the calling thread in [0, GetWorkerCount()), or GetWorkerCount() if the
+   * calling thread does not belong to this scheduler. Useful to index per-worker state.
+   */
+  auto GetCurrentWorkerIndex() const -> size_t;
+
+ private:
+  /** The task deque owned by one worker. */
+  struct WorkerQueue {
+    std::mutex latch_;
+    std::deque<Task> tasks_;
+  };
+
+  /** The main loop of a worker thread. */
+  void WorkerLoop(size_t worker_idx);
+
+  /** Pop a task from the back of the given worker's deque. */
+  auto PopLocal(size_t worker_idx, Task *task) -> bool;
+
+  /** Steal a task from the front of any deque, starting after the given worker. */
+  auto Steal(size_t start_idx, Task *task) -> bool;
+
+  /** One queue per worker. */
+  std::vector<std::unique_ptr<WorkerQueue>> queues_;
+  /** The worker threads. */
+  std::vector<std::thread> workers_;
+  /** The number of queued tasks over all deques. */
+  std::atomic<size_t> pending_{0};
+  /** Round-robin cursor for tasks submitted from outside the pool. */
+  std::atomic<size_t> next_queue_{0};
+  /** Set when the scheduler shuts down. */
+  std::atomic<bool> stopped_{false};
+  /** Idle workers sleep on this condition variable. */
+  std::mutex sleep_latch_;
+  std::condition_variable sleep_cv_;
+};
+
+/**
+ * TaskGroup tracks a set of tasks submitted to a scheduler so that the submitter can wait for all of them. Waiting
+ * runs queued tasks on the waiting thread. The first exception thrown by a task is rethrown by Wait().
+ */
+class TaskGroup {
+ public:
+  /**
+   * Create a task group.
+   * @param scheduler the scheduler to run tasks on; if `nullptr`, tasks run inline on the submitting thread
+   */
+  explicit TaskGroup(TaskScheduler *scheduler) : scheduler_(scheduler) {}
+
+  /** Waits for outstanding tasks, swallowing their exceptions. Call Wait() to observe them. */
+  ~TaskGroup();
+
+  DISALLOW_COPY_AND_MOVE(TaskGroup);
+
+  /**
+   * Run a task as part of this group.
+   * @param task the task to run
+   */
+  void Run(TaskScheduler::Task task);
+
+  /** Block until every task of the group has finished, then rethrow the first exception thrown by a task. */
+  void Wait();
+
+ private:
+  /** Shared with the running tasks, so that it outlives the group if needed. */
+  struct State {
+    std::mutex latch_;
+    std::condition_variable cv_;
+    size_t outstanding_{0};
+    std::exception_ptr error_;
+  };
+
+  /** Block until all tasks are done, without rethrowing. */
+  void WaitQuietly();
+
+  TaskScheduler *scheduler_;
+  std::shared_ptr<State> state_{std::make_shared<State>()};
+};
+
+}  // namespace bustub
@@ -49,6 +49,16 @@ class HashUtil {
     return (l % PRIME_FACTOR + r % PRIME_FACTOR) % PRIME_FACTOR;
   }
 
+  /** @return the hash with its entropy spread over all bits (the finalizer of MurmurHash3) */
+  static inline auto MixHash(hash_t hash) -> hash_t {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+  }
+
   template <typename T>
   static inline auto Hash(const T *ptr) -> hash_t {
     return HashBytes(reinterpret_cast<const char *>(ptr), sizeof(T));
@@ -100,6 +110,34 @@ class HashUtil {
       }
     }
   }
+
+  /**
+   * @return the hash of a key for hash tables, partitioning and sketches, with its entropy spread over all bits.
+   * `HashValue` folds the bytes of a value with shifts, so that many small integers collide. Integers are taken as
+   * they are instead and strings are hashed with FNV-1a before mixing.
+   */
+  static inline auto HashKey(const Value &val) -> hash_t {
+    switch (val.GetTypeId()) {
+      case TypeId::TINYINT:
+        return MixHash(static_cast<hash_t>(static_cast<int64_t>(val.GetAs<int8_t>())));
+      case TypeId::SMALLINT:
+        return MixHash(static_cast<hash_t>(static_cast<int64_t>(val.GetAs<int16_t>())));
+      case TypeId::INTEGER:
+        return MixHash(static_cast<hash_t>(static_cast<int64_t>(val.GetAs<int32_t>())));
+      case TypeId::BIGINT:
+        return MixHash(static_cast<hash_t>(val.GetAs<int64_t>()));
+      case TypeId::VARCHAR: {
+        hash_t hash = 0xcbf29ce484222325ULL;
+        const auto *data = val.GetData();
+        for (uint32_t i = 0; i < val.GetLength(); i++) {
+          hash = (hash ^ static_cast<uint8_t>(data[i])) * 0x100000001b3ULL;
+        }
+        return MixHash(hash);
+      }
+      default:
+        return MixHash(HashValue(&val));
+    }
+  }
 };
 
 }  // namespace bustub
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <functional>
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
@@ -52,6 +53,33 @@ class ExecutionEngine {
   // NOLINTNEXTLINE
   auto Execute(const AbstractPlanNodeRef &plan, std::vector<Tuple> *result_set, Transaction *txn,
                ExecutorContext *exec_ctx) -> bool {
+    auto executor_succeeded = Execute(
+        plan,
+        [result_set](const Tuple &tuple) {
+          if (result_set != nullptr) {
+            result_set->push_back(tuple);
+          }
+        },
+        txn, exec_ctx);
+    if (!executor_succeeded && result_set != nullptr) {
+      result_set->clear();
+    }
+    return executor_succeeded;
+  }
+
+  /**
+   * Execute a query plan, handing every output tuple to `on_tuple` as soon as the root executor produces it. Nothing
+   * is buffered by the engine, so the first rows reach the consumer before the query completes. If execution fails
+   * midway, the tuples that have already been handed out stay delivered.
+   * @param plan The query plan to execute
+   * @param on_tuple The consumer of the tuples produced by executing the plan
+   * @param txn The transaction context in which the query executes
+   * @param exec_ctx The executor context in which the query executes
+   * @return `true` if execution of the query plan succeeds, `false` otherwise
+   */
+  // NOLINTNEXTLINE
+  auto Execute(const AbstractPlanNodeRef &plan, const std::function<void(const Tuple &)> &on_tuple,
+               Transaction *txn, ExecutorContext *exec_ctx) -> bool {
     BUSTUB_ASSERT((txn == exec_ctx->GetTransaction()), "Broken Invariant");
 
     // Construct the executor for the abstract plan node
@@ -62,15 +90,12 @@ class ExecutionEngine {
 
     try {
       executor->Init();
-      PollExecutor(executor.get(), plan, result_set);
+      PollExecutor(executor.get(), plan, on_tuple);
     } catch (const ExecutionException &ex) {
 #ifndef NDEBUG
       LOG_ERROR("Error Encountered in Executor Execution: %s", ex.what());
 #endif
       executor_succeeded = false;
-      if (result_set != nullptr) {
-        result_set->clear();
-      }
     }
 
     return executor_succeeded;
@@ -81,16 +106,14 @@ class ExecutionEngine {
    * Poll the executor until exhausted, or exception escapes.
    * @param executor The root executor
    * @param plan The plan to execute
-   * @param result_set The tuple result set
+   * @param on_tuple The consumer of the output tuples
    */
   static void PollExecutor(AbstractExecutor *executor, const AbstractPlanNodeRef &plan,
-                           std::vector<Tuple> *result_set) {
+                           const std::function<void(const Tuple &)> &on_tuple) {
     RID rid{};
     Tuple tuple{};
     while (executor->Next(&tuple, &rid)) {
-      if (result_set != nullptr) {
-        result_set->push_back(tuple);
-      }
+      on_tuple(tuple);
     }
   }
 
@@ -12,12 +12,16 @@
 
 #pragma once
 
+#include <memory>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "catalog/catalog.h"
+#include "common/task_scheduler.h"
 #include "concurrency/transaction.h"
+#include "execution/memory_context.h"
+#include "execution/query_profile.h"
 #include "storage/page/tmp_tuple_page.h"
 
 namespace bustub {
@@ -33,10 +37,21 @@ class ExecutorContext {
    * @param bpm The buffer pool manager that the executor uses
    * @param txn_mgr The transaction manager that the executor uses
    * @param lock_mgr The lock manager that the executor uses
+   * @param scheduler The task scheduler that parallel executors run on, `nullptr` for serial execution
+   * @param parallelism The maximum number of workers a single operator may occupy
+   * @param memory_limit The number of bytes the operators of the query may hold together before they spill
    */
   ExecutorContext(Transaction *transaction, Catalog *catalog, BufferPoolManager *bpm, TransactionManager *txn_mgr,
-                  LockManager *lock_mgr)
-      : transaction_(transaction), catalog_{catalog}, bpm_{bpm}, txn_mgr_(txn_mgr), lock_mgr_(lock_mgr) {}
+                  LockManager *lock_mgr, TaskScheduler *scheduler = nullptr, size_t parallelism = 1,
+                  size_t memory_limit = query_memory_limit)
+      : transaction_(transaction),
+        catalog_{catalog},
+        bpm_{bpm},
+        txn_mgr_(txn_mgr),
+        lock_mgr_(lock_mgr),
+        scheduler_(scheduler),
+        parallelism_(scheduler == nullptr ? 1 : parallelism),
+        memory_context_(memory_limit) {}
 
   ~ExecutorContext() = default;
 
@@ -60,6 +75,21 @@ class ExecutorContext {
   /** @return the transaction manager */
   auto GetTransactionManager() -> TransactionManager * { return txn_mgr_; }
 
+  /** @return the task scheduler, `nullptr` if the query runs serially */
+  auto GetTaskScheduler() const -> TaskScheduler * { return scheduler_; }
+
+  /** @return the maximum number of workers a single operator may occupy, 1 if the query runs serially */
+  auto GetParallelism() const -> size_t { return parallelism_; }
+
+  /** @return the memory budget of the query, which operators that buffer their input reserve memory from */
+  auto GetMemoryContext() -> MemoryContext * { return &memory_context_; }
+
+  /** Record what every executor created from now on does, for EXPLAIN ANALYZE */
+  void EnableProfiling() { profile_ = std::make_unique<QueryProfile>(); }
+
+  /** @return the profile of the executors of this query, `nullptr` unless profiling is enabled */
+  auto GetProfile() -> QueryProfile * { return profile_.get(); }
+
  private:
   /** The transaction context associated with this executor context */
   Transaction *transaction_;
@@ -71,6 +101,14 @@ class ExecutorContext {
   TransactionManager *txn_mgr_;
   /** The lock manager associated with this executor context */
   LockManager *lock_mgr_;
+  /** The task scheduler associated with this executor context */
+  TaskScheduler *scheduler_;
+  /** The degree of parallelism of this query */
+  size_t parallelism_;
+  /** The memory held by the operators of this query */
+  MemoryContext memory_context_;
+  /** The per-executor figures of this query, only collected for EXPLAIN ANALYZE */
+  std::unique_ptr<QueryProfile> profile_;
 };
 
 }  // namespace bustub
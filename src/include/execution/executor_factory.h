@@ -31,5 +31,10 @@ class ExecutorFactory {
    */
   static auto CreateExecutor(ExecutorContext *exec_ctx, const AbstractPlanNodeRef &plan)
       -> std::unique_ptr<AbstractExecutor>;
+
+ private:
+  /** Creates the executor of the given plan node without any profiling around it */
+  static auto CreatePlanExecutor(ExecutorContext *exec_ctx, const AbstractPlanNodeRef &plan)
+      -> std::unique_ptr<AbstractExecutor>;
 };
 }  // namespace bustub
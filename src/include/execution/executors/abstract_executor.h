@@ -13,6 +13,7 @@
 #pragma once
 
 #include "execution/executor_context.h"
+#include "execution/runtime_filter.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -49,6 +50,14 @@ class AbstractExecutor {
   /** @return The schema of the tuples that this executor produces */
   virtual auto GetOutputSchema() const -> const Schema & = 0;
 
+  /**
+   * Ask this executor to drop the tuples that fail a runtime filter as early as it can. The filter's key expression
+   * refers to the output schema of this executor.
+   * @param filter the filter, which is built after it has been added but before the first call to Next()
+   * @return `true` if the executor (or one of its children) applies the filter, `false` if the caller has to
+   */
+  virtual auto AddRuntimeFilter(RuntimeFilterRef filter) -> bool { return false; }
+
   /** @return The executor context in which this executor runs */
   auto GetExecutorContext() -> ExecutorContext * { return exec_ctx_; }
 
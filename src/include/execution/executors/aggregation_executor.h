@@ -12,141 +12,293 @@
 
 #pragma once
 
+#include <cstring>
+#include <functional>
+#include <limits>
 #include <memory>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "common/arena.h"
 #include "common/util/hash_util.h"
-#include "container/hash/hash_function.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/expressions/abstract_expression.h"
 #include "execution/plans/aggregation_plan.h"
+#include "storage/table/spill_file.h"
 #include "storage/table/tuple.h"
 #include "type/value_factory.h"
 
 namespace bustub {
 
 /**
- * A simplified hash table that has all the necessary functionality for aggregations.
+ * A hash table for aggregations that stores every group as a fixed-layout row in an arena.
+ *
+ * A row holds a null flag and an 8 byte slot for every group-by key and every accumulator. Integers are widened to
+ * int64_t and decimals are stored as doubles; VARCHAR keys take a 16 byte slot pointing to a copy of their bytes in
+ * the arena. A VARCHAR MIN or MAX points to a copy of the current extreme in the arena, prefixed by its length.
+ * Groups are found through an open-addressing slot array (linear probing) that stores the hash next to the row, so
+ * most mismatches are rejected without touching the row and growing the table needs no rehashing.
+ * Accumulators are updated in place by a kernel picked for each aggregate and input type when the table is created.
  */
-class SimpleAggregationHashTable {
+class AggregationHashTable {
  public:
+  /** The group-by keys of an input tuple in row layout, see EncodeKey() */
+  struct GroupKey {
+    std::vector<char> bytes_;
+    /** The evaluated keys, VARCHAR slots in `bytes_` point into them */
+    std::vector<Value> values_;
+    hash_t hash_;
+  };
+
   /**
-   * Construct a new SimpleAggregationHashTable instance.
+   * Construct a new AggregationHashTable instance.
+   * @param group_bys the group-by expressions
    * @param agg_exprs the aggregation expressions
    * @param agg_types the types of aggregations
    */
-  SimpleAggregationHashTable(const std::vector<AbstractExpressionRef> &agg_exprs,
-                             const std::vector<AggregationType> &agg_types)
-      : agg_exprs_{agg_exprs}, agg_types_{agg_types} {}
-
-  /** @return The initial aggregrate value for this aggregation executor */
-  auto GenerateInitialAggregateValue() -> AggregateValue {
-    std::vector<Value> values{};
-    for (const auto &agg_type : agg_types_) {
-      switch (agg_type) {
-        case AggregationType::CountStarAggregate:
-          // Count start starts at zero.
-          values.emplace_back(ValueFactory::GetIntegerValue(0));
-          break;
-        case AggregationType::CountAggregate:
-        case AggregationType::SumAggregate:
-        case AggregationType::MinAggregate:
-        case AggregationType::MaxAggregate:
-          // Others starts at null.
-          values.emplace_back(ValueFactory::GetNullValueByType(TypeId::INTEGER));
-          break;
-      }
-    }
-    return {values};
-  }
+  AggregationHashTable(const std::vector<AbstractExpressionRef> &group_bys,
+                       const std::vector<AbstractExpressionRef> &agg_exprs,
+                       const std::vector<AggregationType> &agg_types);
 
   /**
-   * TODO(Student)
-   *
-   * Combines the input into the aggregation result.
-   * @param[out] result The output aggregate value
-   * @param input The input value
+   * Evaluate and hash the group-by keys of an input tuple. Keys can be looked up in any table over the same
+   * group-by expressions.
+   * @param tuple the input tuple
+   * @param schema the schema of the input tuple
+   * @param[out] key the encoded key
    */
-  void CombineAggregateValues(AggregateValue *result, const AggregateValue &input) {
-    for (uint32_t i = 0; i < agg_exprs_.size(); i++) {
-      switch (agg_types_[i]) {
-        case AggregationType::CountStarAggregate:
-        case AggregationType::CountAggregate:
-        case AggregationType::SumAggregate:
-        case AggregationType::MinAggregate:
-        case AggregationType::MaxAggregate:
-          break;
-      }
-    }
-  }
+  void EncodeKey(const Tuple &tuple, const Schema &schema, GroupKey *key) const;
 
   /**
-   * Inserts a value into the hash table and then combines it with the current aggregation.
-   * @param agg_key the key to be inserted
-   * @param agg_val the value to be inserted
+   * Find the group of a key.
+   * @param key the key, as encoded by EncodeKey()
+   * @param insert whether to create the group if it does not exist yet
+   * @return the row of the group, `nullptr` if the group does not exist and `insert` is `false`
    */
-  void InsertCombine(const AggregateKey &agg_key, const AggregateValue &agg_val) {
-    if (ht_.count(agg_key) == 0) {
-      ht_.insert({agg_key, GenerateInitialAggregateValue()});
-    }
-    CombineAggregateValues(&ht_[agg_key], agg_val);
-  }
+  auto FindGroup(const GroupKey &key, bool insert) -> char * { return Lookup(key.bytes_.data(), key.hash_, insert); }
+
+  /**
+   * Fold an input tuple into the accumulators of a group.
+   * @param row the row of the group, as returned by FindGroup()
+   * @param tuple the input tuple
+   * @param schema the schema of the input tuple
+   */
+  void Update(char *row, const Tuple &tuple, const Schema &schema);
 
   /**
-   * Clear the hash table
+   * Fold all groups of another table into this one, e.g. to combine the partial aggregates of parallel workers.
+   * @param other a table over the same group-by and aggregation expressions
    */
-  void Clear() { ht_.clear(); }
+  void MergeFrom(const AggregationHashTable &other);
 
-  /** An iterator over the aggregation hash table */
-  class Iterator {
-   public:
-    /** Creates an iterator for the aggregate map. */
-    explicit Iterator(std::unordered_map<AggregateKey, AggregateValue>::const_iterator iter) : iter_{iter} {}
+  /** Create the group without group-by keys, which an aggregation without group-bys has even on empty input */
+  void InsertEmptyGroup();
 
-    /** @return The key of the iterator */
-    auto Key() -> const AggregateKey & { return iter_->first; }
+  /** @return the group-by keys followed by the aggregates of a group, groups are numbered in insertion order */
+  auto GetGroupValues(size_t group_idx) const -> std::vector<Value>;
 
-    /** @return The value of the iterator */
-    auto Val() -> const AggregateValue & { return iter_->second; }
+  /** @return the number of groups */
+  auto Size() const -> size_t { return rows_.size(); }
 
-    /** @return The iterator before it is incremented */
-    auto operator++() -> Iterator & {
-      ++iter_;
-      return *this;
-    }
+  /** Drop all groups */
+  void Clear();
 
-    /** @return `true` if both iterators are identical */
-    auto operator==(const Iterator &other) -> bool { return this->iter_ == other.iter_; }
+  /** Drop all groups but keep the memory of the table for the groups to come */
+  void Reset();
 
-    /** @return `true` if both iterators are different */
-    auto operator!=(const Iterator &other) -> bool { return this->iter_ != other.iter_; }
+  /** @return the number of bytes held by the table */
+  auto GetMemoryUsage() const -> size_t {
+    return arena_.GetMemoryUsage() + slots_.size() * sizeof(Slot) + rows_.capacity() * sizeof(char *);
+  }
+
+ private:
+  /** How an accumulator folds in an input value */
+  enum class Kernel : uint8_t {
+    CountStar,
+    Count,
+    SumInt,
+    SumDecimal,
+    MinInt,
+    MinDecimal,
+    MinVarchar,
+    MaxInt,
+    MaxDecimal,
+    MaxVarchar
+  };
 
-   private:
-    /** Aggregates map */
-    std::unordered_map<AggregateKey, AggregateValue>::const_iterator iter_;
+  /** A slot of the open-addressing array */
+  struct Slot {
+    hash_t hash_;
+    /** The row of the group, `nullptr` if the slot is empty */
+    char *row_;
   };
 
-  /** @return Iterator to the start of the hash table */
-  auto Begin() -> Iterator { return Iterator{ht_.cbegin()}; }
+  /** The layout of a VARCHAR key slot */
+  struct VarcharSlot {
+    const char *data_;
+    uint64_t length_;
+  };
 
-  /** @return Iterator to the end of the hash table */
-  auto End() -> Iterator { return Iterator{ht_.cend()}; }
+  template <class T>
+  static auto Load(const char *ptr) -> T {
+    T value;
+    std::memcpy(&value, ptr, sizeof(T));
+    return value;
+  }
 
- private:
-  /** The hash table is just a map from aggregate keys to aggregate values */
-  std::unordered_map<AggregateKey, AggregateValue> ht_{};
-  /** The aggregate expressions that we have */
+  template <class T>
+  static void Store(char *ptr, T value) {
+    std::memcpy(ptr, &value, sizeof(T));
+  }
+
+  /** @return the slot of a hash, taken from the high bits since spill partitioning consumes the low ones */
+  auto SlotOf(hash_t hash) const -> size_t { return (hash >> 32) & (slots_.size() - 1); }
+
+  /** @return a non-null numeric value as an integer */
+  static auto AsInt(const Value &value) -> int64_t;
+
+  /** @return a non-null numeric value as a double */
+  static auto AsDecimal(const Value &value) -> double;
+
+  /** @return the 8 byte encoding of a non-null fixed-size value */
+  static auto EncodeFixed(const Value &value) -> uint64_t;
+
+  /** @return the value of the given type encoded in an 8 byte slot */
+  static auto DecodeFixed(TypeId type, uint64_t bits) -> Value;
+
+  /** @return the hash of a key in row layout */
+  auto HashKey(const char *key) const -> hash_t;
+
+  /** @return whether a row holds a key */
+  auto KeyEquals(const char *row, const char *key) const -> bool;
+
+  /** Fold the accumulators of a row of another table into a row of this one */
+  void MergeRow(char *row, const char *other_row);
+
+  /** @return a copy of a VARCHAR in the arena, its 4 byte length followed by its bytes */
+  auto CopyVarchar(const char *data, uint32_t length) -> const char *;
+
+  /** @return whether a VARCHAR replaces the accumulated MIN or MAX, a copy made by CopyVarchar() */
+  static auto VarcharReplaces(Kernel kernel, const char *accumulated, const char *data, uint32_t length) -> bool;
+
+  /** @return the row of a key in row layout, creating it if it does not exist and `insert` is set */
+  auto Lookup(const char *key, hash_t hash, bool insert) -> char *;
+
+  /** Double the slot array */
+  void Grow();
+
+  const std::vector<AbstractExpressionRef> &group_bys_;
   const std::vector<AbstractExpressionRef> &agg_exprs_;
-  /** The types of aggregations that we have */
-  const std::vector<AggregationType> &agg_types_;
+
+  /** The declared types of the keys and of the accumulators */
+  std::vector<TypeId> key_types_;
+  std::vector<TypeId> agg_output_types_;
+  std::vector<Kernel> kernels_;
+
+  /** The offsets of the key slots, fixed-size keys come first */
+  std::vector<size_t> key_offsets_;
+  /** The end of the null flags and fixed-size keys, which compare and hash as raw bytes */
+  size_t fixed_key_size_;
+  /** The end of the key */
+  size_t key_size_;
+  /** The offset of the accumulator null flags */
+  size_t agg_null_offset_;
+  /** The offset of the accumulator slots */
+  size_t agg_offset_;
+  size_t row_size_;
+
+  Arena arena_;
+  /** The rows in insertion order */
+  std::vector<char *> rows_;
+  std::vector<Slot> slots_;
+};
+
+/**
+ * SpillingAggregation aggregates input tuples into an AggregationHashTable within a memory budget.
+ *
+ * Groups are aggregated in the table until it goes over budget. From then on, input tuples of groups that are already
+ * in the table are still aggregated in place, while the tuples of all other groups are radix-partitioned on their key
+ * hash and spilled to temporary pages. After the groups in memory have been emitted, every spilled partition is
+ * aggregated the same way, partitioning on further hash bits if it overflows again. Spill partitioning consumes the
+ * lowest `RADIX_BITS * MAX_PARTITION_DEPTH` bits of the key hash.
+ */
+class SpillingAggregation {
+ public:
+  /** The number of hash bits consumed by each level of partitioning */
+  static constexpr size_t RADIX_BITS = 4;
+  static constexpr size_t NUM_PARTITIONS = 1 << RADIX_BITS;
+  /** Partitions beyond this many levels are aggregated in memory regardless of the memory limit */
+  static constexpr size_t MAX_PARTITION_DEPTH = 4;
+
+  /**
+   * Construct a new SpillingAggregation instance.
+   * @param exec_ctx the executor context, whose memory context the table is reserved in
+   * @param plan the aggregation plan
+   * @param input_schema the schema of the input tuples
+   * @param memory_limit the most bytes the table may hold, on top of the budget of its reservation
+   */
+  SpillingAggregation(ExecutorContext *exec_ctx, const AggregationPlanNode *plan, const Schema *input_schema,
+                      size_t memory_limit = std::numeric_limits<size_t>::max());
+
+  /** @return the table holding the groups in memory */
+  auto GetTable() -> AggregationHashTable & { return table_; }
+
+  /** @return whether tuples have been spilled that are not aggregated yet */
+  auto HasSpilled() const -> bool { return !spilled_.empty(); }
+
+  /**
+   * Aggregate input tuples into the table, spilling the groups that do not fit.
+   * @param next_input produces the next input tuple, returns `false` when the input is exhausted
+   * @param depth the partitioning level for spilled tuples
+   */
+  void Aggregate(const std::function<bool(Tuple *)> &next_input, size_t depth = 0);
+
+  /**
+   * Replace the groups in the table by those of the next spilled partition.
+   * @return `false` if no spilled partition is left
+   */
+  auto AggregateNextSpilled() -> bool;
+
+  /** Drop all groups and spilled tuples and give the memory back */
+  void Clear();
+
+  /**
+   * Charge the table to the memory context before it is filled other than by Aggregate(), e.g. by merging tables.
+   * @param bytes the number of bytes the table will hold
+   * @return `true` if the table is within budget
+   */
+  auto Reserve(size_t bytes) -> bool { return memory_->Resize(bytes); }
+
+ private:
+  /** The spilled input tuples of a partition that still has to be aggregated */
+  struct SpilledPartition {
+    std::unique_ptr<SpillFile> file_;
+    /** The partitioning level to use when this partition overflows again */
+    size_t depth_;
+  };
+
+  /** @return the partition of a group key hash at the given partitioning level */
+  static auto PartitionOf(hash_t hash, size_t depth) -> size_t {
+    return (hash >> (depth * RADIX_BITS)) & (NUM_PARTITIONS - 1);
+  }
+
+  ExecutorContext *exec_ctx_;
+  const Schema *input_schema_;
+  size_t memory_limit_;
+  AggregationHashTable table_;
+  /** The memory reserved for the table */
+  std::unique_ptr<MemoryReservation> memory_;
+  /** Spilled partitions that still have to be aggregated */
+  std::vector<SpilledPartition> spilled_;
 };
 
 /**
  * AggregationExecutor executes an aggregation operation (e.g. COUNT, SUM, MIN, MAX)
  * over the tuples produced by a child executor.
+ *
+ * Groups that do not fit into the memory budget of the operator are spilled and aggregated later, see
+ * SpillingAggregation.
  */
 class AggregationExecutor : public AbstractExecutor {
  public:
@@ -176,33 +328,14 @@ class AggregationExecutor : public AbstractExecutor {
   /** Do not use or remove this function, otherwise you will get zero points. */
   auto GetChildExecutor() const -> const AbstractExecutor *;
 
- private:
-  /** @return The tuple as an AggregateKey */
-  auto MakeAggregateKey(const Tuple *tuple) -> AggregateKey {
-    std::vector<Value> keys;
-    for (const auto &expr : plan_->GetGroupBys()) {
-      keys.emplace_back(expr->Evaluate(tuple, child_->GetOutputSchema()));
-    }
-    return {keys};
-  }
-
-  /** @return The tuple as an AggregateValue */
-  auto MakeAggregateValue(const Tuple *tuple) -> AggregateValue {
-    std::vector<Value> vals;
-    for (const auto &expr : plan_->GetAggregates()) {
-      vals.emplace_back(expr->Evaluate(tuple, child_->GetOutputSchema()));
-    }
-    return {vals};
-  }
-
  private:
   /** The aggregation plan node */
   const AggregationPlanNode *plan_;
   /** The child executor that produces tuples over which the aggregation is computed */
   std::unique_ptr<AbstractExecutor> child_;
-  /** Simple aggregation hash table */
-  // TODO(Student): Uncomment SimpleAggregationHashTable aht_;
-  /** Simple aggregation hash table iterator */
-  // TODO(Student): Uncomment SimpleAggregationHashTable::Iterator aht_iterator_;
+  /** The groups in memory and the spilled tuples still to be aggregated */
+  SpillingAggregation aggregation_;
+  /** The next group of the hash table to emit */
+  size_t aht_cursor_{0};
 };
 }  // namespace bustub
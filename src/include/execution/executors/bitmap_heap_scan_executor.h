@@ -0,0 +1,85 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bitmap_heap_scan_executor.h
+//
+// Identification: src/include/execution/executors/bitmap_heap_scan_executor.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/bitmap_heap_scan_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * The BitmapHeapScanExecutor reads the tuples whose RIDs are found by index lookups, in RID order.
+ *
+ * Init() runs all index lookups and keeps the combined RIDs sorted by page and slot. Next() then reads the heap one
+ * page at a time, taking all requested tuples of a page with a single fetch.
+ */
+class BitmapHeapScanExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new BitmapHeapScanExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The bitmap heap scan plan to be executed
+   */
+  BitmapHeapScanExecutor(ExecutorContext *exec_ctx, const BitmapHeapScanPlanNode *plan);
+
+  /** Run the index lookups */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from the scan.
+   * @param[out] tuple The next tuple produced by the scan
+   * @param[out] rid The next tuple RID produced by the scan
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto Next(Tuple *tuple, RID *rid) -> bool override;
+
+  /** @return The output schema for the scan */
+  auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
+
+  /** Runtime filters are applied right after the scan predicate */
+  auto AddRuntimeFilter(RuntimeFilterRef filter) -> bool override {
+    runtime_filters_.push_back(std::move(filter));
+    return true;
+  }
+
+ private:
+  /** @return the RIDs found by one lookup, sorted and without duplicates */
+  auto LookupRids(const BitmapIndexLookup &lookup) const -> std::vector<RID>;
+
+  /** @return the RIDs of all keys within the range of a range lookup, sorted */
+  auto LookupRange(const IndexInfo &index_info, const BitmapIndexLookup &lookup) const -> std::vector<RID>;
+
+  /** Read the tuples of the next page with matching RIDs, return `false` if there are no more pages */
+  auto FetchNextPage() -> bool;
+
+  /** The bitmap heap scan plan node to be executed */
+  const BitmapHeapScanPlanNode *plan_;
+  /** The table to scan */
+  const TableInfo *table_info_;
+  /** The RIDs to read, sorted by page and slot */
+  std::vector<RID> rids_;
+  /** The position of the first RID of the next page in `rids_` */
+  size_t rid_cursor_{0};
+  /** The tuples read from the current page */
+  std::vector<std::pair<Tuple, RID>> page_tuples_;
+  /** The position of the next tuple within `page_tuples_` */
+  size_t page_cursor_{0};
+  /** Runtime filters pushed down by joins above this scan */
+  std::vector<RuntimeFilterRef> runtime_filters_;
+};
+}  // namespace bustub
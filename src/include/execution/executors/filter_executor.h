@@ -51,6 +51,11 @@ class FilterExecutor : public AbstractExecutor {
   /** @return The output schema for the filter plan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
+  /** The filter does not change the schema, so runtime filters can go further down */
+  auto AddRuntimeFilter(RuntimeFilterRef filter) -> bool override {
+    return child_executor_->AddRuntimeFilter(std::move(filter));
+  }
+
  private:
   /** The filter plan node to be executed */
   const FilterPlanNode *plan_;
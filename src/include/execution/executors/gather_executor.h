@@ -0,0 +1,126 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// gather_executor.h
+//
+// Identification: src/include/execution/executors/gather_executor.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <exception>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "common/task_scheduler.h"
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/morsel.h"
+#include "execution/pipeline.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * GatherExecutor runs a parallelizable pipeline morsel by morsel on the task scheduler and hands the results to its
+ * (serial) parent. Results are emitted in morsel order, so a parallel scan produces the same rows in the same order
+ * as a serial one. At most two morsels per worker are in flight, which bounds the amount of buffered output.
+ */
+class GatherExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new GatherExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The topmost plan node of the pipeline to be run in parallel
+   */
+  GatherExecutor(ExecutorContext *exec_ctx, AbstractPlanNodeRef plan);
+
+  /** Cancel and wait for all tasks that are still running */
+  ~GatherExecutor() override;
+
+  /** Initialize the gather, restarting the pipeline */
+  void Init() override;
+
+  /**
+   * Yield the next tuple produced by the pipeline.
+   * @param[out] tuple The next tuple produced by the pipeline
+   * @param[out] rid The next tuple RID produced by the pipeline
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto Next(Tuple *tuple, RID *rid) -> bool override;
+
+  /** @return The output schema of the pipeline */
+  auto GetOutputSchema() const -> const Schema & override { return pipeline_.GetPlan()->OutputSchema(); }
+
+  /** Runtime filters are pushed into every morsel's pipeline, or applied on the workers if the pipeline declines */
+  auto AddRuntimeFilter(RuntimeFilterRef filter) -> bool override {
+    runtime_filters_.push_back(std::move(filter));
+    return true;
+  }
+
+ private:
+  /** The output of one morsel */
+  struct MorselOutput {
+    std::vector<std::pair<Tuple, RID>> tuples_;
+    std::exception_ptr error_;
+    bool done_{false};
+  };
+
+  /** Submit morsels until the in-flight window is full */
+  void ScheduleMorsels();
+
+  /** Run the pipeline over one morsel, called on a worker */
+  void RunMorsel(size_t morsel_idx);
+
+  /** Wait for the morsel `current_morsel_` to finish, running queued tasks in the meantime */
+  void WaitForCurrentMorsel();
+
+  /** Stop all in-flight tasks and wait for them */
+  void Cancel();
+
+  /**
+   * Create the pipeline executor of a morsel and hand it the runtime filters.
+   * @param[out] residual_filters the runtime filters that the pipeline does not apply itself
+   */
+  auto MakeMorselExecutor(const Morsel &morsel, std::vector<RuntimeFilterRef> *residual_filters)
+      -> std::unique_ptr<AbstractExecutor>;
+
+  /** The pipeline to be run */
+  Pipeline pipeline_;
+  /** The morsels of the current run */
+  std::vector<Morsel> morsels_;
+  /** The output of every morsel, guarded by `latch_` */
+  std::vector<MorselOutput> outputs_;
+  std::mutex latch_;
+  std::condition_variable cv_;
+  /** Set to make in-flight tasks stop early */
+  std::atomic<bool> cancelled_{false};
+  /** The next morsel to be submitted */
+  size_t next_morsel_{0};
+  /** The morsel whose output is being emitted */
+  size_t current_morsel_{0};
+  /** The output of the current morsel, moved out of `outputs_` */
+  std::vector<std::pair<Tuple, RID>> current_tuples_;
+  /** Whether `current_tuples_` holds the output of `current_morsel_` */
+  bool current_loaded_{false};
+  /** The position of the next tuple within `current_tuples_` */
+  size_t cursor_{0};
+  /** Runs the pipeline inline if there is only one morsel */
+  std::unique_ptr<AbstractExecutor> serial_executor_;
+  /** The runtime filters that `serial_executor_` does not apply itself */
+  std::vector<RuntimeFilterRef> serial_residual_filters_;
+  /** Runtime filters pushed down by joins above this gather */
+  std::vector<RuntimeFilterRef> runtime_filters_;
+  /** The in-flight tasks; declared last so that it is destroyed (and waited for) first */
+  std::unique_ptr<TaskGroup> tasks_;
+};
+
+}  // namespace bustub
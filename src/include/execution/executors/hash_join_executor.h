@@ -14,16 +14,80 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
+#include "common/util/hash_util.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/hash_join_plan.h"
+#include "storage/table/spill_file.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
- * HashJoinExecutor executes a nested-loop JOIN on two tables.
+ * A compact hash table over the build side tuples of one hash join partition.
+ *
+ * Tuples are appended to a flat array first. Build() then sizes an open-addressing slot array (linear probing over
+ * stored hashes) to the exact number of tuples. Tuples with equal keys are chained behind the first one in insertion
+ * order, so a probe visits every slot at most once per distinct key.
+ */
+class JoinHashTable {
+ public:
+  /** A build side tuple together with its join key */
+  struct Entry {
+    hash_t hash_;
+    Value key_;
+    Tuple tuple_;
+    /** The next entry with the same key, as index + 1 into the entries, 0 at the end of the chain */
+    uint32_t next_;
+  };
+
+  /** Add a tuple. The tuple cannot be found until Build() is called. */
+  void Insert(hash_t hash, Value key, Tuple tuple);
+
+  /** Build the slot array over all inserted tuples */
+  void Build();
+
+  /** @return the first entry whose key equals `key`, `nullptr` if there is none */
+  auto Find(hash_t hash, const Value &key) const -> const Entry *;
+
+  /** @return the entry after `entry` with the same key, `nullptr` if there is none */
+  auto FindNext(const Entry *entry) const -> const Entry * {
+    return entry->next_ == 0 ? nullptr : &entries_[entry->next_ - 1];
+  }
+
+  /** Drop all tuples */
+  void Clear();
+
+  /** @return the inserted tuples */
+  auto GetEntries() const -> const std::vector<Entry> & { return entries_; }
+
+  /** @return the approximate number of bytes used by the inserted tuples */
+  auto GetMemoryUsage() const -> size_t { return memory_usage_; }
+
+ private:
+  /** The slot of a hash, taken from the high bits since partitioning consumes the low ones */
+  auto SlotOf(hash_t hash) const -> size_t { return (hash >> 32) & (slots_.size() - 1); }
+
+  std::vector<Entry> entries_;
+  /** Open-addressing slots holding index + 1 of the first entry of each key, 0 if empty */
+  std::vector<uint32_t> slots_;
+  size_t memory_usage_{0};
+};
+
+/**
+ * HashJoinExecutor executes an equi-join with a radix-partitioned hash table.
+ *
+ * The right child is the build side, the left child the probe side. Build tuples are radix-partitioned on the low bits
+ * of their key hash, and every partition gets its own small hash table. When the build side goes over the memory
+ * budget of the operator, the largest partitions are spilled to temporary pages, and probe tuples that fall into a
+ * spilled partition are spilled as well (Grace hash join). Spilled partition pairs are joined after the in-memory ones,
+ * re-partitioning on further hash bits if they still do not fit.
+ *
+ * For inner joins, the build side keys are also summarized in a RuntimeFilter that is pushed into the probe side, so
+ * that probe tuples without a match are dropped by the scan that produces them. The build side is therefore consumed
+ * before the probe side is initialized.
  */
 class HashJoinExecutor : public AbstractExecutor {
  public:
@@ -52,8 +116,94 @@ class HashJoinExecutor : public AbstractExecutor {
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
 
  private:
-  /** The NestedLoopJoin plan node to be executed. */
+  /** The number of hash bits consumed by each level of partitioning */
+  static constexpr size_t RADIX_BITS = 6;
+  static constexpr size_t NUM_PARTITIONS = 1 << RADIX_BITS;
+  /** Spilled partitions are re-partitioned at most this many times */
+  static constexpr size_t MAX_PARTITION_DEPTH = 3;
+  /** The runtime filter may take at most this fraction of the budget of the join */
+  static constexpr size_t RUNTIME_FILTER_BUDGET_SHARE = 8;
+
+  /** A build side partition, either in memory or spilled together with its probe side counterpart */
+  struct Partition {
+    JoinHashTable table_;
+    std::unique_ptr<SpillFile> build_file_;
+    std::unique_ptr<SpillFile> probe_file_;
+  };
+
+  /** A pair of spilled partitions waiting to be joined */
+  struct SpilledPartition {
+    std::unique_ptr<SpillFile> build_file_;
+    std::unique_ptr<SpillFile> probe_file_;
+    /** The number of partitioning levels that produced this partition */
+    size_t depth_;
+  };
+
+  /** @return the partition of a hash at the given partitioning level */
+  static auto PartitionOf(hash_t hash, size_t depth) -> size_t {
+    return (hash >> (depth * RADIX_BITS)) & (NUM_PARTITIONS - 1);
+  }
+
+  /** Consume the build side into the partitions */
+  void BuildPartitions();
+
+  /** Move the largest in-memory partition to disk, return `false` if there is nothing left to spill */
+  auto SpillLargestPartition() -> bool;
+
+  /** @return the bytes held by the in-memory partitions and the runtime filter */
+  auto BuildMemoryUsage() const -> size_t {
+    return memory_usage_ + (runtime_filter_ != nullptr ? runtime_filter_->GetMemoryUsage() : 0);
+  }
+
+  /** Fetch the next probe tuple and find its first match, return `false` if the probe side is exhausted */
+  auto NextProbeTuple() -> bool;
+
+  /** Prepare the next spilled partition for probing, return `false` if there is none left */
+  auto LoadSpilledPartition() -> bool;
+
+  /** Split a spilled partition that is too large into partitions on the next hash bits */
+  void RepartitionSpilled(SpilledPartition spilled);
+
+  /** @return the join of a probe tuple with a build tuple, or with nulls if `build_tuple` is `nullptr` */
+  auto MakeOutputTuple(const Tuple &probe_tuple, const Tuple *build_tuple) const -> Tuple;
+
+  /** The HashJoin plan node to be executed. */
   const HashJoinPlanNode *plan_;
+  /** The probe side */
+  std::unique_ptr<AbstractExecutor> left_child_;
+  /** The build side */
+  std::unique_ptr<AbstractExecutor> right_child_;
+  /** The filter over the build side keys applied by the probe side, `nullptr` if the probe side cannot apply one */
+  std::shared_ptr<RuntimeFilter> runtime_filter_;
+
+  /** The in-memory and spilled build partitions */
+  std::vector<Partition> partitions_;
+  /** The bytes held by all in-memory partitions */
+  size_t memory_usage_{0};
+  /**
+   * The memory reserved for the in-memory partitions and the runtime filter, or for the hash table of the spilled
+   * partition being joined
+   */
+  std::unique_ptr<MemoryReservation> memory_;
+  /** Spilled partitions that still have to be joined */
+  std::vector<SpilledPartition> spilled_;
+  /** Whether the probe side has been consumed and the spilled partitions are being joined */
+  bool joining_spilled_{false};
+  /** The hash table of the spilled partition being joined */
+  JoinHashTable spilled_table_;
+  /** The probe side of the spilled partition being joined */
+  std::unique_ptr<SpillFile> spilled_probe_file_;
+
+  /** The current probe tuple */
+  Tuple probe_tuple_;
+  /** The hash table the current probe tuple was looked up in */
+  const JoinHashTable *match_table_{nullptr};
+  /** The next build tuple matching the current probe tuple */
+  const JoinHashTable::Entry *match_{nullptr};
+  /** Whether the current probe tuple has found a match */
+  bool probe_matched_{false};
+  /** Whether there is a current probe tuple */
+  bool has_probe_tuple_{false};
 };
 
 }  // namespace bustub
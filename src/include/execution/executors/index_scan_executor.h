@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <optional>
+#include <utility>
 #include <vector>
 
 #include "common/rid.h"
@@ -24,6 +26,10 @@ namespace bustub {
 
 /**
  * IndexScanExecutor executes an index scan over a table.
+ *
+ * The index entries are copied out of the B+ tree a batch at a time, and every batch descends the tree again after the
+ * last key of the previous one. No leaf latch is held between calls to Next(), so an operator above the scan may
+ * modify the same index, e.g. a DELETE that removes the entries it is handed.
  */
 
 class IndexScanExecutor : public AbstractExecutor {
@@ -41,6 +47,12 @@ class IndexScanExecutor : public AbstractExecutor {
 
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /** Runtime filters are applied to the fetched tuples */
+  auto AddRuntimeFilter(RuntimeFilterRef filter) -> bool override {
+    runtime_filters_.push_back(std::move(filter));
+    return true;
+  }
+
  private:
   /** The index scan plan node to be executed. */
   const IndexScanPlanNode *plan_;
@@ -48,6 +60,21 @@ class IndexScanExecutor : public AbstractExecutor {
   const IndexInfo *index_info_;
   const TableInfo *table_info_;
   BPlusTreeIndexForOneIntegerColumn *tree_;
-  BPlusTreeIndexIteratorForOneIntegerColumn iter_;
+  /** The maximum number of index entries copied at once */
+  static constexpr size_t BATCH_SIZE = 256;
+
+  /** Copy the next batch of index entries, return `false` if the index is exhausted */
+  auto FetchBatch() -> bool;
+
+  /** The current batch of index entries */
+  std::vector<std::pair<IntegerKeyType, RID>> entries_;
+  /** The next entry of the batch */
+  size_t entry_cursor_{0};
+  /** The last key copied so far, the next batch starts after it */
+  std::optional<IntegerKeyType> last_key_;
+  /** Whether the scan has copied all entries it needs */
+  bool index_exhausted_{false};
+  /** Runtime filters pushed down by joins above this scan */
+  std::vector<RuntimeFilterRef> runtime_filters_;
 };
 }  // namespace bustub
@@ -59,7 +59,7 @@ class InsertExecutor : public AbstractExecutor {
   const InsertPlanNode *plan_;
   std::unique_ptr<AbstractExecutor> child_;
   TableInfo *table_info_;
-  bool is_success_;
+  bool is_success_ = false;
 };
 
 }  // namespace bustub
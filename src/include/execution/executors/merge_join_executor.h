@@ -0,0 +1,93 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// merge_join_executor.h
+//
+// Identification: src/include/execution/executors/merge_join_executor.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/merge_join_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * MergeJoinExecutor executes an equi-join over two inputs that are sorted on their join keys, e.g. B+ tree index
+ * scans or sorts, in a single streaming pass over both.
+ *
+ * Duplicates are handled with mark and restore on the right input: the run of right tuples sharing the current key is
+ * marked by buffering it, and restored for every left tuple with that key. Memory is therefore bounded by the largest
+ * run of equal right keys, not by the size of either input. Null keys never match and are skipped.
+ */
+class MergeJoinExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new MergeJoinExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The merge join plan to be executed
+   * @param left_child The child executor producing the left input, sorted on the left join key
+   * @param right_child The child executor producing the right input, sorted on the right join key
+   */
+  MergeJoinExecutor(ExecutorContext *exec_ctx, const MergeJoinPlanNode *plan,
+                    std::unique_ptr<AbstractExecutor> &&left_child, std::unique_ptr<AbstractExecutor> &&right_child);
+
+  /** Initialize the join */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from the join.
+   * @param[out] tuple The next tuple produced by the join
+   * @param[out] rid The next tuple RID, not used by merge join
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto Next(Tuple *tuple, RID *rid) -> bool override;
+
+  /** @return The output schema for the join */
+  auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
+
+ private:
+  /** Fetch the next left tuple and its key into `left_tuple_` and `left_key_` */
+  void AdvanceLeft();
+
+  /** Fetch the next right tuple and its key into `right_tuple_` and `right_key_` */
+  void AdvanceRight();
+
+  /** @return the join of a left tuple with a right tuple, or with nulls if `right_tuple` is `nullptr` */
+  auto MakeOutputTuple(const Tuple &left_tuple, const Tuple *right_tuple) const -> Tuple;
+
+  /** The merge join plan node to be executed */
+  const MergeJoinPlanNode *plan_;
+  /** The left input */
+  std::unique_ptr<AbstractExecutor> left_child_;
+  /** The right input */
+  std::unique_ptr<AbstractExecutor> right_child_;
+
+  /** The current left tuple and its key, `left_key_` is empty once the left input is exhausted */
+  Tuple left_tuple_;
+  std::optional<Value> left_key_;
+  /** The right tuple following the marked run and its key, `right_key_` is empty once the right input is exhausted */
+  Tuple right_tuple_;
+  std::optional<Value> right_key_;
+  /** The marked run of right tuples sharing the key `mark_key_` */
+  std::vector<Tuple> mark_;
+  std::optional<Value> mark_key_;
+  /** The next tuple of `mark_` to be joined with the current left tuple */
+  size_t mark_cursor_{0};
+  /** Whether the current left tuple is being joined with the marked run */
+  bool restoring_{false};
+};
+
+}  // namespace bustub
@@ -18,6 +18,7 @@
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/morsel.h"
 #include "execution/plans/mock_scan_plan.h"
 #include "storage/table/tuple.h"
 
@@ -25,6 +26,7 @@ namespace bustub {
 
 extern const char *mock_table_list[];
 auto GetMockTableSchemaOf(const std::string &table) -> Schema;
+auto GetSizeOf(const MockScanPlanNode *plan) -> size_t;
 
 /**
  * The MockScanExecutor executor executes a sequential table scan for tests.
@@ -38,6 +40,14 @@ class MockScanExecutor : public AbstractExecutor {
    */
   MockScanExecutor(ExecutorContext *exec_ctx, const MockScanPlanNode *plan);
 
+  /**
+   * Construct a new MockScanExecutor instance that only produces the rows of one morsel.
+   * @param exec_ctx The executor context
+   * @param plan The mock scan plan to be executed
+   * @param morsel The row range to be produced
+   */
+  MockScanExecutor(ExecutorContext *exec_ctx, const MockScanPlanNode *plan, const Morsel &morsel);
+
   /** Initialize the mock scan. */
   void Init() override;
 
@@ -52,6 +62,12 @@ class MockScanExecutor : public AbstractExecutor {
   /** @return The output schema for the sequential scan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
+  /** Runtime filters are applied to every generated row */
+  auto AddRuntimeFilter(RuntimeFilterRef filter) -> bool override {
+    runtime_filters_.push_back(std::move(filter));
+    return true;
+  }
+
  private:
   /** @return A dummy tuple according to the output schema */
   auto MakeDummyTuple() const -> Tuple;
@@ -74,11 +90,17 @@ class MockScanExecutor : public AbstractExecutor {
   /** The table function */
   std::function<Tuple(std::size_t)> func_;
 
-  /** The size of the mock table */
+  /** The first row produced by this scan */
+  std::size_t begin_;
+
+  /** One past the last row produced by this scan */
   std::size_t size_;
 
   /** The shuffled output */
   std::vector<size_t> shuffled_idx_;
+
+  /** Runtime filters pushed down by joins above this scan */
+  std::vector<RuntimeFilterRef> runtime_filters_;
 };
 
 }  // namespace bustub
@@ -12,16 +12,20 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "common/task_scheduler.h"
+#include "concurrency/transaction.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/expressions/abstract_expression.h"
 #include "execution/plans/nested_index_join_plan.h"
+#include "storage/index/index.h"
 #include "storage/table/tmp_tuple.h"
 #include "storage/table/tuple.h"
 
@@ -29,6 +33,15 @@ namespace bustub {
 
 /**
  * IndexJoinExecutor executes index join operations.
+ *
+ * Outer tuples are consumed in batches. The join keys of a batch are handed to the index together, which lets an
+ * ordered index look them up in key order with one sweep over its leaves instead of one descent per outer tuple.
+ * Results are still produced in the order of the outer tuples.
+ *
+ * Probing a batch (the index lookups and the inner heap fetches) runs as a task on the query's TaskScheduler. Up to
+ * PREFETCH_DEPTH batches are probed ahead of the batch being emitted, so that page reads for the following batches
+ * overlap with each other and with the work of the operators above the join. The outer side is only ever pulled by
+ * the thread calling Next().
  */
 class NestIndexJoinExecutor : public AbstractExecutor {
  public:
@@ -41,6 +54,8 @@ class NestIndexJoinExecutor : public AbstractExecutor {
   NestIndexJoinExecutor(ExecutorContext *exec_ctx, const NestedIndexJoinPlanNode *plan,
                         std::unique_ptr<AbstractExecutor> &&child_executor);
 
+  ~NestIndexJoinExecutor() override;
+
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
   void Init() override;
@@ -48,7 +63,65 @@ class NestIndexJoinExecutor : public AbstractExecutor {
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
  private:
+  /** The maximum number of outer tuples probed together */
+  static constexpr size_t BATCH_SIZE = 512;
+  /** The maximum number of batches being probed ahead of the batch being emitted */
+  static constexpr size_t PREFETCH_DEPTH = 4;
+
+  /** A batch of outer tuples together with their matching inner tuples */
+  struct Batch {
+    std::vector<Tuple> outer_;
+    std::vector<std::vector<Tuple>> inner_;
+  };
+
+  /** A batch handed to the scheduler, owned by its probe task until the task has finished */
+  struct Prefetch {
+    Prefetch(TaskScheduler *scheduler, const Transaction &txn)
+        : txn_(txn.GetTransactionId(), txn.GetIsolationLevel()), probe_(scheduler) {}
+
+    Batch batch_;
+    /**
+     * The transaction the probe reads the index and the inner table with. Transaction is not thread-safe and the
+     * thread pulling the outer side keeps using the query's transaction, so every probe gets its own.
+     */
+    Transaction txn_;
+    /** The probe task, declared last so that it finishes before the batch goes away */
+    TaskGroup probe_;
+  };
+
+  /** Pull batches of outer tuples and start probing them until PREFETCH_DEPTH batches are in flight */
+  void PrefetchBatches();
+
+  /**
+   * Wait for the oldest batch in flight and make it the batch being emitted.
+   * @return `false` if no batch is in flight
+   */
+  auto TakeBatch() -> bool;
+
+  /** Look up the inner tuples of every outer tuple in the batch */
+  void ProbeBatch(Batch *batch, Transaction *txn) const;
+
+  /** @return the join of an outer tuple with an inner tuple, or with nulls if `inner_tuple` is `nullptr` */
+  auto MakeOutputTuple(const Tuple &outer_tuple, const Tuple *inner_tuple) const -> Tuple;
+
   /** The nested index join plan node. */
   const NestedIndexJoinPlanNode *plan_;
+  /** The outer side */
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  /** The index probed for inner tuples */
+  const IndexInfo *index_info_;
+  /** The inner table */
+  const TableInfo *table_info_;
+
+  /** The batch being emitted */
+  Batch batch_;
+  /** The batches being probed, oldest first */
+  std::deque<std::unique_ptr<Prefetch>> prefetches_;
+  /** The outer tuple in the batch being joined */
+  size_t batch_cursor_{0};
+  /** The next inner tuple to join with the current outer tuple */
+  size_t inner_cursor_{0};
+  /** Whether the outer side is exhausted */
+  bool outer_exhausted_{false};
 };
 }  // namespace bustub
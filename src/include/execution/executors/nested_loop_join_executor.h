@@ -14,6 +14,7 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
@@ -24,6 +25,10 @@ namespace bustub {
 
 /**
  * NestedLoopJoinExecutor executes a nested-loop JOIN on two tables.
+ *
+ * The join runs block by block: it buffers as many left tuples as fit into its memory budget and joins every
+ * right tuple against the whole block, so the right child is scanned once per block instead of once per left tuple.
+ * Within a block the output is ordered by the right tuples.
  */
 class NestedLoopJoinExecutor : public AbstractExecutor {
  public:
@@ -53,8 +58,39 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
 
  private:
+  /** Buffer the next block of left tuples and restart the right child, return `false` if the left side is exhausted */
+  auto LoadBlock() -> bool;
+
+  /** @return the join of a left tuple with a right tuple, or with nulls if `right_tuple` is `nullptr` */
+  auto MakeOutputTuple(const Tuple &left_tuple, const Tuple *right_tuple) const -> Tuple;
+
   /** The NestedLoopJoin plan node to be executed. */
   const NestedLoopJoinPlanNode *plan_;
+  /** The outer side */
+  std::unique_ptr<AbstractExecutor> left_executor_;
+  /** The inner side, scanned once per block */
+  std::unique_ptr<AbstractExecutor> right_executor_;
+
+  /** The current block of left tuples */
+  std::vector<Tuple> block_;
+  /** The memory reserved for the block */
+  std::unique_ptr<MemoryReservation> memory_;
+  /** Whether each tuple of the block has found a match, for left joins */
+  std::vector<bool> block_matched_;
+  /** Whether the left side has been consumed completely */
+  bool left_exhausted_{false};
+  /** A left tuple that did not fit into the previous block, it starts the next one */
+  Tuple pending_tuple_;
+  /** Whether `pending_tuple_` holds a tuple */
+  bool has_pending_tuple_{false};
+  /** The current right tuple */
+  Tuple right_tuple_;
+  /** Whether `right_tuple_` is being joined with the block */
+  bool has_right_tuple_{false};
+  /** The next block tuple to be joined with `right_tuple_` */
+  size_t block_cursor_{0};
+  /** The next block tuple to be checked for a missing match once the right side is exhausted */
+  size_t unmatched_cursor_{0};
 };
 
 }  // namespace bustub
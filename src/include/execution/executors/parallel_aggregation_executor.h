@@ -0,0 +1,114 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_aggregation_executor.h
+//
+// Identification: src/include/execution/executors/parallel_aggregation_executor.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "common/task_scheduler.h"
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/executors/aggregation_executor.h"
+#include "execution/morsel.h"
+#include "execution/pipeline.h"
+#include "execution/plans/aggregation_plan.h"
+#include "storage/table/spill_file.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * ParallelAggregationExecutor runs an aggregation over a parallelizable pipeline in two phases.
+ *
+ * In the first phase, one task per worker pulls morsels of the input and pre-aggregates them into task-local hash
+ * tables, one per radix partition of the group key hash. A task whose tables outgrow its share of the operator's
+ * memory budget spills the input tuples of new groups to task-local partition files instead. In the second
+ * phase, every partition is finalized by its own task, which merges the partial tables of all tasks and aggregates the
+ * spilled tuples of the partition within its share of the budget, spilling them again as a SpillingAggregation does.
+ * No phase takes a lock on shared state.
+ */
+class ParallelAggregationExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new ParallelAggregationExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The aggregation plan to be executed, its child must be parallelizable
+   */
+  ParallelAggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan);
+
+  /** Initialize the aggregation, running both phases */
+  void Init() override;
+
+  /**
+   * Yield the next group.
+   * @param[out] tuple The next tuple produced by the aggregation
+   * @param[out] rid The next tuple RID produced by the aggregation
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto Next(Tuple *tuple, RID *rid) -> bool override;
+
+  /** @return The output schema for the aggregation */
+  auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
+
+ private:
+  /** The number of hash bits used to partition groups between the finalizing tasks */
+  static constexpr size_t RADIX_BITS = 5;
+  static constexpr size_t NUM_PARTITIONS = 1 << RADIX_BITS;
+  /** The partition bits lie above the hash bits that a finalizing task uses to spill its partition */
+  static constexpr size_t PARTITION_SHIFT = SpillingAggregation::RADIX_BITS * SpillingAggregation::MAX_PARTITION_DEPTH;
+
+  /** The state owned by one pre-aggregating task */
+  struct LocalState {
+    std::vector<AggregationHashTable> tables_;
+    std::vector<std::unique_ptr<SpillFile>> spill_files_;
+    size_t memory_usage_{0};
+    /** The memory reserved for `tables_`, one reservation per task so that tasks never share one */
+    std::unique_ptr<MemoryReservation> memory_;
+  };
+
+  /** @return the partition of a group key hash */
+  static auto PartitionOf(hash_t hash) -> size_t { return (hash >> PARTITION_SHIFT) & (NUM_PARTITIONS - 1); }
+
+  /** @return a hash table for the aggregation of this executor */
+  auto MakeTable() const -> AggregationHashTable {
+    return AggregationHashTable(plan_->GetGroupBys(), plan_->GetAggregates(), plan_->GetAggregateTypes());
+  }
+
+  /** Pre-aggregate morsels into a task-local state until no morsel is left */
+  void PreAggregate(LocalState *local, size_t memory_limit);
+
+  /** Merge the partials and aggregate the spilled tuples of all tasks for one partition */
+  void Finalize(size_t partition);
+
+  /** The aggregation plan node */
+  const AggregationPlanNode *plan_;
+  /** The input of the aggregation */
+  Pipeline pipeline_;
+  /** The morsels of the input */
+  std::vector<Morsel> morsels_;
+  /** The next morsel to be pre-aggregated */
+  std::atomic<size_t> next_morsel_{0};
+  /** The state of every pre-aggregating task */
+  std::vector<LocalState> locals_;
+  /** The final groups of every partition, each reserving its own memory */
+  std::vector<SpillingAggregation> partitions_;
+  /** Holds no memory itself, it tells the budget that the tables of both phases share */
+  std::unique_ptr<MemoryReservation> memory_;
+  /** The partition being emitted */
+  size_t partition_cursor_{0};
+  /** The next group of the partition being emitted */
+  size_t group_cursor_{0};
+};
+
+}  // namespace bustub
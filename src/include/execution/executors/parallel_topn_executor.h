@@ -0,0 +1,88 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_topn_executor.h
+//
+// Identification: src/include/execution/executors/parallel_topn_executor.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "common/task_scheduler.h"
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/executors/topn_executor.h"
+#include "execution/morsel.h"
+#include "execution/pipeline.h"
+#include "execution/plans/topn_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * ParallelTopNExecutor runs a top N over a parallelizable pipeline.
+ *
+ * One task per worker pulls morsels of the input into a task-local TopNHeap. Once a local heap is full, its top is a
+ * bound: n tuples sort no later than it, so no tuple sorting after it can be in the result. The tightest bound of all
+ * tasks is shared, and every task drops tuples that do not sort before it with a single comparison, usually long
+ * before its own heap is full. The local heaps are merged when all morsels are done.
+ */
+class ParallelTopNExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new ParallelTopNExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The topn plan to be executed, its child must be parallelizable
+   */
+  ParallelTopNExecutor(ExecutorContext *exec_ctx, const TopNPlanNode *plan);
+
+  /** Initialize the topn, reading the whole input */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from the topn.
+   * @param[out] tuple The next tuple produced by the topn
+   * @param[out] rid The next tuple RID produced by the topn
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto Next(Tuple *tuple, RID *rid) -> bool override;
+
+  /** @return The output schema for the topn */
+  auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
+
+ private:
+  /** Collect the first n tuples of morsels into a task-local heap until no morsel is left */
+  void Collect(TopNHeap *local);
+
+  /** The topn plan node to be executed */
+  const TopNPlanNode *plan_;
+  /** The input of the topn */
+  Pipeline pipeline_;
+  /** The morsels of the input */
+  std::vector<Morsel> morsels_;
+  /** The next morsel to be read */
+  std::atomic<size_t> next_morsel_{0};
+  /** Guards the shared bound */
+  std::mutex bound_mutex_;
+  /** The keys of the tightest top of a full local heap, empty while no local heap is full */
+  std::vector<Value> bound_;
+  /** Incremented whenever the bound changes, so that tasks only take the lock to pick up a new bound */
+  std::atomic<size_t> bound_version_{0};
+  /** The memory held by the heaps */
+  std::unique_ptr<MemoryReservation> memory_;
+  /** The first n tuples in sort order */
+  std::vector<TopNHeap::Entry> entries_;
+  /** The position of the next tuple to produce */
+  size_t cursor_{0};
+};
+
+}  // namespace bustub
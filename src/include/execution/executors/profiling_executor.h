@@ -0,0 +1,68 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// profiling_executor.h
+//
+// Identification: src/include/execution/executors/profiling_executor.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <utility>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/query_profile.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * The ProfilingExecutor wraps another executor and records its time, output rows and page traffic for EXPLAIN
+ * ANALYZE. The executor factory only adds it when the query is profiled, so normal queries do not pay for the clock
+ * reads. Pages are counted on the calling thread, so work that an executor hands to other threads is not included.
+ */
+class ProfilingExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new ProfilingExecutor instance.
+   * @param exec_ctx The executor context
+   * @param executor The executor to profile
+   * @param profile Where to add up the figures of `executor`
+   */
+  ProfilingExecutor(ExecutorContext *exec_ctx, std::unique_ptr<AbstractExecutor> &&executor, ExecutorProfile *profile)
+      : AbstractExecutor(exec_ctx), executor_(std::move(executor)), profile_(profile) {}
+
+  /** Initialize the wrapped executor */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from the wrapped executor.
+   * @param[out] tuple The next tuple produced by the wrapped executor
+   * @param[out] rid The next tuple RID produced by the wrapped executor
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto Next(Tuple *tuple, RID *rid) -> bool override;
+
+  /** @return The output schema of the wrapped executor */
+  auto GetOutputSchema() const -> const Schema & override { return executor_->GetOutputSchema(); }
+
+  /** Profiling is transparent to runtime filters */
+  auto AddRuntimeFilter(RuntimeFilterRef filter) -> bool override {
+    return executor_->AddRuntimeFilter(std::move(filter));
+  }
+
+ private:
+  /** The executor being profiled */
+  std::unique_ptr<AbstractExecutor> executor_;
+
+  /** The figures of the executor */
+  ExecutorProfile *profile_;
+};
+
+}  // namespace bustub
@@ -12,10 +12,13 @@
 
 #pragma once
 
+#include <optional>
+#include <utility>
 #include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/morsel.h"
 #include "execution/plans/seq_scan_plan.h"
 #include "storage/table/tuple.h"
 
@@ -33,6 +36,14 @@ class SeqScanExecutor : public AbstractExecutor {
    */
   SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan);
 
+  /**
+   * Construct a new SeqScanExecutor instance that only scans the pages of one morsel.
+   * @param exec_ctx The executor context
+   * @param plan The sequential scan plan to be executed
+   * @param morsel The pages to be scanned
+   */
+  SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan, Morsel morsel);
+
   /** Initialize the sequential scan */
   void Init() override;
 
@@ -47,12 +58,31 @@ class SeqScanExecutor : public AbstractExecutor {
   /** @return The output schema for the sequential scan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
+  /** Runtime filters are applied right after the scan predicate */
+  auto AddRuntimeFilter(RuntimeFilterRef filter) -> bool override {
+    runtime_filters_.push_back(std::move(filter));
+    return true;
+  }
+
  private:
   /** The sequential scan plan node to be executed */
   const SeqScanPlanNode *plan_;
-  /** Iterator over the tuples of the underlying table */
-  TableIterator table_iterator_ = {nullptr, RID(), nullptr};
+  /** Read the next page of the scan into the buffer, return `false` if there are no more pages */
+  auto FetchNextPage() -> bool;
+
   /** The table to scan */
   TableInfo *table_info_;
+  /** The pages to scan, if this scan is restricted to a morsel */
+  std::optional<Morsel> morsel_;
+  /** The next page to scan when following the page chain */
+  page_id_t next_page_id_{INVALID_PAGE_ID};
+  /** The position of the next page to scan within the morsel */
+  size_t next_morsel_page_{0};
+  /** The live tuples of the current page; reading a page at a time keeps the page latched only once */
+  std::vector<std::pair<Tuple, RID>> page_tuples_;
+  /** The position of the next tuple within `page_tuples_` */
+  size_t page_cursor_{0};
+  /** Runtime filters pushed down by joins above this scan */
+  std::vector<RuntimeFilterRef> runtime_filters_;
 };
 }  // namespace bustub
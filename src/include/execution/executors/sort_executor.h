@@ -13,18 +13,31 @@
 #pragma once
 
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/loser_tree.h"
 #include "execution/plans/seq_scan_plan.h"
 #include "execution/plans/sort_plan.h"
+#include "storage/table/spill_file.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
- * The SortExecutor executor executes a sort.
+ * The SortExecutor executes an external merge sort.
+ *
+ * Input tuples are buffered until the buffer goes over the memory budget of the operator, then the buffer is sorted
+ * and written out to a spill file as a sorted run. Once the input is exhausted, the runs are merged with a loser tree;
+ * the last run never leaves memory. If there are more runs than the memory budget can read from at once, groups of
+ * runs are merged into longer runs first. Every run is read back a page at a time, so each merge input only holds
+ * one page.
+ *
+ * The first ORDER BY key of every tuple is also encoded into a 64-bit prefix that orders like the key itself, so most
+ * comparisons are a single integer comparison. Buffers are sorted by radix sorting (prefix, position) pairs, and only
+ * tuples with equal prefixes are compared on their full keys.
  */
 class SortExecutor : public AbstractExecutor {
  public:
@@ -50,7 +63,77 @@ class SortExecutor : public AbstractExecutor {
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
  private:
+  /** Merge at most this many runs at once, regardless of the memory budget */
+  static constexpr size_t MAX_MERGE_FAN_IN = 64;
+
+  /** Buffers smaller than this are sorted by comparison rather than radix sorted */
+  static constexpr size_t RADIX_SORT_THRESHOLD = 256;
+
+  /** A tuple together with its evaluated ORDER BY keys */
+  struct SortEntry {
+    std::vector<Value> keys_;
+    /** The first key normalized, entries with different prefixes are ordered by them */
+    uint64_t prefix_{0};
+    Tuple tuple_;
+  };
+
+  /** The prefix of a buffered entry and its position in the buffer */
+  using SortKey = std::pair<uint64_t, uint32_t>;
+
+  /** A sorted run taking part in a merge, either a spill file or the in-memory buffer */
+  struct Run {
+    std::unique_ptr<SpillFile> file_;
+    std::vector<SortEntry> entries_;
+    /** The position of the next entry within `entries_` */
+    size_t cursor_{0};
+    /** The smallest entry of the run that has not been merged yet */
+    SortEntry head_;
+    bool exhausted_{false};
+  };
+
+  /** @return the entry of a tuple with its keys evaluated */
+  auto MakeEntry(Tuple tuple) const -> SortEntry;
+
+  /** @return whether `lhs` sorts before `rhs` */
+  auto EntryLess(const SortEntry &lhs, const SortEntry &rhs) const -> bool;
+
+  /** Sort pairs by their prefix with an LSD radix sort, pairs with equal prefixes keep their order */
+  static void RadixSort(std::vector<SortKey> *keys);
+
+  /** Sort the buffered tuples in place */
+  void SortBuffer();
+
+  /** Sort the buffered tuples and write them to a new run */
+  void SpillBuffer();
+
+  /** Load the next head of a run */
+  void AdvanceRun(Run *run);
+
+  /** Start merging the given runs */
+  void StartMerge(std::vector<Run> runs);
+
+  /** Pop the smallest entry of the current merge, return `false` if all runs are exhausted */
+  auto NextMerged(SortEntry *entry) -> bool;
+
   /** The sort plan node to be executed */
   const SortPlanNode *plan_;
+  /** The child executor producing the tuples to sort */
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  /** Whether equal prefixes mean equal first keys, so that ties are broken on the remaining keys only */
+  bool prefix_exact_;
+
+  /** Input tuples that have not been written to a run yet */
+  std::vector<SortEntry> buffer_;
+  /** The bytes held by `buffer_` */
+  size_t buffer_memory_{0};
+  /** The memory reserved for `buffer_`, kept while the last run is merged from memory */
+  std::unique_ptr<MemoryReservation> memory_;
+  /** The runs written so far, oldest first */
+  std::vector<std::unique_ptr<SpillFile>> spilled_runs_;
+
+  /** The runs of the current merge */
+  std::vector<Run> merge_runs_;
+  /** Picks the run holding the next entry of the current merge */
+  std::unique_ptr<LoserTree> merge_tree_;
 };
 }  // namespace bustub
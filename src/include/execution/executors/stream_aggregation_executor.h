@@ -0,0 +1,79 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// stream_aggregation_executor.h
+//
+// Identification: src/include/execution/executors/stream_aggregation_executor.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <utility>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/executors/aggregation_executor.h"
+#include "execution/plans/stream_aggregation_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * StreamAggregationExecutor aggregates an input on which the rows of every group are adjacent.
+ *
+ * The current group is the only group of an AggregationHashTable. A row whose key is not found there starts the next
+ * group, so the current one is emitted and the table is reset for reuse. Memory does not depend on the number of
+ * groups, and every group is produced as soon as its last row has been read.
+ */
+class StreamAggregationExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new StreamAggregationExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The stream aggregation plan to be executed
+   * @param child The child executor, producing the rows of every group next to each other
+   */
+  StreamAggregationExecutor(ExecutorContext *exec_ctx, const StreamAggregationPlanNode *plan,
+                            std::unique_ptr<AbstractExecutor> &&child);
+
+  /** Initialize the aggregation */
+  void Init() override;
+
+  /**
+   * Yield the next group.
+   * @param[out] tuple The group-by keys followed by the aggregates of the next group
+   * @param[out] rid Unused
+   * @return `true` if a group was produced, `false` if there are no more groups
+   */
+  auto Next(Tuple *tuple, RID *rid) -> bool override;
+
+  /** @return The output schema for the aggregation */
+  auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
+
+ private:
+  /** Produce the current group and drop it from the table */
+  void EmitGroup(Tuple *tuple, RID *rid);
+
+  /** The stream aggregation plan node */
+  const StreamAggregationPlanNode *plan_;
+  /** The child executor that produces tuples over which the aggregation is computed */
+  std::unique_ptr<AbstractExecutor> child_;
+  /** The table holding the current group */
+  AggregationHashTable aht_;
+  /** The input row read last, not yet folded into a group if `has_pending_` is set */
+  Tuple pending_;
+  /** The key of the pending row */
+  AggregationHashTable::GroupKey pending_key_;
+  bool has_pending_{false};
+  /** Whether the input is exhausted */
+  bool input_done_{false};
+  /** Whether a group was produced */
+  bool emitted_{false};
+};
+
+}  // namespace bustub
@@ -13,18 +13,83 @@
 #pragma once
 
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/memory_context.h"
 #include "execution/plans/seq_scan_plan.h"
 #include "execution/plans/topn_plan.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
+/**
+ * A bounded max-heap keeping the first n tuples in the order of a top N, so the heap top is the tuple to drop next. A
+ * tuple that does not sort before the heap top is dropped after a single comparison. Nulls sort first in ascending
+ * order, as in the sort executor.
+ */
+class TopNHeap {
+ public:
+  /** A tuple together with its evaluated ORDER BY keys */
+  struct Entry {
+    std::vector<Value> keys_;
+    Tuple tuple_;
+  };
+
+  /**
+   * Construct a new TopNHeap instance.
+   * @param order_bys the order of the top N
+   * @param n the number of tuples to keep
+   */
+  TopNHeap(const std::vector<std::pair<OrderByType, AbstractExpressionRef>> &order_bys, size_t n)
+      : order_bys_(order_bys), n_(n) {}
+
+  /** @return the ORDER BY keys of a tuple */
+  auto MakeKeys(const Tuple &tuple, const Schema &schema) const -> std::vector<Value>;
+
+  /** @return whether the keys `lhs` sort before the keys `rhs` */
+  auto KeysLess(const std::vector<Value> &lhs, const std::vector<Value> &rhs) const -> bool;
+
+  /**
+   * Offer a tuple to the heap.
+   * @return whether the tuple is kept, it is left untouched otherwise
+   */
+  auto Push(std::vector<Value> &&keys, Tuple &&tuple) -> bool;
+
+  /** @return whether the heap holds n tuples, so that only tuples sorting before its top get in */
+  auto IsFull() const -> bool { return n_ > 0 && entries_.size() == n_; }
+
+  /** @return the keys of the last of the tuples kept, the heap must not be empty */
+  auto Top() const -> const std::vector<Value> & { return entries_.front().keys_; }
+
+  /** Offer all tuples of another heap over the same order to this one */
+  void MergeFrom(TopNHeap &&other);
+
+  /** @return the tuples kept in sort order, leaving the heap empty */
+  auto Finish() -> std::vector<Entry>;
+
+  /** Drop all tuples */
+  void Clear();
+
+  /** @return the number of bytes held by the heap */
+  auto GetMemoryUsage() const -> size_t {
+    return tuple_bytes_ + entries_.capacity() * sizeof(Entry) + entries_.size() * order_bys_.size() * sizeof(Value);
+  }
+
+ private:
+  const std::vector<std::pair<OrderByType, AbstractExpressionRef>> &order_bys_;
+  size_t n_;
+  std::vector<Entry> entries_;
+  /** The bytes of the tuples kept */
+  size_t tuple_bytes_{0};
+};
+
 /**
  * The TopNExecutor executor executes a topn.
+ *
+ * The first n tuples in sort order are kept in a TopNHeap while the input is read.
  */
 class TopNExecutor : public AbstractExecutor {
  public:
@@ -52,5 +117,15 @@ class TopNExecutor : public AbstractExecutor {
  private:
   /** The topn plan node to be executed */
   const TopNPlanNode *plan_;
+  /** The child executor from which tuples are obtained */
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  /** The memory held by the heap */
+  std::unique_ptr<MemoryReservation> memory_;
+  /** The first n tuples while reading the input */
+  TopNHeap heap_;
+  /** The first n tuples in sort order */
+  std::vector<TopNHeap::Entry> entries_;
+  /** The position of the next tuple to produce */
+  size_t cursor_{0};
 };
 }  // namespace bustub
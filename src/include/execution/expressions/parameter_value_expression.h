@@ -0,0 +1,58 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parameter_value_expression.h
+//
+// Identification: src/include/execution/expressions/parameter_value_expression.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/abstract_expression.h"
+#include "fmt/format.h"
+
+namespace bustub {
+
+/**
+ * ParameterValueExpression represents a parameter of a prepared statement, e.g. `$1`. Its value is read from the
+ * parameters bound when the plan runs, so that one plan serves every EXECUTE of the statement. The optimizer does not
+ * treat it as a constant.
+ */
+class ParameterValueExpression : public AbstractExpression {
+ public:
+  /**
+   * Creates a new parameter value expression.
+   * @param index the zero-based position of the parameter, `$1` is 0
+   * @param ret_type the type of the values bound to the parameter
+   * @param parameters the values bound to the parameters of the statement
+   */
+  ParameterValueExpression(size_t index, TypeId ret_type, std::shared_ptr<const std::vector<Value>> parameters)
+      : AbstractExpression({}, ret_type), index_(index), parameters_(std::move(parameters)) {}
+
+  auto Evaluate(const Tuple *tuple, const Schema &schema) const -> Value override { return (*parameters_)[index_]; }
+
+  auto EvaluateJoin(const Tuple *left_tuple, const Schema &left_schema, const Tuple *right_tuple,
+                    const Schema &right_schema) const -> Value override {
+    return (*parameters_)[index_];
+  }
+
+  /** @return the string representation of the plan node and its children */
+  auto ToString() const -> std::string override { return fmt::format("${}", index_ + 1); }
+
+  BUSTUB_EXPR_CLONE_WITH_CHILDREN(ParameterValueExpression);
+
+  /** The zero-based position of the parameter */
+  size_t index_;
+
+  /** The values bound to the parameters of the statement */
+  std::shared_ptr<const std::vector<Value>> parameters_;
+};
+
+}  // namespace bustub
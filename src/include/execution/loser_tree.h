@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// loser_tree.h
+//
+// Identification: src/include/execution/loser_tree.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace bustub {
+
+/**
+ * LoserTree picks the stream with the smallest head among k sorted streams, for k-way merging.
+ *
+ * Streams are the leaves of a complete binary tree, and every internal node remembers the loser of the match played
+ * there. After the head of the winning stream changes, only the matches on the path from its leaf to the root are
+ * replayed, which takes log2(k) comparisons, about half of what sifting down a binary heap costs.
+ */
+class LoserTree {
+ public:
+  /**
+   * Returns whether the head of stream `a` sorts before the head of stream `b`. Exhausted streams must sort after all
+   * others, and ties should be broken on the stream index to keep the merge stable.
+   */
+  using Less = std::function<bool(size_t a, size_t b)>;
+
+  /**
+   * Build the tree by playing all matches.
+   * @param num_streams the number of streams to merge, at least one
+   * @param less the comparison of stream heads
+   */
+  LoserTree(size_t num_streams, Less less) : num_streams_(num_streams), nodes_(num_streams, 0), less_(std::move(less)) {
+    // winners[i] is the winner of the subtree rooted at internal node i, nodes i >= k are the streams themselves.
+    std::vector<size_t> winners(num_streams_, 0);
+    auto winner_of = [&](size_t node) { return node >= num_streams_ ? node - num_streams_ : winners[node]; };
+    for (auto node = num_streams_ - 1; node > 0; node--) {
+      auto left = winner_of(2 * node);
+      auto right = winner_of(2 * node + 1);
+      if (less_(right, left)) {
+        std::swap(left, right);
+      }
+      winners[node] = left;
+      nodes_[node] = right;
+    }
+    nodes_[0] = num_streams_ > 1 ? winners[1] : 0;
+  }
+
+  /** @return the stream with the smallest head */
+  auto Top() const -> size_t { return nodes_[0]; }
+
+  /** Restore the tree after the head of the Top() stream has changed */
+  void Replay() {
+    auto winner = nodes_[0];
+    for (auto node = (winner + num_streams_) / 2; node > 0; node /= 2) {
+      if (less_(nodes_[node], winner)) {
+        std::swap(nodes_[node], winner);
+      }
+    }
+    nodes_[0] = winner;
+  }
+
+ private:
+  size_t num_streams_;
+  /** The overall winner at index 0, the loser of each internal node at indexes [1, k) */
+  std::vector<size_t> nodes_;
+  Less less_;
+};
+
+}  // namespace bustub
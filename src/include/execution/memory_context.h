@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// memory_context.h
+//
+// Identification: src/include/execution/memory_context.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+class MemoryContext;
+
+/**
+ * The memory held by one operator, charged against the budget of the query it belongs to.
+ *
+ * Operators report how many bytes they buffer through Resize(). A reservation is within budget while it holds at
+ * most `operator_memory_limit` bytes and the whole query stays within its MemoryContext limit. An operator whose
+ * reservation goes over budget is expected to spill and shrink it again.
+ */
+class MemoryReservation {
+ public:
+  explicit MemoryReservation(MemoryContext *context) : context_(context) {}
+
+  ~MemoryReservation() { Resize(0); }
+
+  DISALLOW_COPY_AND_MOVE(MemoryReservation);
+
+  /**
+   * Set the number of bytes held by the operator. The reservation always takes the new size, even over budget.
+   * @return `true` if the reservation is within budget, `false` if the operator should spill
+   */
+  auto Resize(size_t bytes) -> bool;
+
+  /** @return the number of bytes this reservation may grow to without going over budget */
+  auto GetBudget() const -> size_t;
+
+  /** @return the number of bytes held by the operator */
+  auto GetBytes() const -> size_t { return bytes_; }
+
+  /** @return the largest number of bytes the operator has held */
+  auto GetPeakBytes() const -> size_t { return peak_bytes_; }
+
+ private:
+  MemoryContext *context_;
+  size_t bytes_{0};
+  size_t peak_bytes_{0};
+};
+
+/**
+ * MemoryContext tracks the memory held by the operators of one query against the query's memory limit.
+ */
+class MemoryContext {
+ public:
+  /** @param limit The number of bytes all operators of the query may hold together */
+  explicit MemoryContext(size_t limit) : limit_(limit) {}
+
+  DISALLOW_COPY_AND_MOVE(MemoryContext);
+
+  /** @return a new, empty reservation for an operator of this query */
+  auto MakeReservation() -> std::unique_ptr<MemoryReservation> { return std::make_unique<MemoryReservation>(this); }
+
+  /** @return the number of bytes all operators of the query may hold together */
+  auto GetLimit() const -> size_t { return limit_; }
+
+  /** @return the number of bytes held by all operators of the query */
+  auto GetUsage() const -> size_t { return usage_; }
+
+  /** @return the largest number of bytes the operators of the query have held together */
+  auto GetPeakUsage() const -> size_t { return peak_usage_; }
+
+ private:
+  friend class MemoryReservation;
+
+  /** Account for a reservation changing from `old_bytes` to `new_bytes` */
+  void Update(size_t old_bytes, size_t new_bytes);
+
+  size_t limit_;
+  std::atomic<size_t> usage_{0};
+  std::atomic<size_t> peak_usage_{0};
+};
+
+}  // namespace bustub
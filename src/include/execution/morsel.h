@@ -0,0 +1,34 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// morsel.h
+//
+// Identification: src/include/execution/morsel.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * A Morsel is a small slice of a scan's input that is processed by a single task of a parallel pipeline. Table
+ * scans are split into runs of consecutive heap pages, mock scans into ranges of row indices.
+ */
+struct Morsel {
+  /** The table heap pages covered by this morsel, in page chain order */
+  std::vector<page_id_t> page_ids_;
+  /** The first mock table row covered by this morsel */
+  size_t begin_{0};
+  /** One past the last mock table row covered by this morsel */
+  size_t end_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,68 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pipeline.h
+//
+// Identification: src/include/execution/pipeline.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/morsel.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/**
+ * A Pipeline is a chain of non-blocking plan nodes (filters and projections) on top of a scan. Its input can be split
+ * into morsels, and every morsel can be pushed through its own copy of the pipeline's executors on any worker.
+ */
+class Pipeline {
+ public:
+  /**
+   * Construct a new Pipeline.
+   * @param exec_ctx The executor context
+   * @param plan The topmost plan node of the pipeline, which must be parallelizable
+   */
+  Pipeline(ExecutorContext *exec_ctx, AbstractPlanNodeRef plan);
+
+  /** @return `true` if the plan is a chain of filters and projections over a sequential or mock scan */
+  static auto IsParallelizable(const AbstractPlanNode &plan) -> bool;
+
+  /** @return `true` if the plan is parallelizable and the executor context allows more than one worker */
+  static auto ShouldRunParallel(ExecutorContext *exec_ctx, const AbstractPlanNode &plan) -> bool;
+
+  /** @return The morsels covering the whole input of the pipeline */
+  auto MakeMorsels() const -> std::vector<Morsel>;
+
+  /**
+   * Create the executors of the pipeline restricted to a single morsel. The executors are not initialized.
+   * @param morsel The part of the input to be processed
+   * @return The executor of the topmost plan node
+   */
+  auto MakeExecutor(const Morsel &morsel) const -> std::unique_ptr<AbstractExecutor>;
+
+  /** @return The topmost plan node of the pipeline */
+  auto GetPlan() const -> const AbstractPlanNodeRef & { return plan_; }
+
+ private:
+  auto MakeExecutor(const AbstractPlanNodeRef &plan, const Morsel &morsel) const -> std::unique_ptr<AbstractExecutor>;
+
+  /** The executor context the pipeline runs in */
+  ExecutorContext *exec_ctx_;
+  /** The topmost plan node of the pipeline */
+  AbstractPlanNodeRef plan_;
+  /** The scan at the bottom of the pipeline */
+  const AbstractPlanNode *source_;
+};
+
+}  // namespace bustub
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <utility>
@@ -34,14 +35,17 @@ namespace bustub {
 enum class PlanType {
   SeqScan,
   IndexScan,
+  BitmapHeapScan,
   Insert,
   Update,
   Delete,
   Aggregation,
+  StreamAggregation,
   Limit,
   NestedLoopJoin,
   NestedIndexJoin,
   HashJoin,
+  MergeJoin,
   Filter,
   Values,
   Projection,
@@ -92,6 +96,12 @@ class AbstractPlanNode {
     return fmt::format("{}{}", PlanNodeToString(), ChildrenToString(2, with_schema));
   }
 
+  /**
+   * @param annotate Produces the text appended to the line of every plan node, e.g. its runtime figures
+   * @return the string representation of the plan node and its children, without schemas
+   */
+  auto ToString(const std::function<std::string(const AbstractPlanNode &)> &annotate) const -> std::string;
+
   /** @return the cloned plan node with new children */
   virtual auto CloneWithChildren(std::vector<AbstractPlanNodeRef> children) const
       -> std::unique_ptr<AbstractPlanNode> = 0;
@@ -75,6 +75,9 @@ class AggregationPlanNode : public AbstractPlanNode {
   /** @return The aggregate types */
   auto GetAggregateTypes() const -> const std::vector<AggregationType> & { return agg_types_; }
 
+  /** @return the type of an aggregate, VARCHAR for MIN and MAX over strings and INTEGER otherwise */
+  static auto InferAggType(AggregationType agg_type, const AbstractExpressionRef &aggregate) -> TypeId;
+
   static auto InferAggSchema(const std::vector<AbstractExpressionRef> &group_bys,
                              const std::vector<AbstractExpressionRef> &aggregates,
                              const std::vector<AggregationType> &agg_types) -> Schema;
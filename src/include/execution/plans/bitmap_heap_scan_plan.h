@@ -0,0 +1,128 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bitmap_heap_scan_plan.h
+//
+// Identification: src/include/execution/plans/bitmap_heap_scan_plan.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * The keys looked up in one index by a bitmap heap scan. The RIDs found for any of the keys are a match. A lookup
+ * without keys is a range lookup, every key between its bounds is a match.
+ */
+struct BitmapIndexLookup {
+  /** The index to probe */
+  index_oid_t index_oid_;
+  /** The index name, for display only */
+  std::string index_name_;
+  /** The keys to look up, constants or parameters, empty for a range lookup */
+  std::vector<AbstractExpressionRef> keys_;
+  /** The smallest key of a range lookup, from the first key if not set */
+  std::optional<IndexScanBound> lower_;
+  /** The largest key of a range lookup, up to the last key if not set */
+  std::optional<IndexScanBound> upper_;
+
+  /** @return whether the lookup reads a range of keys */
+  auto IsRange() const -> bool { return keys_.empty(); }
+};
+
+/**
+ * The BitmapHeapScanPlanNode scans the tuples of a table whose RIDs are found by one or more index lookups.
+ *
+ * The RIDs of all lookups are collected and combined first, intersected for `and` and merged for `or`. The heap is
+ * then read in RID order, so every table page is fetched at most once regardless of the order of the keys in the
+ * index. The output is not ordered on any index key, a range that has to be read in key order is left to an index scan.
+ */
+class BitmapHeapScanPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Construct a new BitmapHeapScanPlanNode instance.
+   * @param output The output schema of the scan, the schema of the table
+   * @param table_oid The identifier of the table to be scanned
+   * @param table_name The table name
+   * @param lookups The index lookups producing the RIDs to read, at least one
+   * @param combine_type How the RIDs of multiple lookups are combined
+   * @param filter_predicate The predicate every tuple read is checked against, may be `nullptr`
+   */
+  BitmapHeapScanPlanNode(SchemaRef output, table_oid_t table_oid, std::string table_name,
+                         std::vector<BitmapIndexLookup> lookups, LogicType combine_type,
+                         AbstractExpressionRef filter_predicate)
+      : AbstractPlanNode(std::move(output), {}),
+        table_oid_(table_oid),
+        table_name_(std::move(table_name)),
+        lookups_(std::move(lookups)),
+        combine_type_(combine_type),
+        filter_predicate_(std::move(filter_predicate)) {}
+
+  /** @return The type of the plan node */
+  auto GetType() const -> PlanType override { return PlanType::BitmapHeapScan; }
+
+  /** @return The identifier of the table that should be scanned */
+  auto GetTableOid() const -> table_oid_t { return table_oid_; }
+
+  /** @return The index lookups producing the RIDs to read */
+  auto GetLookups() const -> const std::vector<BitmapIndexLookup> & { return lookups_; }
+
+  /** @return How the RIDs of multiple lookups are combined */
+  auto GetCombineType() const -> LogicType { return combine_type_; }
+
+  BUSTUB_PLAN_NODE_CLONE_WITH_CHILDREN(BitmapHeapScanPlanNode);
+
+  /** The table whose tuples should be scanned */
+  table_oid_t table_oid_;
+
+  /** The table name */
+  std::string table_name_;
+
+  /** The index lookups producing the RIDs to read */
+  std::vector<BitmapIndexLookup> lookups_;
+
+  /** How the RIDs of multiple lookups are combined */
+  LogicType combine_type_;
+
+  /** The predicate every tuple read is checked against. The lookups may match more tuples than it does. */
+  AbstractExpressionRef filter_predicate_;
+
+ protected:
+  auto PlanNodeToString() const -> std::string override {
+    std::vector<std::string> lookups;
+    for (const auto &lookup : lookups_) {
+      if (lookup.IsRange()) {
+        lookups.push_back(fmt::format("{}={}", lookup.index_name_, IndexRangeToString(lookup.lower_, lookup.upper_)));
+        continue;
+      }
+      std::vector<std::string> keys;
+      for (const auto &key : lookup.keys_) {
+        keys.push_back(key->ToString());
+      }
+      lookups.push_back(fmt::format("{}=({})", lookup.index_name_, fmt::join(keys, ", ")));
+    }
+    if (filter_predicate_) {
+      return fmt::format("BitmapHeapScan {{ table={}, {}=[{}], filter={} }}", table_name_, combine_type_,
+                         fmt::join(lookups, ", "), filter_predicate_);
+    }
+    return fmt::format("BitmapHeapScan {{ table={}, {}=[{}] }}", table_name_, combine_type_, fmt::join(lookups, ", "));
+  }
+};
+
+}  // namespace bustub
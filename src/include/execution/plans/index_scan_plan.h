@@ -12,16 +12,37 @@
 
 #pragma once
 
+#include <optional>
 #include <string>
 #include <utility>
 
 #include "catalog/catalog.h"
 #include "execution/expressions/abstract_expression.h"
 #include "execution/plans/abstract_plan.h"
+#include "type/value.h"
 
 namespace bustub {
+
+/** One end of the range of keys an index scan reads */
+struct IndexScanBound {
+  /** The key at the end of the range */
+  Value key_;
+  /** Whether the key itself is in the range */
+  bool inclusive_;
+};
+
+/** @return a range of keys in interval notation, e.g. `[1, 10)` */
+inline auto IndexRangeToString(const std::optional<IndexScanBound> &lower, const std::optional<IndexScanBound> &upper)
+    -> std::string {
+  return fmt::format("{}{}, {}{}", lower.has_value() && lower->inclusive_ ? "[" : "(",
+                     lower.has_value() ? lower->key_.ToString() : "-inf",
+                     upper.has_value() ? upper->key_.ToString() : "+inf",
+                     upper.has_value() && upper->inclusive_ ? "]" : ")");
+}
+
 /**
- * IndexScanPlanNode identifies a table that should be scanned with an optional predicate.
+ * IndexScanPlanNode identifies a table that should be scanned in the order of an index, optionally only the tuples
+ * whose key is within a range.
  */
 class IndexScanPlanNode : public AbstractPlanNode {
  public:
@@ -33,6 +54,20 @@ class IndexScanPlanNode : public AbstractPlanNode {
   IndexScanPlanNode(SchemaRef output, index_oid_t index_oid)
       : AbstractPlanNode(std::move(output), {}), index_oid_(index_oid) {}
 
+  /**
+   * Creates a new index scan plan node reading a range of keys.
+   * @param output the output format of this scan plan node
+   * @param index_oid the identifier of the index to scan
+   * @param lower the smallest key to read, from the first key if not set
+   * @param upper the largest key to read, up to the last key if not set
+   */
+  IndexScanPlanNode(SchemaRef output, index_oid_t index_oid, std::optional<IndexScanBound> lower,
+                    std::optional<IndexScanBound> upper)
+      : AbstractPlanNode(std::move(output), {}),
+        index_oid_(index_oid),
+        lower_(std::move(lower)),
+        upper_(std::move(upper)) {}
+
   auto GetType() const -> PlanType override { return PlanType::IndexScan; }
 
   /** @return the identifier of the table that should be scanned */
@@ -43,11 +78,18 @@ class IndexScanPlanNode : public AbstractPlanNode {
   /** The table whose tuples should be scanned. */
   index_oid_t index_oid_;
 
-  // Add anything you want here for index lookup
+  /** The smallest key to read, the scan starts at the first key if not set */
+  std::optional<IndexScanBound> lower_;
+
+  /** The largest key to read, the scan ends at the last key if not set */
+  std::optional<IndexScanBound> upper_;
 
  protected:
   auto PlanNodeToString() const -> std::string override {
-    return fmt::format("IndexScan {{ index_oid={} }}", index_oid_);
+    if (!lower_.has_value() && !upper_.has_value()) {
+      return fmt::format("IndexScan {{ index_oid={} }}", index_oid_);
+    }
+    return fmt::format("IndexScan {{ index_oid={}, range={} }}", index_oid_, IndexRangeToString(lower_, upper_));
   }
 };
 
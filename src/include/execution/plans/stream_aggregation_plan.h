@@ -0,0 +1,53 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// stream_aggregation_plan.h
+//
+// Identification: src/include/execution/plans/stream_aggregation_plan.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "execution/plans/aggregation_plan.h"
+
+namespace bustub {
+
+/**
+ * Stream aggregation computes the same groups as an aggregation over an input on which all rows of a group are
+ * adjacent, e.g. because it is sorted on the group by expressions. Only the current group is held, and it is emitted
+ * as soon as a row of the next group arrives. The output follows the order of the input.
+ */
+class StreamAggregationPlanNode : public AggregationPlanNode {
+ public:
+  /**
+   * Construct a new StreamAggregationPlanNode.
+   * @param output_schema The output format of this plan node
+   * @param child The child plan, producing the rows of every group next to each other
+   * @param group_bys The group by clause of the aggregation, not empty
+   * @param aggregates The expressions that we are aggregating
+   * @param agg_types The types that we are aggregating
+   */
+  StreamAggregationPlanNode(SchemaRef output_schema, AbstractPlanNodeRef child,
+                            std::vector<AbstractExpressionRef> group_bys, std::vector<AbstractExpressionRef> aggregates,
+                            std::vector<AggregationType> agg_types)
+      : AggregationPlanNode(std::move(output_schema), std::move(child), std::move(group_bys), std::move(aggregates),
+                            std::move(agg_types)) {}
+
+  /** @return The type of the plan node */
+  auto GetType() const -> PlanType override { return PlanType::StreamAggregation; }
+
+  BUSTUB_PLAN_NODE_CLONE_WITH_CHILDREN(StreamAggregationPlanNode);
+
+ protected:
+  auto PlanNodeToString() const -> std::string override;
+};
+
+}  // namespace bustub
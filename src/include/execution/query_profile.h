@@ -0,0 +1,48 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// query_profile.h
+//
+// Identification: src/include/execution/query_profile.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/**
+ * What one executor did while a query ran, as collected for EXPLAIN ANALYZE. All figures include the work of the
+ * executor's children, like the times reported by other databases.
+ */
+struct ExecutorProfile {
+  /** Nanoseconds spent in Init() */
+  uint64_t init_ns_{0};
+  /** Nanoseconds spent in Next() */
+  uint64_t next_ns_{0};
+  /** The number of tuples produced */
+  uint64_t rows_{0};
+  /** Pages requested from the buffer pool */
+  uint64_t pages_fetched_{0};
+  /** Requested pages that had to be read from disk */
+  uint64_t pages_missed_{0};
+  /** Bytes written to temporary pages */
+  uint64_t bytes_spilled_{0};
+
+  /** @return the figures in a compact form to append to the plan node */
+  auto ToString() const -> std::string;
+};
+
+/** The profiles of all executors of a query, by the plan node they execute */
+using QueryProfile = std::unordered_map<const AbstractPlanNode *, ExecutorProfile>;
+
+}  // namespace bustub
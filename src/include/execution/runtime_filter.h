@@ -0,0 +1,120 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// runtime_filter.h
+//
+// Identification: src/include/execution/runtime_filter.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/util/hash_util.h"
+#include "execution/expressions/abstract_expression.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * A RuntimeFilter summarizes the join keys of a hash join build side, so that probe side tuples that cannot find a
+ * match are dropped by the scan that produces them instead of travelling all the way up to the join.
+ *
+ * The summary is a blocked Bloom filter (every key sets a few bits of a single 64-bit word, so a lookup touches one
+ * cache line) together with the range of the keys. A filter passes every tuple until Build() is called, which makes it
+ * safe to attach to a scan before the build side has been consumed.
+ *
+ * The hashes of the inserted keys are buffered so that the filter can be sized to their number. Once the buffer would
+ * take more than half of the filter's memory limit, the Bloom filter is allocated from the other half and the keys
+ * that follow set their bits directly, so the filter never holds more than its limit.
+ */
+class RuntimeFilter {
+ public:
+  /**
+   * Create an empty filter.
+   * @param key_expr the probe side join key, evaluated against the output schema of the executor applying the filter
+   */
+  explicit RuntimeFilter(AbstractExpressionRef key_expr) : key_expr_(std::move(key_expr)) {}
+
+  /**
+   * Drop all keys and pass every tuple until the next Build().
+   * @param memory_limit the most bytes the filter may hold while keys are inserted
+   */
+  void Clear(size_t memory_limit = 2 * MAX_WORDS * sizeof(uint64_t));
+
+  /** Add a build side key, null keys never match and must not be inserted */
+  void Insert(const Value &key);
+
+  /** Size the Bloom filter to the inserted keys and start filtering */
+  void Build();
+
+  /**
+   * @return `false` if the tuple certainly has no match on the build side. Tuples with a null key never match.
+   * @param tuple the probe side tuple
+   * @param schema the schema of the tuple
+   */
+  auto MayContain(const Tuple &tuple, const Schema &schema) const -> bool;
+
+  /** @return whether the filter has been built */
+  auto IsBuilt() const -> bool { return built_; }
+
+  /** @return the number of bytes held by the filter */
+  auto GetMemoryUsage() const -> size_t {
+    return hashes_.capacity() * sizeof(hash_t) + words_.capacity() * sizeof(uint64_t);
+  }
+
+ private:
+  /** Upper bound on the size of the Bloom filter, about 8 MiB */
+  static constexpr size_t MAX_WORDS = 1 << 20;
+  /** The number of bits set per key */
+  static constexpr size_t NUM_PROBES = 4;
+
+  /** Allocate the Bloom filter, `num_words` rounded up to a power of two within the limit, and fold in the hashes */
+  void AllocateWords(size_t num_words);
+
+  /** @return the bits of a key within its word, taken from the high half of the hash */
+  static auto MaskOf(hash_t hash) -> uint64_t {
+    uint64_t mask = 0;
+    for (size_t i = 0; i < NUM_PROBES; i++) {
+      mask |= uint64_t{1} << ((hash >> (32 + 6 * i)) & 63);
+    }
+    return mask;
+  }
+
+  AbstractExpressionRef key_expr_;
+  /** The most bytes the filter may hold */
+  size_t memory_limit_{2 * MAX_WORDS * sizeof(uint64_t)};
+  /** The hashes of the inserted keys, until they are folded into `words_` */
+  std::vector<hash_t> hashes_;
+  /** The Bloom filter, the word of a key is picked by the low bits of its hash, empty while hashes are buffered */
+  std::vector<uint64_t> words_;
+  /** The smallest and largest inserted key */
+  std::optional<Value> min_;
+  std::optional<Value> max_;
+  bool built_{false};
+};
+
+using RuntimeFilterRef = std::shared_ptr<const RuntimeFilter>;
+
+/** @return `false` if any of the filters rejects the tuple */
+inline auto RuntimeFiltersPass(const std::vector<RuntimeFilterRef> &filters, const Tuple &tuple, const Schema &schema)
+    -> bool {
+  for (const auto &filter : filters) {
+    if (!filter->MayContain(tuple, schema)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace bustub
@@ -1,16 +1,24 @@
 #pragma once
 
+#include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <tuple>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "binder/bound_order_by.h"
 #include "catalog/catalog.h"
 #include "concurrency/transaction.h"
 #include "execution/expressions/abstract_expression.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/logic_expression.h"
 #include "execution/plans/abstract_plan.h"
+#include "execution/plans/bitmap_heap_scan_plan.h"
+#include "execution/plans/sort_plan.h"
 
 #define BUSTUB_OPTIMIZER_HACK_REMOVE_AFTER_2022_FALL
 
@@ -28,6 +36,21 @@ class Optimizer {
 
   auto OptimizeCustom(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
+  /** @brief collect the operands of nested logic expressions of one type, e.g. `a`, `b` and `c` of `(a and b) and c` */
+  static void FlattenLogic(const AbstractExpressionRef &expr, LogicType logic_type,
+                           std::vector<AbstractExpressionRef> *terms);
+
+  /** @brief combine conjuncts with `and`, the constant true if there are none */
+  static auto MakeConjunction(const std::vector<AbstractExpressionRef> &conjuncts) -> AbstractExpressionRef;
+
+  /** @brief the comparison `b op a` equivalent to `a op b` */
+  static auto FlipComparison(ComparisonType comp_type) -> ComparisonType;
+
+  /** @brief replace every column reference of an expression */
+  static auto RewriteColumns(const AbstractExpressionRef &expr,
+                             const std::function<AbstractExpressionRef(const ColumnValueExpression &)> &rewrite)
+      -> AbstractExpressionRef;
+
  private:
   /**
    * @brief merge projections that do identical project.
@@ -50,6 +73,21 @@ class Optimizer {
    */
   auto OptimizeNLJAsHashJoin(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
+  /**
+   * @brief optimize hash join into merge join if both inputs are ordered on the join keys already, e.g. by an index
+   * scan or by a sort. A sort on the join key above a hash join is folded into the join if one input is ordered.
+   */
+  auto OptimizeHashJoinAsMergeJoin(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /**
+   * @brief produce the output of a plan in ascending order of a column without sorting it
+   * @param scan_index whether an unfiltered sequential scan may be replaced by a full index scan. That costs a random
+   * heap fetch per row, so it only pays off if few rows are read, e.g. below a limit. A bitmap heap scan over a range
+   * of keys is always read through the index instead, its range is small already.
+   * @return the plan rewritten to scan an index if needed, `nullptr` if that is not possible
+   */
+  auto MakeOrderedOn(const AbstractPlanNodeRef &plan, uint32_t col_idx, bool scan_index) -> AbstractPlanNodeRef;
+
   /**
    * @brief optimize nested loop join into index join.
    */
@@ -90,19 +128,102 @@ class Optimizer {
       -> std::optional<std::tuple<index_oid_t, std::string>>;
 
   /**
-   * @brief optimize sort + limit as top N
+   * @brief optimize a filtered seq scan into a bitmap heap scan over the range of keys allowed by comparisons of an
+   * indexed column with constants, if the range is estimated to be small enough. Other conjuncts are checked on the
+   * tuples read.
+   */
+  auto OptimizeSeqScanAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /**
+   * @brief turn a bitmap heap scan over a range of keys into an index scan over the same range, which produces the
+   * tuples in key order and can stop early, at the cost of a random heap fetch per tuple.
+   * @return the index scan, `nullptr` if the plan is no such bitmap heap scan
+   */
+  auto RangeScanAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /**
+   * @brief optimize a filtered seq scan into a bitmap heap scan if equality predicates on indexed columns narrow down
+   * the tuples to read. Conjunctions intersect the RIDs of their indexed terms, disjunctions merge them.
+   */
+  auto OptimizeSeqScanAsBitmapScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /** @brief match `column = constant` or `column = $n`, or a disjunction of them, against an index on the column */
+  auto MatchBitmapLookup(const std::string &table_name, const AbstractExpressionRef &expr)
+      -> std::optional<BitmapIndexLookup>;
+
+  /**
+   * @brief reorder trees of inner joins by their estimated cost. All orders of up to 10 inputs are compared by dynamic
+   * programming, larger trees are joined greedily. Joins are costed as the index, hash or nested loop join the later
+   * rules turn them into, and are planned with only the join key in the join predicate so that those rules apply.
+   * Joins of two inputs keep the written order.
+   */
+  auto OptimizeReorderJoins(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /** @brief estimate the number of rows a plan produces */
+  auto EstimateRows(const AbstractPlanNodeRef &plan) -> double;
+
+  /**
+   * @brief fold the constant subexpressions of the expressions in a plan and simplify them: boolean logic with
+   * constants, additions of constants and comparisons, which get their constant on the right. Filters that are always
+   * true are removed, and operators that can never produce a row are replaced by an empty values node.
+   */
+  auto OptimizeFoldConstants(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /**
+   * @brief push every conjunct of filter predicates down as far as it can go: through projections by inlining the
+   * projected expressions, below aggregations if it only uses group by columns, into the side of a join whose columns
+   * it uses and below sorts. Conjuncts over both sides of an inner join become part of its predicate.
+   */
+  auto OptimizePushDownFilter(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /** @brief push conjuncts over the output columns of a plan into the plan */
+  auto PushDownFilter(const AbstractPlanNodeRef &plan, std::vector<AbstractExpressionRef> conjuncts)
+      -> AbstractPlanNodeRef;
+
+  /**
+   * @brief turn an aggregation into a stream aggregation if its input is ordered on the group by column already. A
+   * sort of its output on the group by column is dropped then.
+   */
+  auto OptimizeAggregationAsStreamAggregation(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /**
+   * @brief produce the output of a sort over an aggregation, optionally below a projection, by a stream aggregation
+   * over its input ordered on the group by column.
+   * @param scan_index whether the input may be replaced by a full index scan, see MakeOrderedOn()
+   * @return the stream aggregation, `nullptr` if the sort key is not the group by column or the input is not ordered
+   */
+  auto SortAsStreamAggregation(const SortPlanNode &sort_plan, bool scan_index) -> AbstractPlanNodeRef;
+
+  /**
+   * @brief optimize sort + limit as top N, and push limits and top Ns down through projections and into the outer
+   * side of left joins. A top N over an input already ordered on its key becomes a limit, so an index scan stops after
+   * the first n keys.
    */
   auto OptimizeSortLimitAsTopN(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
+  /** @brief produce at most `limit` rows of a plan, the plan itself if it never produces more */
+  auto PushDownLimit(const AbstractPlanNodeRef &plan, size_t limit) -> AbstractPlanNodeRef;
+
+  /** @brief produce the first n rows of a plan in the order of `order_bys` */
+  auto PushDownTopN(const AbstractPlanNodeRef &plan,
+                    std::vector<std::pair<OrderByType, AbstractExpressionRef>> order_bys, size_t n)
+      -> AbstractPlanNodeRef;
+
   /**
-   * @brief get the estimated cardinality for a table based on the table name. Useful when join reordering. BusTub
-   * doesn't support statistics for now, so it's the only way for you to get the table size :(
+   * @brief get the estimated cardinality for a table. Useful when join reordering. Tables with a heap keep an exact row
+   * count, for mock tables the size is guessed from the table name.
    *
    * @param table_name
    * @return std::optional<size_t>
    */
   auto EstimatedCardinality(const std::string &table_name) -> std::optional<size_t>;
 
+  /**
+   * @brief estimate the fraction of the rows of a table matching a predicate on its columns, using the statistics
+   * collected by ANALYZE. Terms the statistics cannot help with get fixed default selectivities.
+   */
+  auto EstimateSelectivity(const std::string &table_name, const AbstractExpressionRef &predicate) -> double;
+
   /** Catalog will be used during the planning process. USERS SHOULD ENSURE IT OUTLIVES
    * OPTIMIZER, otherwise it's a dangling reference.
    */
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "execution/plans/abstract_plan.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/** An optimized plan ready to be executed again */
+struct CachedPlan {
+  /** The optimized plan */
+  AbstractPlanNodeRef plan_;
+  /** The schema of the result set as named by the query */
+  SchemaRef output_schema_;
+  /** The catalog version the plan was made against */
+  uint64_t catalog_version_;
+  /** The values the plan reads for the parameters of a prepared statement, bound anew by every EXECUTE */
+  std::shared_ptr<std::vector<Value>> parameters_;
+};
+
+/**
+ * The plan cache maps the text of a statement to its optimized plan, so that a statement that is run again skips
+ * parsing, binding, planning and optimization. Texts are compared after normalizing their whitespace. A plan made
+ * against an older version of the catalog is dropped when looked up, as a new table or index may change the plan.
+ * The least recently used plan is evicted once the cache is full.
+ *
+ * A prepared statement has a single plan, kept until the statement is deallocated. Its parameters are read when the
+ * plan runs, so EXECUTEs with different values share it as long as the values have the same types.
+ */
+class PlanCache {
+ public:
+  explicit PlanCache(size_t capacity = PLAN_CACHE_SIZE) : capacity_(capacity) {}
+
+  /** @return the cache key of a statement text, with runs of whitespace outside quotes and trailing `;` collapsed */
+  static auto Normalize(const std::string &sql) -> std::string;
+
+  /**
+   * Look up the plan of a statement.
+   * @param key The normalized statement text
+   * @param catalog_version The current catalog version
+   * @return the cached plan, or `std::nullopt` if there is none or it is stale
+   */
+  auto Get(const std::string &key, uint64_t catalog_version) -> std::optional<CachedPlan>;
+
+  /** Cache the plan of a statement, replacing any plan cached for the same text */
+  void Put(const std::string &key, CachedPlan plan);
+
+  /**
+   * Look up the plan of a prepared statement.
+   * @param name The name of the prepared statement
+   * @param catalog_version The current catalog version
+   * @param parameters The values to bind to the parameters
+   * @return the cached plan, or `std::nullopt` if there is none, it is stale or it was made for other parameter types
+   */
+  auto GetPrepared(const std::string &name, uint64_t catalog_version, const std::vector<Value> &parameters)
+      -> std::optional<CachedPlan>;
+
+  /** Cache the plan of a prepared statement, replacing any plan cached for it */
+  void PutPrepared(const std::string &name, CachedPlan plan);
+
+  /** Drop the plan of a prepared statement, e.g. when it is deallocated */
+  void ErasePrepared(const std::string &name);
+
+  /** Drop all plans, e.g. when a session variable the optimizer reads changes */
+  void Clear();
+
+  /** @return the number of lookups that found a plan */
+  auto GetHits() const -> size_t { return hits_; }
+
+  /** @return the number of lookups that did not find a plan */
+  auto GetMisses() const -> size_t { return misses_; }
+
+ private:
+  using Entry = std::pair<std::string, CachedPlan>;
+
+  std::mutex latch_;
+  size_t capacity_;
+  /** The cached plans, most recently used first */
+  std::list<Entry> entries_;
+  std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+  /** The plans of prepared statements, by statement name */
+  std::unordered_map<std::string, CachedPlan> prepared_;
+  size_t hits_{0};
+  size_t misses_{0};
+};
+
+}  // namespace bustub
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <tuple>
 #include <unordered_map>
@@ -14,6 +15,7 @@
 #include "common/exception.h"
 #include "common/macros.h"
 #include "execution/plans/aggregation_plan.h"
+#include "type/value.h"
 
 namespace bustub {
 
@@ -26,6 +28,7 @@ class BoundExpression;
 class BoundTableRef;
 class BoundBinaryOp;
 class BoundConstant;
+class BoundParameter;
 class BoundColumnRef;
 class BoundUnaryOp;
 class BoundBaseTableRef;
@@ -44,7 +47,7 @@ class PlannerContext {
  public:
   PlannerContext() = default;
 
-  void AddAggregation(std::unique_ptr<BoundExpression> expr);
+  void AddAggregation(const BoundAggCall *agg_call);
 
   /** Indicates whether aggregation is allowed in this context. */
   bool allow_aggregation_{false};
@@ -57,7 +60,7 @@ class PlannerContext {
    * The expressions in this vector should be used over the output of the original filter / table
    * scan plan node.
    */
-  std::vector<std::unique_ptr<BoundExpression>> aggregations_;
+  std::vector<const BoundAggCall *> aggregations_;
 
   /**
    * In the second phase of aggregation planning, we plan agg calls from `aggregations_`, and generate
@@ -78,7 +81,13 @@ class PlannerContext {
  */
 class Planner {
  public:
-  explicit Planner(const Catalog &catalog) : catalog_(catalog) {}
+  /**
+   * @param catalog The catalog to plan against
+   * @param parameters The values bound to the `$n` parameters of a prepared statement, `$1` first. The plan reads
+   * them when it runs, so values bound later are used by the same plan.
+   */
+  explicit Planner(const Catalog &catalog, std::shared_ptr<const std::vector<Value>> parameters = nullptr)
+      : catalog_(catalog), parameters_(std::move(parameters)) {}
 
   // The following parts are undocumented. One `PlanXXX` functions simply corresponds to a
   // bound thing in the binder.
@@ -110,7 +119,7 @@ class Planner {
 
   auto PlanExpressionListRef(const BoundExpressionListRef &table_ref) -> AbstractPlanNodeRef;
 
-  void AddAggCallToContext(BoundExpression &expr);
+  void AddAggCallToContext(const BoundExpression &expr);
 
   auto PlanExpression(const BoundExpression &expr, const std::vector<AbstractPlanNodeRef> &children)
       -> std::tuple<std::string, AbstractExpressionRef>;
@@ -124,6 +133,15 @@ class Planner {
   auto PlanConstant(const BoundConstant &expr, const std::vector<AbstractPlanNodeRef> &children)
       -> AbstractExpressionRef;
 
+  /** @return an expression reading the value bound to a parameter, which must have been given */
+  auto PlanParameter(const BoundParameter &expr) -> AbstractExpressionRef;
+
+  /**
+   * @return the value of a constant or parameter, `std::nullopt` for any other expression. The plan only holds for
+   * the value a parameter has now.
+   */
+  auto PlanConstantValue(const BoundExpression &expr) -> std::optional<Value>;
+
   auto PlanSelectAgg(const SelectStatement &statement, AbstractPlanNodeRef child) -> AbstractPlanNodeRef;
 
   auto PlanAggCall(const BoundAggCall &agg_call, const std::vector<AbstractPlanNodeRef> &children)
@@ -144,6 +162,9 @@ class Planner {
   /** the root plan node of the plan tree */
   AbstractPlanNodeRef plan_;
 
+  /** Whether the plan depends on the values bound to the parameters, e.g. for `LIMIT $1` */
+  bool uses_parameter_values_{false};
+
  private:
   PlannerContext ctx_;
 
@@ -175,6 +196,9 @@ class Planner {
    */
   const Catalog &catalog_;
 
+  /** The values bound to the `$n` parameters */
+  std::shared_ptr<const std::vector<Value>> parameters_;
+
   /** An id for all unnamed things */
   size_t universal_id_{0};
 };
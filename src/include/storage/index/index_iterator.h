@@ -25,6 +25,11 @@ class IndexIterator {
   using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
   // you may define your own constructor based on your member variables
   IndexIterator(BufferPoolManager *bpm, Page *page, int index = 0);
+  /** The iterator holds a latch and a pin on its page, which move with it and are never shared by copies */
+  IndexIterator(IndexIterator &&other) noexcept;
+  IndexIterator(const IndexIterator &) = delete;
+  auto operator=(const IndexIterator &) -> IndexIterator & = delete;
+  auto operator=(IndexIterator &&) -> IndexIterator & = delete;
   ~IndexIterator();  // NOLINT
 
   auto IsEnd() -> bool;
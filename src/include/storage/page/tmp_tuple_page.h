@@ -6,10 +6,6 @@
 
 namespace bustub {
 
-// To pass the test cases for this class, you must follow the existing TmpTuplePage format and implement the
-// existing functions exactly as they are! It may be helpful to look at TablePage.
-// Remember that this task is optional, you get full credit if you finish the next task.
-
 /**
  * TmpTuplePage format:
  *
@@ -17,19 +13,69 @@ namespace bustub {
  * | PageId (4) | LSN (4) | FreeSpace (4) | (free space) | TupleSize2 | TupleData2 | TupleSize1 | TupleData1 |
  *
  * We choose this format because DeserializeExpression expects to read Size followed by Data.
+ *
+ * Tuples are appended from the end of the page towards the header. Walking from the free space pointer to the end of
+ * the page therefore visits the tuples in reverse insertion order.
  */
 class TmpTuplePage : public Page {
  public:
   void Init(page_id_t page_id, uint32_t page_size) {
     memcpy(GetData(), &page_id, sizeof(page_id_t));
-    memcpy(GetData() + sizeof(page_id_t), &page_size, sizeof(uint32_t));
+    SetFreeSpacePointer(page_size);
+  }
+
+  auto GetTablePageId() -> page_id_t { return *reinterpret_cast<page_id_t *>(GetData()); }
+
+  void SetTablePageId(page_id_t page_id) { memcpy(GetData(), &page_id, sizeof(page_id_t)); }
+
+  /**
+   * Append a tuple to this page.
+   * @param tuple the tuple to append
+   * @param[out] out the location of the appended tuple
+   * @return `false` if the tuple does not fit into the remaining free space
+   */
+  auto Insert(const Tuple &tuple, TmpTuple *out) -> bool {
+    auto size = static_cast<uint32_t>(sizeof(uint32_t) + tuple.GetLength());
+    auto free_space_pointer = GetFreeSpacePointer();
+    if (free_space_pointer < SIZE_TMP_PAGE_HEADER + size) {
+      return false;
+    }
+    free_space_pointer -= size;
+    tuple.SerializeTo(GetData() + free_space_pointer);
+    SetFreeSpacePointer(free_space_pointer);
+    *out = TmpTuple(GetTablePageId(), free_space_pointer);
+    return true;
+  }
+
+  /**
+   * Read the tuple stored at the given offset.
+   * @param offset the offset returned by Insert() or GetNextTupleOffset()
+   * @param[out] tuple the tuple read
+   */
+  void Get(uint32_t offset, Tuple *tuple) { tuple->DeserializeFrom(GetData() + offset); }
+
+  /** @return the offset of the most recently inserted tuple, or the page end if the page is empty */
+  auto GetFirstTupleOffset() -> uint32_t { return GetFreeSpacePointer(); }
+
+  /** @return the offset of the tuple that was inserted right before the one at `offset` */
+  auto GetNextTupleOffset(uint32_t offset) -> uint32_t {
+    return offset + sizeof(uint32_t) + *reinterpret_cast<uint32_t *>(GetData() + offset);
   }
 
-  auto GetTablePageId() -> page_id_t { return INVALID_PAGE_ID; }
+  /** @return the number of bytes a tuple occupies on a temporary page */
+  static auto GetStorageSize(const Tuple &tuple) -> uint32_t { return sizeof(uint32_t) + tuple.GetLength(); }
 
-  auto Insert(const Tuple &tuple, TmpTuple *out) -> bool { return false; }
+  static constexpr uint32_t SIZE_TMP_PAGE_HEADER = 12;
 
  private:
+  static constexpr size_t OFFSET_FREE_SPACE = 8;
+
+  auto GetFreeSpacePointer() -> uint32_t { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
+
+  void SetFreeSpacePointer(uint32_t free_space_pointer) {
+    memcpy(GetData() + OFFSET_FREE_SPACE, &free_space_pointer, sizeof(uint32_t));
+  }
+
   static_assert(sizeof(page_id_t) == 4);
 };
 
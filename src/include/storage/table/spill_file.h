@@ -0,0 +1,88 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// spill_file.h
+//
+// Identification: src/include/storage/table/spill_file.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/macros.h"
+#include "storage/page/tmp_tuple_page.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * SpillFile is an append-only sequence of tuples stored on temporary pages (TmpTuplePage) in the buffer pool. Operators
+ * that run out of memory write their overflow to spill files and read it back later in insertion order.
+ *
+ * The page being filled is staged outside the buffer pool, so an open spill file does not pin any frame. This allows
+ * an operator to keep many spill files open at once. All pages are deleted when the file is destroyed.
+ */
+class SpillFile {
+ public:
+  /**
+   * Create an empty spill file.
+   * @param bpm the buffer pool manager that stores the pages of the file
+   */
+  explicit SpillFile(BufferPoolManager *bpm) : bpm_(bpm) {}
+
+  /** Delete all pages of the file */
+  ~SpillFile();
+
+  DISALLOW_COPY_AND_MOVE(SpillFile);
+
+  /**
+   * Append a tuple to the end of the file.
+   * @param tuple the tuple to append, which must fit into a single page
+   */
+  void Append(const Tuple &tuple);
+
+  /** Write out the staged page and start reading from the first tuple */
+  void Rewind();
+
+  /**
+   * Read the next tuple. Rewind() must have been called before the first read.
+   * @param[out] tuple the next tuple of the file
+   * @return `false` if all tuples have been read
+   */
+  auto Next(Tuple *tuple) -> bool;
+
+  /** @return the number of tuples in the file */
+  auto GetTupleCount() const -> size_t { return tuple_count_; }
+
+  /** @return the number of bytes the tuples of the file occupy on disk */
+  auto GetSize() const -> size_t { return size_; }
+
+ private:
+  /** Copy the staged page into a new buffer pool page */
+  void FlushStagedPage();
+
+  BufferPoolManager *bpm_;
+  /** The pages written so far, in insertion order */
+  std::vector<page_id_t> page_ids_;
+  /** The page being filled, not yet part of the buffer pool */
+  std::unique_ptr<TmpTuplePage> staged_page_;
+  /** Whether the staged page holds any tuple */
+  bool staged_page_dirty_{false};
+  /** The tuples of the page being read, in insertion order */
+  std::vector<Tuple> read_buffer_;
+  /** The position of the next tuple to read within `read_buffer_` */
+  size_t read_cursor_{0};
+  /** The position of the next page to read within `page_ids_` */
+  size_t next_read_page_{0};
+  size_t tuple_count_{0};
+  size_t size_{0};
+};
+
+}  // namespace bustub
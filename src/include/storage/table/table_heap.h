@@ -12,6 +12,9 @@
 
 #pragma once
 
+#include <utility>
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
 #include "recovery/log_manager.h"
 #include "storage/page/table_page.h"
@@ -105,6 +108,30 @@ class TableHeap {
   /** @return the end iterator of this table */
   auto End() -> TableIterator;
 
+  /**
+   * Collect the ids of all pages of this table by walking the page chain.
+   * @param txn the transaction performing the read
+   * @return the page ids in chain order
+   */
+  auto GetPageIds(Transaction *txn) -> std::vector<page_id_t>;
+
+  /**
+   * Read all live tuples of one page of this table, holding the page latch only once.
+   * @param page_id the page to read
+   * @param[out] tuples the live tuples of the page and their rids are appended here
+   * @param txn the transaction performing the read
+   * @return the id of the next page in the chain, INVALID_PAGE_ID if this is the last page
+   */
+  auto GetPageTuples(page_id_t page_id, std::vector<std::pair<Tuple, RID>> *tuples, Transaction *txn) -> page_id_t;
+
+  /**
+   * Read the tuples at the given rids, which must all be on the same page, holding the page latch only once.
+   * @param rids the rids to read
+   * @param[out] tuples the live tuples among them and their rids are appended here
+   * @param txn the transaction performing the read
+   */
+  void GetPageTuples(const std::vector<RID> &rids, std::vector<std::pair<Tuple, RID>> *tuples, Transaction *txn);
+
   /** @return the id of the first page of this table */
   inline auto GetFirstPageId() const -> page_id_t { return first_page_id_; }
 
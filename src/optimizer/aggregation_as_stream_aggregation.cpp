@@ -0,0 +1,102 @@
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "binder/bound_order_by.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/aggregation_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "execution/plans/sort_plan.h"
+#include "execution/plans/stream_aggregation_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+namespace {
+
+auto MakeStreamAggregation(const AggregationPlanNode &agg_plan, AbstractPlanNodeRef input) -> AbstractPlanNodeRef {
+  return std::make_shared<StreamAggregationPlanNode>(agg_plan.output_schema_, std::move(input), agg_plan.GetGroupBys(),
+                                                     agg_plan.GetAggregates(), agg_plan.GetAggregateTypes());
+}
+
+}  // namespace
+
+auto Optimizer::OptimizeAggregationAsStreamAggregation(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  // Below a limit only the first groups are read, which is worth a full index scan that yields them in order.
+  if (plan->GetType() == PlanType::Limit && plan->GetChildAt(0)->GetType() == PlanType::Sort) {
+    const auto &sort = plan->GetChildAt(0);
+    auto optimized_sort = sort->CloneWithChildren({OptimizeAggregationAsStreamAggregation(sort->GetChildAt(0))});
+    auto stream_aggregation = SortAsStreamAggregation(dynamic_cast<const SortPlanNode &>(*optimized_sort), true);
+    return plan->CloneWithChildren(
+        {stream_aggregation != nullptr ? std::move(stream_aggregation) : std::move(optimized_sort)});
+  }
+
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeAggregationAsStreamAggregation(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  if (optimized_plan->GetType() == PlanType::Aggregation) {
+    const auto &agg_plan = dynamic_cast<const AggregationPlanNode &>(*optimized_plan);
+    const auto &group_bys = agg_plan.GetGroupBys();
+    const auto *column_value_expr =
+        group_bys.size() == 1 ? dynamic_cast<const ColumnValueExpression *>(group_bys[0].get()) : nullptr;
+    if (column_value_expr == nullptr) {
+      return optimized_plan;
+    }
+    if (auto ordered = MakeOrderedOn(agg_plan.GetChildPlan(), column_value_expr->GetColIdx(), false);
+        ordered != nullptr) {
+      return MakeStreamAggregation(agg_plan, std::move(ordered));
+    }
+    return optimized_plan;
+  }
+
+  if (optimized_plan->GetType() == PlanType::Sort) {
+    if (auto stream_aggregation = SortAsStreamAggregation(dynamic_cast<const SortPlanNode &>(*optimized_plan), false);
+        stream_aggregation != nullptr) {
+      return stream_aggregation;
+    }
+  }
+  return optimized_plan;
+}
+
+auto Optimizer::SortAsStreamAggregation(const SortPlanNode &sort_plan, bool scan_index) -> AbstractPlanNodeRef {
+  auto order_bys = sort_plan.GetOrderBy();
+  auto child = sort_plan.GetChildPlan();
+  const ProjectionPlanNode *projection = nullptr;
+  if (child->GetType() == PlanType::Projection) {
+    projection = dynamic_cast<const ProjectionPlanNode *>(child.get());
+    for (auto &[order_type, expr] : order_bys) {
+      expr = RewriteColumns(
+          expr, [&](const ColumnValueExpression &column) { return projection->GetExpressions()[column.GetColIdx()]; });
+    }
+    child = child->GetChildAt(0);
+  }
+  if (child->GetType() != PlanType::Aggregation && child->GetType() != PlanType::StreamAggregation) {
+    return nullptr;
+  }
+
+  // The only sort key has to be the only group by column, then the groups come out in the order of the input.
+  const auto &agg_plan = dynamic_cast<const AggregationPlanNode &>(*child);
+  const auto &group_bys = agg_plan.GetGroupBys();
+  if (group_bys.size() != 1 || order_bys.size() != 1 ||
+      !(order_bys[0].first == OrderByType::ASC || order_bys[0].first == OrderByType::DEFAULT)) {
+    return nullptr;
+  }
+  const auto *order_column = dynamic_cast<const ColumnValueExpression *>(order_bys[0].second.get());
+  const auto *key_column = dynamic_cast<const ColumnValueExpression *>(group_bys[0].get());
+  if (order_column == nullptr || order_column->GetColIdx() != 0 || key_column == nullptr) {
+    return nullptr;
+  }
+  auto ordered = MakeOrderedOn(agg_plan.GetChildPlan(), key_column->GetColIdx(), scan_index);
+  if (ordered == nullptr) {
+    return nullptr;
+  }
+
+  auto stream_aggregation = MakeStreamAggregation(agg_plan, std::move(ordered));
+  return projection == nullptr ? stream_aggregation : projection->CloneWithChildren({std::move(stream_aggregation)});
+}
+
+}  // namespace bustub
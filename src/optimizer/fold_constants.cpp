@@ -0,0 +1,269 @@
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "execution/expressions/arithmetic_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/aggregation_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/nested_loop_join_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "execution/plans/sort_plan.h"
+#include "execution/plans/values_plan.h"
+#include "optimizer/optimizer.h"
+#include "type/limits.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+auto AsConstant(const AbstractExpressionRef &expr) -> const Value * {
+  const auto *constant_value_expr = dynamic_cast<const ConstantValueExpression *>(expr.get());
+  return constant_value_expr == nullptr ? nullptr : &constant_value_expr->val_;
+}
+
+auto IsBooleanConstant(const AbstractExpressionRef &expr, bool value) -> bool {
+  const auto *constant = AsConstant(expr);
+  return constant != nullptr && constant->GetTypeId() == TypeId::BOOLEAN && !constant->IsNull() &&
+         constant->GetAs<bool>() == value;
+}
+
+/** @return whether a predicate is a constant no row satisfies, false or null */
+auto IsNeverTrue(const AbstractExpressionRef &expr) -> bool {
+  const auto *constant = AsConstant(expr);
+  return constant != nullptr &&
+         (constant->IsNull() || (constant->GetTypeId() == TypeId::BOOLEAN && !constant->GetAs<bool>()));
+}
+
+auto AsIntegerConstant(const AbstractExpressionRef &expr) -> std::optional<int64_t> {
+  const auto *constant = AsConstant(expr);
+  if (constant == nullptr || constant->GetTypeId() != TypeId::INTEGER || constant->IsNull()) {
+    return std::nullopt;
+  }
+  return constant->GetAs<int32_t>();
+}
+
+/** @return an integer constant, `nullptr` if the value does not fit */
+auto MakeIntegerConstant(int64_t value) -> AbstractExpressionRef {
+  if (value < BUSTUB_INT32_MIN || value > BUSTUB_INT32_MAX) {
+    return nullptr;
+  }
+  return std::make_shared<ConstantValueExpression>(ValueFactory::GetIntegerValue(static_cast<int32_t>(value)));
+}
+
+/** @return the constant added by `expr + right` or `expr - right`, if `right` is one */
+auto AddedConstant(ArithmeticType compute_type, const AbstractExpressionRef &right) -> std::optional<int64_t> {
+  auto constant = AsIntegerConstant(right);
+  if (!constant.has_value()) {
+    return std::nullopt;
+  }
+  return compute_type == ArithmeticType::Plus ? *constant : -*constant;
+}
+
+/** @return `expr + constant`, written as a subtraction for a negative constant */
+auto MakeAddition(const AbstractExpressionRef &expr, int64_t constant) -> AbstractExpressionRef {
+  if (constant == 0) {
+    return expr;
+  }
+  auto constant_expr = MakeIntegerConstant(constant < 0 ? -constant : constant);
+  if (constant_expr == nullptr) {
+    return nullptr;
+  }
+  return std::make_shared<ArithmeticExpression>(expr, std::move(constant_expr),
+                                                constant < 0 ? ArithmeticType::Minus : ArithmeticType::Plus);
+}
+
+auto FoldExpression(const AbstractExpressionRef &expr) -> AbstractExpressionRef {
+  if (expr->GetChildren().empty()) {
+    return expr;
+  }
+  std::vector<AbstractExpressionRef> children;
+  bool all_constant = true;
+  for (const auto &child : expr->GetChildren()) {
+    children.push_back(FoldExpression(child));
+    all_constant = all_constant && AsConstant(children.back()) != nullptr;
+  }
+  if (all_constant) {
+    // An expression failing on its constants is left to fail when it is evaluated, as it would have.
+    auto folded = expr->CloneWithChildren(children);
+    try {
+      return std::make_shared<ConstantValueExpression>(folded->Evaluate(nullptr, Schema{std::vector<Column>{}}));
+    } catch (const Exception &e) {
+      return folded;
+    }
+  }
+
+  if (const auto *logic_expr = dynamic_cast<const LogicExpression *>(expr.get()); logic_expr != nullptr) {
+    // `true` decides an `or` and `false` decides an `and`, the other constant leaves the other side to decide.
+    auto deciding = logic_expr->logic_type_ == LogicType::Or;
+    for (size_t i = 0; i < 2; i++) {
+      if (IsBooleanConstant(children[i], deciding)) {
+        return children[i];
+      }
+      if (IsBooleanConstant(children[i], !deciding)) {
+        return children[1 - i];
+      }
+    }
+  }
+
+  if (const auto *arithmetic_expr = dynamic_cast<const ArithmeticExpression *>(expr.get());
+      arithmetic_expr != nullptr) {
+    auto compute_type = arithmetic_expr->compute_type_;
+    for (const auto &child : children) {
+      if (const auto *constant = AsConstant(child); constant != nullptr && constant->IsNull()) {
+        return std::make_shared<ConstantValueExpression>(ValueFactory::GetNullValueByType(TypeId::INTEGER));
+      }
+    }
+    if (compute_type == ArithmeticType::Plus && AsConstant(children[0]) != nullptr) {
+      std::swap(children[0], children[1]);
+    }
+    // `(a + 1) + 2` is `a + 3`.
+    if (auto constant = AddedConstant(compute_type, children[1]); constant.has_value()) {
+      auto base = children[0];
+      if (const auto *inner_expr = dynamic_cast<const ArithmeticExpression *>(base.get()); inner_expr != nullptr) {
+        if (auto inner_constant = AddedConstant(inner_expr->compute_type_, inner_expr->GetChildAt(1));
+            inner_constant.has_value()) {
+          base = inner_expr->GetChildAt(0);
+          *constant += *inner_constant;
+        }
+      }
+      if (auto addition = MakeAddition(base, *constant); addition != nullptr) {
+        return addition;
+      }
+    }
+    return std::make_shared<ArithmeticExpression>(children[0], children[1], compute_type);
+  }
+
+  if (const auto *comparison_expr = dynamic_cast<const ComparisonExpression *>(expr.get());
+      comparison_expr != nullptr) {
+    auto comp_type = comparison_expr->comp_type_;
+    if (AsConstant(children[0]) != nullptr) {
+      std::swap(children[0], children[1]);
+      comp_type = Optimizer::FlipComparison(comp_type);
+    }
+    // `a + 1 > 3` is `a > 2`.
+    const auto *arithmetic_expr = dynamic_cast<const ArithmeticExpression *>(children[0].get());
+    auto constant = AsIntegerConstant(children[1]);
+    if (arithmetic_expr != nullptr && constant.has_value()) {
+      if (auto added = AddedConstant(arithmetic_expr->compute_type_, arithmetic_expr->GetChildAt(1));
+          added.has_value()) {
+        if (auto moved = MakeIntegerConstant(*constant - *added); moved != nullptr) {
+          children[0] = arithmetic_expr->GetChildAt(0);
+          children[1] = std::move(moved);
+        }
+      }
+    }
+    return std::make_shared<ComparisonExpression>(children[0], children[1], comp_type);
+  }
+
+  return expr->CloneWithChildren(std::move(children));
+}
+
+auto IsEmptyValues(const AbstractPlanNode &plan) -> bool {
+  return plan.GetType() == PlanType::Values && dynamic_cast<const ValuesPlanNode &>(plan).GetValues().empty();
+}
+
+}  // namespace
+
+auto Optimizer::OptimizeFoldConstants(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeFoldConstants(child));
+  }
+  std::shared_ptr<AbstractPlanNode> optimized_plan = plan->CloneWithChildren(std::move(children));
+  auto empty_plan = std::make_shared<ValuesPlanNode>(optimized_plan->output_schema_,
+                                                     std::vector<std::vector<AbstractExpressionRef>>{});
+
+  switch (optimized_plan->GetType()) {
+    case PlanType::Filter: {
+      auto &filter_plan = dynamic_cast<FilterPlanNode &>(*optimized_plan);
+      filter_plan.predicate_ = FoldExpression(filter_plan.predicate_);
+      if (IsNeverTrue(filter_plan.predicate_) || IsEmptyValues(*filter_plan.GetChildPlan())) {
+        return empty_plan;
+      }
+      if (IsPredicateTrue(*filter_plan.predicate_)) {
+        return filter_plan.children_[0];
+      }
+      break;
+    }
+    case PlanType::SeqScan: {
+      auto &seq_scan_plan = dynamic_cast<SeqScanPlanNode &>(*optimized_plan);
+      if (seq_scan_plan.filter_predicate_ != nullptr) {
+        seq_scan_plan.filter_predicate_ = FoldExpression(seq_scan_plan.filter_predicate_);
+        if (IsNeverTrue(seq_scan_plan.filter_predicate_)) {
+          return empty_plan;
+        }
+        if (IsPredicateTrue(*seq_scan_plan.filter_predicate_)) {
+          seq_scan_plan.filter_predicate_ = nullptr;
+        }
+      }
+      break;
+    }
+    case PlanType::NestedLoopJoin: {
+      // A left join still produces the rows of its left input if no right row matches.
+      auto &nlj_plan = dynamic_cast<NestedLoopJoinPlanNode &>(*optimized_plan);
+      nlj_plan.predicate_ = FoldExpression(nlj_plan.predicate_);
+      if (IsEmptyValues(*nlj_plan.GetLeftPlan()) ||
+          (nlj_plan.GetJoinType() == JoinType::INNER &&
+           (IsNeverTrue(nlj_plan.predicate_) || IsEmptyValues(*nlj_plan.GetRightPlan())))) {
+        return empty_plan;
+      }
+      break;
+    }
+    case PlanType::Projection: {
+      auto &projection_plan = dynamic_cast<ProjectionPlanNode &>(*optimized_plan);
+      for (auto &expr : projection_plan.expressions_) {
+        expr = FoldExpression(expr);
+      }
+      if (IsEmptyValues(*projection_plan.GetChildPlan())) {
+        return empty_plan;
+      }
+      break;
+    }
+    case PlanType::Aggregation: {
+      // Aggregating no rows without group bys still produces one row.
+      auto &aggregation_plan = dynamic_cast<AggregationPlanNode &>(*optimized_plan);
+      for (auto &expr : aggregation_plan.group_bys_) {
+        expr = FoldExpression(expr);
+      }
+      for (auto &expr : aggregation_plan.aggregates_) {
+        expr = FoldExpression(expr);
+      }
+      if (!aggregation_plan.group_bys_.empty() && IsEmptyValues(*aggregation_plan.GetChildPlan())) {
+        return empty_plan;
+      }
+      break;
+    }
+    case PlanType::Sort: {
+      auto &sort_plan = dynamic_cast<SortPlanNode &>(*optimized_plan);
+      for (auto &[order_type, expr] : sort_plan.order_bys_) {
+        expr = FoldExpression(expr);
+      }
+      if (IsEmptyValues(*sort_plan.GetChildPlan())) {
+        return empty_plan;
+      }
+      break;
+    }
+    case PlanType::Values: {
+      auto &values_plan = dynamic_cast<ValuesPlanNode &>(*optimized_plan);
+      for (auto &row : values_plan.values_) {
+        for (auto &expr : row) {
+          expr = FoldExpression(expr);
+        }
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  return optimized_plan;
+}
+
+}  // namespace bustub
@@ -0,0 +1,185 @@
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "binder/bound_order_by.h"
+#include "catalog/catalog.h"
+#include "common/macros.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/bitmap_heap_scan_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/hash_join_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/merge_join_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "execution/plans/sort_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return the column of the first order by if it sorts a column in ascending order, `nullopt` otherwise */
+auto LeadingAscendingColumn(const SortPlanNode &sort_plan) -> std::optional<uint32_t> {
+  const auto &[order_type, expr] = sort_plan.GetOrderBy()[0];
+  const auto *column_value_expr = dynamic_cast<const ColumnValueExpression *>(expr.get());
+  if (!(order_type == OrderByType::ASC || order_type == OrderByType::DEFAULT) || column_value_expr == nullptr) {
+    return std::nullopt;
+  }
+  return column_value_expr->GetColIdx();
+}
+
+}  // namespace
+
+auto Optimizer::MakeOrderedOn(const AbstractPlanNodeRef &plan, uint32_t col_idx, bool scan_index)
+    -> AbstractPlanNodeRef {
+  switch (plan->GetType()) {
+    case PlanType::IndexScan: {
+      const auto &index_scan = dynamic_cast<const IndexScanPlanNode &>(*plan);
+      const auto *index_info = catalog_.GetIndex(index_scan.GetIndexOid());
+      if (index_info->index_->GetKeyAttrs() == std::vector{col_idx}) {
+        return plan;
+      }
+      return nullptr;
+    }
+    case PlanType::BitmapHeapScan: {
+      auto index_scan = RangeScanAsIndexScan(plan);
+      if (index_scan == nullptr) {
+        return nullptr;
+      }
+      const auto &lookup = dynamic_cast<const BitmapHeapScanPlanNode &>(*plan).GetLookups()[0];
+      if (catalog_.GetIndex(lookup.index_oid_)->index_->GetKeyAttrs() == std::vector{col_idx}) {
+        return index_scan;
+      }
+      return nullptr;
+    }
+    case PlanType::SeqScan: {
+      // A B+ tree index on the column produces the table in order without sorting.
+      const auto &seq_scan = dynamic_cast<const SeqScanPlanNode &>(*plan);
+      if (!scan_index || seq_scan.filter_predicate_ != nullptr) {
+        return nullptr;
+      }
+      if (auto index = MatchIndex(seq_scan.table_name_, col_idx); index != std::nullopt) {
+        return std::make_shared<IndexScanPlanNode>(seq_scan.output_schema_, std::get<0>(*index));
+      }
+      return nullptr;
+    }
+    case PlanType::Sort: {
+      const auto &sort_plan = dynamic_cast<const SortPlanNode &>(*plan);
+      return LeadingAscendingColumn(sort_plan) == col_idx ? plan : nullptr;
+    }
+    case PlanType::Filter: {
+      auto child = MakeOrderedOn(plan->GetChildAt(0), col_idx, scan_index);
+      return child == nullptr ? nullptr : plan->CloneWithChildren({std::move(child)});
+    }
+    case PlanType::Projection: {
+      const auto &projection = dynamic_cast<const ProjectionPlanNode &>(*plan);
+      const auto *column_value_expr =
+          dynamic_cast<const ColumnValueExpression *>(projection.GetExpressions()[col_idx].get());
+      if (column_value_expr == nullptr) {
+        return nullptr;
+      }
+      auto child = MakeOrderedOn(plan->GetChildAt(0), column_value_expr->GetColIdx(), scan_index);
+      return child == nullptr ? nullptr : plan->CloneWithChildren({std::move(child)});
+    }
+    case PlanType::MergeJoin: {
+      // The output follows the order of the left input, whose key equals the right key on inner joins.
+      const auto &merge_join = dynamic_cast<const MergeJoinPlanNode &>(*plan);
+      auto left_col_idx = dynamic_cast<const ColumnValueExpression &>(merge_join.LeftJoinKeyExpression()).GetColIdx();
+      auto right_col_idx =
+          dynamic_cast<const ColumnValueExpression &>(merge_join.RightJoinKeyExpression()).GetColIdx();
+      auto left_column_cnt = merge_join.GetLeftPlan()->OutputSchema().GetColumnCount();
+      if (col_idx == left_col_idx ||
+          (merge_join.GetJoinType() == JoinType::INNER && col_idx == left_column_cnt + right_col_idx)) {
+        return plan;
+      }
+      return nullptr;
+    }
+    default:
+      return nullptr;
+  }
+}
+
+auto Optimizer::OptimizeHashJoinAsMergeJoin(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeHashJoinAsMergeJoin(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  if (optimized_plan->GetType() == PlanType::HashJoin) {
+    // Both inputs are ordered on the join keys already, merging them needs neither a hash table nor a sort.
+    const auto &hash_join = dynamic_cast<const HashJoinPlanNode &>(*optimized_plan);
+    const auto *left_key = dynamic_cast<const ColumnValueExpression *>(hash_join.left_key_expression_.get());
+    const auto *right_key = dynamic_cast<const ColumnValueExpression *>(hash_join.right_key_expression_.get());
+    if (left_key == nullptr || right_key == nullptr) {
+      return optimized_plan;
+    }
+    auto left = MakeOrderedOn(hash_join.GetLeftPlan(), left_key->GetColIdx(), false);
+    auto right = MakeOrderedOn(hash_join.GetRightPlan(), right_key->GetColIdx(), false);
+    if (left != nullptr && right != nullptr) {
+      return std::make_shared<MergeJoinPlanNode>(hash_join.output_schema_, std::move(left), std::move(right),
+                                                 hash_join.left_key_expression_, hash_join.right_key_expression_,
+                                                 hash_join.GetJoinType());
+    }
+    return optimized_plan;
+  }
+
+  if (optimized_plan->GetType() == PlanType::Sort) {
+    const auto &sort_plan = dynamic_cast<const SortPlanNode &>(*optimized_plan);
+    auto order_by_col_idx = LeadingAscendingColumn(sort_plan);
+    if (sort_plan.GetOrderBy().size() != 1 || order_by_col_idx == std::nullopt) {
+      return optimized_plan;
+    }
+    const auto &child_plan = sort_plan.GetChildPlan();
+    // The input is ordered already, e.g. by a merge join on the same key.
+    if (auto ordered = MakeOrderedOn(child_plan, *order_by_col_idx, false); ordered != nullptr) {
+      return ordered;
+    }
+    if (child_plan->GetType() != PlanType::HashJoin) {
+      return optimized_plan;
+    }
+
+    // The join output has to be sorted on the join key anyway. If one input is ordered on it, sorting the other one
+    // and merging them replaces both the hash table and the sort of the output.
+    const auto &hash_join = dynamic_cast<const HashJoinPlanNode &>(*child_plan);
+    const auto *left_key = dynamic_cast<const ColumnValueExpression *>(hash_join.left_key_expression_.get());
+    const auto *right_key = dynamic_cast<const ColumnValueExpression *>(hash_join.right_key_expression_.get());
+    if (left_key == nullptr || right_key == nullptr) {
+      return optimized_plan;
+    }
+    auto left_column_cnt = hash_join.GetLeftPlan()->OutputSchema().GetColumnCount();
+    auto sorts_on_left_key = *order_by_col_idx == left_key->GetColIdx();
+    auto sorts_on_right_key = *order_by_col_idx == left_column_cnt + right_key->GetColIdx();
+    if (!(sorts_on_left_key || (hash_join.GetJoinType() == JoinType::INNER && sorts_on_right_key))) {
+      return optimized_plan;
+    }
+    auto left = MakeOrderedOn(hash_join.GetLeftPlan(), left_key->GetColIdx(), false);
+    auto right = MakeOrderedOn(hash_join.GetRightPlan(), right_key->GetColIdx(), false);
+    if (left == nullptr && right == nullptr) {
+      return optimized_plan;
+    }
+    auto sort_on = [](const AbstractPlanNodeRef &input, const ColumnValueExpression &key) -> AbstractPlanNodeRef {
+      auto key_expr = std::make_shared<ColumnValueExpression>(0, key.GetColIdx(), key.GetReturnType());
+      return std::make_shared<SortPlanNode>(input->output_schema_, input,
+                                            std::vector<std::pair<OrderByType, AbstractExpressionRef>>{
+                                                {OrderByType::ASC, std::move(key_expr)}});
+    };
+    if (left == nullptr) {
+      left = sort_on(hash_join.GetLeftPlan(), *left_key);
+    }
+    if (right == nullptr) {
+      right = sort_on(hash_join.GetRightPlan(), *right_key);
+    }
+    return std::make_shared<MergeJoinPlanNode>(hash_join.output_schema_, std::move(left), std::move(right),
+                                               hash_join.left_key_expression_, hash_join.right_key_expression_,
+                                               hash_join.GetJoinType());
+  }
+
+  return optimized_plan;
+}
+
+}  // namespace bustub
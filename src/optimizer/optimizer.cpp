@@ -1,7 +1,13 @@
 #include "optimizer/optimizer.h"
+#include <algorithm>
 #include <optional>
 #include "common/util/string_util.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
 #include "execution/plans/abstract_plan.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
@@ -21,6 +27,9 @@ auto Optimizer::Optimize(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef
 }
 
 auto Optimizer::EstimatedCardinality(const std::string &table_name) -> std::optional<size_t> {
+  if (auto *table_info = catalog_.GetTable(table_name); table_info != nullptr && table_info->table_ != nullptr) {
+    return std::make_optional(table_info->stats_.GetRowCount());
+  }
   if (StringUtil::EndsWith(table_name, "_1m")) {
     return std::make_optional(1000000);
   }
@@ -42,4 +51,117 @@ auto Optimizer::EstimatedCardinality(const std::string &table_name) -> std::opti
   return std::nullopt;
 }
 
+void Optimizer::FlattenLogic(const AbstractExpressionRef &expr, LogicType logic_type,
+                             std::vector<AbstractExpressionRef> *terms) {
+  if (const auto *logic_expr = dynamic_cast<const LogicExpression *>(expr.get());
+      logic_expr != nullptr && logic_expr->logic_type_ == logic_type) {
+    FlattenLogic(expr->GetChildAt(0), logic_type, terms);
+    FlattenLogic(expr->GetChildAt(1), logic_type, terms);
+    return;
+  }
+  terms->push_back(expr);
+}
+
+auto Optimizer::MakeConjunction(const std::vector<AbstractExpressionRef> &conjuncts) -> AbstractExpressionRef {
+  if (conjuncts.empty()) {
+    return std::make_shared<ConstantValueExpression>(ValueFactory::GetBooleanValue(true));
+  }
+  auto expr = conjuncts[0];
+  for (size_t i = 1; i < conjuncts.size(); i++) {
+    expr = std::make_shared<LogicExpression>(expr, conjuncts[i], LogicType::And);
+  }
+  return expr;
+}
+
+auto Optimizer::FlipComparison(ComparisonType comp_type) -> ComparisonType {
+  switch (comp_type) {
+    case ComparisonType::LessThan:
+      return ComparisonType::GreaterThan;
+    case ComparisonType::LessThanOrEqual:
+      return ComparisonType::GreaterThanOrEqual;
+    case ComparisonType::GreaterThan:
+      return ComparisonType::LessThan;
+    case ComparisonType::GreaterThanOrEqual:
+      return ComparisonType::LessThanOrEqual;
+    default:
+      return comp_type;
+  }
+}
+
+auto Optimizer::RewriteColumns(const AbstractExpressionRef &expr,
+                               const std::function<AbstractExpressionRef(const ColumnValueExpression &)> &rewrite)
+    -> AbstractExpressionRef {
+  if (const auto *column_value_expr = dynamic_cast<const ColumnValueExpression *>(expr.get());
+      column_value_expr != nullptr) {
+    return rewrite(*column_value_expr);
+  }
+  std::vector<AbstractExpressionRef> children;
+  for (const auto &child : expr->GetChildren()) {
+    children.emplace_back(RewriteColumns(child, rewrite));
+  }
+  return expr->CloneWithChildren(std::move(children));
+}
+
+namespace {
+
+/** The selectivities of terms the statistics cannot estimate */
+constexpr double DEFAULT_EQUAL_SELECTIVITY = 0.005;
+constexpr double DEFAULT_SELECTIVITY = 1.0 / 3;
+
+}  // namespace
+
+auto Optimizer::EstimateSelectivity(const std::string &table_name, const AbstractExpressionRef &predicate) -> double {
+  if (const auto *logic_expr = dynamic_cast<const LogicExpression *>(predicate.get()); logic_expr != nullptr) {
+    // Terms are assumed to be independent.
+    auto left = EstimateSelectivity(table_name, predicate->GetChildAt(0));
+    auto right = EstimateSelectivity(table_name, predicate->GetChildAt(1));
+    return logic_expr->logic_type_ == LogicType::And ? left * right : left + right - left * right;
+  }
+  if (const auto *constant_expr = dynamic_cast<const ConstantValueExpression *>(predicate.get());
+      constant_expr != nullptr && constant_expr->val_.GetTypeId() == TypeId::BOOLEAN) {
+    return constant_expr->val_.IsNull() || !constant_expr->val_.GetAs<bool>() ? 0 : 1;
+  }
+
+  const auto *comparison_expr = dynamic_cast<const ComparisonExpression *>(predicate.get());
+  if (comparison_expr == nullptr) {
+    return DEFAULT_SELECTIVITY;
+  }
+  auto comp_type = comparison_expr->comp_type_;
+  auto default_selectivity = comp_type == ComparisonType::Equal       ? DEFAULT_EQUAL_SELECTIVITY
+                             : comp_type == ComparisonType::NotEqual ? 1 - DEFAULT_EQUAL_SELECTIVITY
+                                                                      : DEFAULT_SELECTIVITY;
+  const auto *column_value_expr = dynamic_cast<const ColumnValueExpression *>(predicate->GetChildAt(0).get());
+  const auto *constant_value_expr = dynamic_cast<const ConstantValueExpression *>(predicate->GetChildAt(1).get());
+  if (column_value_expr == nullptr) {
+    column_value_expr = dynamic_cast<const ColumnValueExpression *>(predicate->GetChildAt(1).get());
+    constant_value_expr = dynamic_cast<const ConstantValueExpression *>(predicate->GetChildAt(0).get());
+    comp_type = FlipComparison(comp_type);
+  }
+  auto *table_info = catalog_.GetTable(table_name);
+  if (column_value_expr == nullptr || constant_value_expr == nullptr || table_info == nullptr) {
+    return default_selectivity;
+  }
+  const auto *column_stats = table_info->stats_.GetColumnStats(column_value_expr->GetColIdx());
+  if (column_stats == nullptr) {
+    return default_selectivity;
+  }
+
+  const auto &value = constant_value_expr->val_;
+  switch (comp_type) {
+    case ComparisonType::Equal:
+      return column_stats->EstimateEqual(value);
+    case ComparisonType::NotEqual:
+      return std::max(1 - column_stats->GetNullFraction() - column_stats->EstimateEqual(value), 0.0);
+    case ComparisonType::LessThan:
+      return column_stats->EstimateLess(value, false);
+    case ComparisonType::LessThanOrEqual:
+      return column_stats->EstimateLess(value, true);
+    case ComparisonType::GreaterThan:
+      return column_stats->EstimateGreater(value, false);
+    case ComparisonType::GreaterThanOrEqual:
+      return column_stats->EstimateGreater(value, true);
+  }
+  return default_selectivity;
+}
+
 }  // namespace bustub
@@ -9,11 +9,18 @@ namespace bustub {
 
 auto Optimizer::OptimizeCustom(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
   auto p = plan;
+  p = OptimizeFoldConstants(p);
   p = OptimizeMergeProjection(p);
+  p = OptimizePushDownFilter(p);
   p = OptimizeMergeFilterNLJ(p);
+  p = OptimizeReorderJoins(p);
   p = OptimizeNLJAsIndexJoin(p);
-  // p = OptimizeNLJAsHashJoin(p);  // Enable this rule after you have implemented hash join.
+  p = OptimizeNLJAsHashJoin(p);
   p = OptimizeOrderByAsIndexScan(p);
+  p = OptimizeSeqScanAsIndexScan(p);
+  p = OptimizeSeqScanAsBitmapScan(p);
+  p = OptimizeHashJoinAsMergeJoin(p);
+  p = OptimizeAggregationAsStreamAggregation(p);
   p = OptimizeSortLimitAsTopN(p);
   return p;
 }
@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/aggregation_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/nested_loop_join_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+namespace {
+
+void CollectColumns(const AbstractExpression &expr, std::vector<const ColumnValueExpression *> *columns) {
+  if (const auto *column_value_expr = dynamic_cast<const ColumnValueExpression *>(&expr);
+      column_value_expr != nullptr) {
+    columns->push_back(column_value_expr);
+    return;
+  }
+  for (const auto &child : expr.GetChildren()) {
+    CollectColumns(*child, columns);
+  }
+}
+
+auto ColumnsOf(const AbstractExpression &expr) -> std::vector<const ColumnValueExpression *> {
+  std::vector<const ColumnValueExpression *> columns;
+  CollectColumns(expr, &columns);
+  return columns;
+}
+
+/** @return the plan with the conjuncts that could not be pushed into it checked on its output */
+auto WithFilter(AbstractPlanNodeRef plan, const std::vector<AbstractExpressionRef> &conjuncts) -> AbstractPlanNodeRef {
+  if (conjuncts.empty()) {
+    return plan;
+  }
+  auto output_schema = plan->output_schema_;
+  return std::make_shared<FilterPlanNode>(std::move(output_schema), Optimizer::MakeConjunction(conjuncts),
+                                          std::move(plan));
+}
+
+}  // namespace
+
+auto Optimizer::OptimizePushDownFilter(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  return PushDownFilter(plan, {});
+}
+
+auto Optimizer::PushDownFilter(const AbstractPlanNodeRef &plan, std::vector<AbstractExpressionRef> conjuncts)
+    -> AbstractPlanNodeRef {
+  switch (plan->GetType()) {
+    case PlanType::Filter: {
+      std::vector<AbstractExpressionRef> terms;
+      FlattenLogic(dynamic_cast<const FilterPlanNode &>(*plan).GetPredicate(), LogicType::And, &terms);
+      std::copy_if(terms.begin(), terms.end(), std::back_inserter(conjuncts),
+                   [&](const AbstractExpressionRef &term) { return !IsPredicateTrue(*term); });
+      return PushDownFilter(plan->GetChildAt(0), std::move(conjuncts));
+    }
+    case PlanType::Projection: {
+      // Checking the projected expressions on the input is the same as checking their columns on the output.
+      const auto &exprs = dynamic_cast<const ProjectionPlanNode &>(*plan).GetExpressions();
+      for (auto &conjunct : conjuncts) {
+        conjunct =
+            RewriteColumns(conjunct, [&](const ColumnValueExpression &column) { return exprs[column.GetColIdx()]; });
+      }
+      return plan->CloneWithChildren({PushDownFilter(plan->GetChildAt(0), std::move(conjuncts))});
+    }
+    case PlanType::Sort:
+      return plan->CloneWithChildren({PushDownFilter(plan->GetChildAt(0), std::move(conjuncts))});
+    case PlanType::Aggregation: {
+      // A conjunct over group by columns only keeps or drops whole groups, so it can drop their rows before
+      // aggregating. Without group bys there is exactly one output row even if no row is left.
+      const auto &group_bys = dynamic_cast<const AggregationPlanNode &>(*plan).GetGroupBys();
+      std::vector<AbstractExpressionRef> below;
+      std::vector<AbstractExpressionRef> above;
+      for (auto &conjunct : conjuncts) {
+        auto columns = ColumnsOf(*conjunct);
+        if (!group_bys.empty() && std::all_of(columns.begin(), columns.end(), [&](const auto *column) {
+              return column->GetColIdx() < group_bys.size();
+            })) {
+          below.push_back(RewriteColumns(
+              conjunct, [&](const ColumnValueExpression &column) { return group_bys[column.GetColIdx()]; }));
+        } else {
+          above.push_back(std::move(conjunct));
+        }
+      }
+      return WithFilter(plan->CloneWithChildren({PushDownFilter(plan->GetChildAt(0), std::move(below))}), above);
+    }
+    case PlanType::NestedLoopJoin: {
+      const auto &nlj_plan = dynamic_cast<const NestedLoopJoinPlanNode &>(*plan);
+      auto join_type = nlj_plan.GetJoinType();
+      if (join_type != JoinType::INNER && join_type != JoinType::LEFT) {
+        break;
+      }
+      // A left join keeps every left row, so only conjuncts dropping left rows after the join and conjuncts of the
+      // join predicate dropping right rows may be moved.
+      auto is_inner = join_type == JoinType::INNER;
+      auto left_column_cnt = nlj_plan.GetLeftPlan()->OutputSchema().GetColumnCount();
+      auto right_column_cnt = nlj_plan.GetRightPlan()->OutputSchema().GetColumnCount();
+      std::vector<AbstractExpressionRef> left_conjuncts;
+      std::vector<AbstractExpressionRef> right_conjuncts;
+      std::vector<AbstractExpressionRef> join_conjuncts;
+      std::vector<AbstractExpressionRef> above;
+
+      for (auto &conjunct : conjuncts) {
+        auto columns = ColumnsOf(*conjunct);
+        auto uses_left = std::any_of(columns.begin(), columns.end(),
+                                     [&](const auto *column) { return column->GetColIdx() < left_column_cnt; });
+        auto uses_right = std::any_of(columns.begin(), columns.end(),
+                                      [&](const auto *column) { return column->GetColIdx() >= left_column_cnt; });
+        if (!uses_right) {
+          left_conjuncts.push_back(std::move(conjunct));
+        } else if (!is_inner) {
+          above.push_back(std::move(conjunct));
+        } else if (!uses_left) {
+          right_conjuncts.push_back(RewriteColumns(conjunct, [&](const ColumnValueExpression &column) {
+            return std::make_shared<ColumnValueExpression>(0, column.GetColIdx() - left_column_cnt,
+                                                           column.GetReturnType());
+          }));
+        } else {
+          join_conjuncts.push_back(RewriteExpressionForJoin(conjunct, left_column_cnt, right_column_cnt));
+        }
+      }
+
+      std::vector<AbstractExpressionRef> terms;
+      FlattenLogic(nlj_plan.predicate_, LogicType::And, &terms);
+      for (auto &term : terms) {
+        if (IsPredicateTrue(*term)) {
+          continue;
+        }
+        auto columns = ColumnsOf(*term);
+        auto uses_left = std::any_of(columns.begin(), columns.end(),
+                                     [](const auto *column) { return column->GetTupleIdx() == 0; });
+        auto uses_right = std::any_of(columns.begin(), columns.end(),
+                                      [](const auto *column) { return column->GetTupleIdx() == 1; });
+        if (is_inner && uses_left && !uses_right) {
+          left_conjuncts.push_back(std::move(term));
+        } else if (uses_right && !uses_left) {
+          right_conjuncts.push_back(RewriteColumns(term, [](const ColumnValueExpression &column) {
+            return std::make_shared<ColumnValueExpression>(0, column.GetColIdx(), column.GetReturnType());
+          }));
+        } else {
+          join_conjuncts.push_back(std::move(term));
+        }
+      }
+
+      auto left = PushDownFilter(nlj_plan.GetLeftPlan(), std::move(left_conjuncts));
+      auto right = PushDownFilter(nlj_plan.GetRightPlan(), std::move(right_conjuncts));
+      return WithFilter(std::make_shared<NestedLoopJoinPlanNode>(nlj_plan.output_schema_, std::move(left),
+                                                                 std::move(right), MakeConjunction(join_conjuncts),
+                                                                 join_type),
+                        above);
+    }
+    default:
+      break;
+  }
+
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(PushDownFilter(child, {}));
+  }
+  return WithFilter(plan->CloneWithChildren(std::move(children)), conjuncts);
+}
+
+}  // namespace bustub
@@ -0,0 +1,558 @@
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "common/macros.h"
+#include "execution/executors/mock_scan_executor.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/aggregation_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/limit_plan.h"
+#include "execution/plans/mock_scan_plan.h"
+#include "execution/plans/nested_loop_join_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "execution/plans/topn_plan.h"
+#include "execution/plans/values_plan.h"
+#include "optimizer/optimizer.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+/** Every split of every subset of inputs is tried up to this many inputs, larger joins are ordered greedily */
+constexpr size_t DP_MAX_INPUTS = 10;
+/** Join trees are only reordered up to this many inputs, so that every set of inputs fits in a bitmask */
+constexpr size_t MAX_INPUTS = 64;
+/** The cost of an index lookup relative to reading one tuple */
+constexpr double INDEX_LOOKUP_COST = 4;
+/** The cost of inserting a tuple into a hash table relative to probing it */
+constexpr double HASH_BUILD_COST = 2;
+/** The number of rows assumed for inputs of unknown size */
+constexpr double DEFAULT_ROWS = 1000;
+
+/**
+ * How two sets of inputs are joined. The join is planned as a nested loop join, and the join method is the one the
+ * later rules turn it into.
+ */
+enum class JoinMethod { Input, NestedLoop, Hash, Index };
+
+/** An input of a join tree, i.e. a subplan that is not itself an inner join */
+struct JoinInput {
+  AbstractPlanNodeRef plan_;
+  /** The global index of the first column of the input, columns of all inputs are numbered consecutively */
+  size_t offset_;
+  /** The estimated number of rows of the plan */
+  double rows_;
+  /** The table scanned, if the input is a table scan, for statistics */
+  std::string table_name_;
+  /** Per column, whether the input can be the inner side of an index join on it */
+  std::vector<bool> indexed_;
+};
+
+/** A conjunct of the predicates of a join tree. Columns are referenced by their global index, with tuple index 0. */
+struct JoinConjunct {
+  AbstractExpressionRef expr_;
+  /** The inputs whose columns the conjunct references */
+  uint64_t inputs_;
+  /** The estimated fraction of rows the conjunct keeps */
+  double selectivity_;
+  /** For `column = column` over two inputs, the global indexes of the two columns */
+  std::optional<std::pair<size_t, size_t>> equi_columns_;
+};
+
+/** The cheapest way found to join a set of inputs */
+struct JoinChoice {
+  JoinMethod method_;
+  /** The inputs of the left and the right side, not used for a single input */
+  uint64_t left_;
+  uint64_t right_;
+  double rows_;
+  double cost_;
+};
+
+/** A part of the new join tree, with the global indexes of the columns it outputs */
+struct JoinPart {
+  AbstractPlanNodeRef plan_;
+  std::vector<size_t> columns_;
+};
+
+auto IsSubset(uint64_t inputs, uint64_t of) -> bool { return (inputs & ~of) == 0; }
+
+/** @return the index of the input producing a global column */
+auto InputOf(const std::vector<JoinInput> &inputs, size_t column) -> size_t {
+  auto it = std::upper_bound(inputs.begin(), inputs.end(), column,
+                             [](size_t column, const JoinInput &input) { return column < input.offset_; });
+  return it - inputs.begin() - 1;
+}
+
+/** Rewrite an expression over global column indexes to one over the columns of the plans joined */
+auto ToJoinColumns(const AbstractExpressionRef &expr, const std::vector<const std::vector<size_t> *> &tuples)
+    -> AbstractExpressionRef {
+  return Optimizer::RewriteColumns(expr, [&](const ColumnValueExpression &column) -> AbstractExpressionRef {
+    for (size_t tuple_idx = 0; tuple_idx < tuples.size(); tuple_idx++) {
+      const auto &columns = *tuples[tuple_idx];
+      if (auto it = std::find(columns.begin(), columns.end(), column.GetColIdx()); it != columns.end()) {
+        return std::make_shared<ColumnValueExpression>(tuple_idx, it - columns.begin(), column.GetReturnType());
+      }
+    }
+    UNREACHABLE("column not produced by the join inputs");
+  });
+}
+
+/** Whether a plan is an inner join, possibly under filters and projections of columns */
+auto IsJoinTree(const AbstractPlanNode &plan) -> bool {
+  switch (plan.GetType()) {
+    case PlanType::NestedLoopJoin:
+      return dynamic_cast<const NestedLoopJoinPlanNode &>(plan).GetJoinType() == JoinType::INNER;
+    case PlanType::Filter:
+      return IsJoinTree(*plan.GetChildAt(0));
+    case PlanType::Projection: {
+      const auto &exprs = dynamic_cast<const ProjectionPlanNode &>(plan).GetExpressions();
+      return std::all_of(exprs.begin(), exprs.end(),
+                         [](const auto &expr) {
+                           return dynamic_cast<const ColumnValueExpression *>(expr.get()) != nullptr;
+                         }) &&
+             IsJoinTree(*plan.GetChildAt(0));
+    }
+    default:
+      return false;
+  }
+}
+
+/**
+ * JoinOrder finds the cheapest order and join methods for the inputs and predicates of a join tree, and builds the
+ * new join tree.
+ */
+class JoinOrder {
+ public:
+  JoinOrder(std::vector<JoinInput> inputs, std::vector<JoinConjunct> conjuncts)
+      : inputs_(std::move(inputs)), conjuncts_(std::move(conjuncts)) {}
+
+  /** Choose how to join all inputs */
+  void Enumerate() {
+    for (size_t i = 0; i < inputs_.size(); i++) {
+      uint64_t input = uint64_t{1} << i;
+      choices_[input] = JoinChoice{JoinMethod::Input, 0, 0, Rows(input), inputs_[i].rows_};
+    }
+    if (inputs_.size() <= DP_MAX_INPUTS) {
+      EnumerateDP();
+    } else {
+      EnumerateGreedy();
+    }
+  }
+
+  /** Build the join tree of the inputs as chosen */
+  auto Build() -> JoinPart { return Build(All()); }
+
+ private:
+  auto All() const -> uint64_t {
+    return inputs_.size() == MAX_INPUTS ? ~uint64_t{0} : (uint64_t{1} << inputs_.size()) - 1;
+  }
+
+  /** The number of rows of a join depends only on the inputs joined, not on the order they are joined in. */
+  auto Rows(uint64_t inputs) const -> double {
+    double rows = 1;
+    for (size_t i = 0; i < inputs_.size(); i++) {
+      if ((inputs >> i & 1) != 0) {
+        rows *= inputs_[i].rows_;
+      }
+    }
+    for (const auto &conjunct : conjuncts_) {
+      if (IsSubset(conjunct.inputs_, inputs)) {
+        rows *= conjunct.selectivity_;
+      }
+    }
+    return std::max(rows, 1.0);
+  }
+
+  /** @return the conjunct to look up the single right input by in an index, if any */
+  auto IndexConjunct(uint64_t left, uint64_t right) const -> const JoinConjunct * {
+    if ((right & (right - 1)) != 0) {
+      return nullptr;
+    }
+    const auto &input = inputs_[__builtin_ctzll(right)];
+    for (const auto &conjunct : conjuncts_) {
+      if (!conjunct.equi_columns_.has_value() || !IsSubset(conjunct.inputs_, left | right) ||
+          IsSubset(conjunct.inputs_, left)) {
+        continue;
+      }
+      auto [first, second] = *conjunct.equi_columns_;
+      auto right_column = IsSubset(uint64_t{1} << InputOf(inputs_, first), right) ? first : second;
+      if (input.indexed_[right_column - input.offset_]) {
+        return &conjunct;
+      }
+    }
+    return nullptr;
+  }
+
+  /** @return the conjunct to hash the two sides on, if any */
+  auto HashConjunct(uint64_t left, uint64_t right) const -> const JoinConjunct * {
+    for (const auto &conjunct : conjuncts_) {
+      if (conjunct.equi_columns_.has_value() && IsSubset(conjunct.inputs_, left | right) &&
+          !IsSubset(conjunct.inputs_, left) && !IsSubset(conjunct.inputs_, right)) {
+        return &conjunct;
+      }
+    }
+    return nullptr;
+  }
+
+  auto HasLocalConjuncts(uint64_t input) const -> bool {
+    return std::any_of(conjuncts_.begin(), conjuncts_.end(),
+                       [&](const JoinConjunct &conjunct) { return conjunct.inputs_ == input; });
+  }
+
+  /** @return the cheapest way to join the choices made for two sets of inputs */
+  auto ChooseJoin(uint64_t left, uint64_t right) const -> JoinChoice {
+    const auto &left_choice = choices_.at(left);
+    const auto &right_choice = choices_.at(right);
+    auto rows = Rows(left | right);
+    // An index join scans neither the right input nor a hash table, but filters the right input only after the
+    // lookup. The later rules always pick it for a plain table scan with a matching index.
+    auto index_cost = left_choice.cost_ + left_choice.rows_ * INDEX_LOOKUP_COST + rows;
+    if (IndexConjunct(left, right) != nullptr && !HasLocalConjuncts(right)) {
+      return JoinChoice{JoinMethod::Index, left, right, rows, index_cost};
+    }
+    auto inputs_cost = left_choice.cost_ + right_choice.cost_;
+    auto choice = JoinChoice{JoinMethod::NestedLoop, left, right, rows,
+                             inputs_cost + left_choice.rows_ * right_choice.rows_ + rows};
+    if (HashConjunct(left, right) != nullptr) {
+      choice = JoinChoice{JoinMethod::Hash, left, right, rows,
+                          inputs_cost + left_choice.rows_ + HASH_BUILD_COST * right_choice.rows_ + rows};
+    }
+    if (IndexConjunct(left, right) != nullptr && index_cost < choice.cost_) {
+      choice = JoinChoice{JoinMethod::Index, left, right, rows, index_cost};
+    }
+    return choice;
+  }
+
+  /** Find the cheapest plan for every set of inputs from the plans of its subsets (DPsize over bitmasks) */
+  void EnumerateDP() {
+    for (uint64_t inputs = 1; inputs <= All(); inputs++) {
+      if ((inputs & (inputs - 1)) == 0) {
+        continue;
+      }
+      std::optional<JoinChoice> best;
+      for (uint64_t left = (inputs - 1) & inputs; left != 0; left = (left - 1) & inputs) {
+        auto choice = ChooseJoin(left, inputs ^ left);
+        if (!best.has_value() || choice.cost_ < best->cost_) {
+          best = choice;
+        }
+      }
+      choices_[inputs] = *best;
+    }
+  }
+
+  /** Join the two sets of inputs that are cheapest to join until all inputs are joined */
+  void EnumerateGreedy() {
+    std::vector<uint64_t> parts;
+    for (size_t i = 0; i < inputs_.size(); i++) {
+      parts.push_back(uint64_t{1} << i);
+    }
+    while (parts.size() > 1) {
+      std::optional<JoinChoice> best;
+      double best_own_cost = 0;
+      for (auto left : parts) {
+        for (auto right : parts) {
+          if (left == right) {
+            continue;
+          }
+          // Compare the joins by their own work, not by the work of joining their inputs so far.
+          auto choice = ChooseJoin(left, right);
+          auto own_cost = choice.cost_ - choices_[left].cost_ - choices_[right].cost_;
+          if (!best.has_value() || own_cost < best_own_cost) {
+            best = choice;
+            best_own_cost = own_cost;
+          }
+        }
+      }
+      choices_[best->left_ | best->right_] = *best;
+      parts.erase(std::remove_if(parts.begin(), parts.end(),
+                                 [&](uint64_t part) { return part == best->left_ || part == best->right_; }),
+                  parts.end());
+      parts.push_back(best->left_ | best->right_);
+    }
+  }
+
+  auto Build(uint64_t inputs) -> JoinPart {
+    const auto &choice = choices_.at(inputs);
+    if (choice.method_ == JoinMethod::Input) {
+      auto part = BuildInput(__builtin_ctzll(inputs));
+      std::vector<AbstractExpressionRef> local;
+      for (const auto &conjunct : conjuncts_) {
+        if (conjunct.inputs_ == inputs) {
+          local.push_back(ToJoinColumns(conjunct.expr_, {&part.columns_}));
+        }
+      }
+      if (!local.empty()) {
+        part.plan_ =
+            std::make_shared<FilterPlanNode>(part.plan_->output_schema_, Optimizer::MakeConjunction(local), part.plan_);
+      }
+      return part;
+    }
+
+    auto left = Build(choice.left_);
+    // The right input of an index join must be the table scan itself, its own conjuncts are checked after the join.
+    auto right =
+        choice.method_ == JoinMethod::Index ? BuildInput(__builtin_ctzll(choice.right_)) : Build(choice.right_);
+    const JoinConjunct *join_conjunct = nullptr;
+    if (choice.method_ == JoinMethod::Index) {
+      join_conjunct = IndexConjunct(choice.left_, choice.right_);
+    } else if (choice.method_ == JoinMethod::Hash) {
+      join_conjunct = HashConjunct(choice.left_, choice.right_);
+    }
+
+    std::vector<AbstractExpressionRef> join_predicate;
+    std::vector<AbstractExpressionRef> residual;
+    for (const auto &conjunct : conjuncts_) {
+      auto applies = IsSubset(conjunct.inputs_, inputs) && !IsSubset(conjunct.inputs_, choice.left_) &&
+                     (!IsSubset(conjunct.inputs_, choice.right_) || choice.method_ == JoinMethod::Index);
+      if (!applies) {
+        continue;
+      }
+      if (join_conjunct == nullptr) {
+        join_predicate.push_back(ToJoinColumns(conjunct.expr_, {&left.columns_, &right.columns_}));
+      } else if (&conjunct == join_conjunct) {
+        // The key of the left side must be on the left of `=` for the index join.
+        auto left_key = conjunct.expr_->GetChildAt(0);
+        auto right_key = conjunct.expr_->GetChildAt(1);
+        if (IsSubset(uint64_t{1} << InputOf(inputs_, conjunct.equi_columns_->first), choice.right_)) {
+          std::swap(left_key, right_key);
+        }
+        join_predicate.push_back(
+            std::make_shared<ComparisonExpression>(ToJoinColumns(left_key, {&left.columns_, &right.columns_}),
+                                                   ToJoinColumns(right_key, {&left.columns_, &right.columns_}),
+                                                   ComparisonType::Equal));
+      } else {
+        residual.push_back(conjunct.expr_);
+      }
+    }
+
+    JoinPart part;
+    part.columns_ = left.columns_;
+    part.columns_.insert(part.columns_.end(), right.columns_.begin(), right.columns_.end());
+    part.plan_ = std::make_shared<NestedLoopJoinPlanNode>(
+        std::make_shared<Schema>(NestedLoopJoinPlanNode::InferJoinSchema(*left.plan_, *right.plan_)), left.plan_,
+        right.plan_, Optimizer::MakeConjunction(join_predicate), JoinType::INNER);
+    if (!residual.empty()) {
+      for (auto &expr : residual) {
+        expr = ToJoinColumns(expr, {&part.columns_});
+      }
+      part.plan_ = std::make_shared<FilterPlanNode>(part.plan_->output_schema_, Optimizer::MakeConjunction(residual),
+                                                    part.plan_);
+    }
+    return part;
+  }
+
+  auto BuildInput(size_t i) const -> JoinPart {
+    JoinPart part{inputs_[i].plan_, {}};
+    for (size_t col = 0; col < inputs_[i].plan_->OutputSchema().GetColumnCount(); col++) {
+      part.columns_.push_back(inputs_[i].offset_ + col);
+    }
+    return part;
+  }
+
+  std::vector<JoinInput> inputs_;
+  std::vector<JoinConjunct> conjuncts_;
+  std::unordered_map<uint64_t, JoinChoice> choices_;
+};
+
+}  // namespace
+
+auto Optimizer::EstimateRows(const AbstractPlanNodeRef &plan) -> double {
+  switch (plan->GetType()) {
+    case PlanType::SeqScan: {
+      const auto &seq_scan = dynamic_cast<const SeqScanPlanNode &>(*plan);
+      auto rows = static_cast<double>(EstimatedCardinality(seq_scan.table_name_).value_or(DEFAULT_ROWS));
+      if (seq_scan.filter_predicate_ != nullptr) {
+        rows *= EstimateSelectivity(seq_scan.table_name_, seq_scan.filter_predicate_);
+      }
+      return rows;
+    }
+    case PlanType::MockScan:
+      return GetSizeOf(dynamic_cast<const MockScanPlanNode *>(plan.get()));
+    case PlanType::Values:
+      return dynamic_cast<const ValuesPlanNode &>(*plan).GetValues().size();
+    case PlanType::Filter: {
+      const auto &child = plan->GetChildAt(0);
+      auto table_name =
+          child->GetType() == PlanType::SeqScan ? dynamic_cast<const SeqScanPlanNode &>(*child).table_name_ : "";
+      return EstimateRows(child) *
+             EstimateSelectivity(table_name, dynamic_cast<const FilterPlanNode &>(*plan).GetPredicate());
+    }
+    case PlanType::Aggregation:
+      if (dynamic_cast<const AggregationPlanNode &>(*plan).GetGroupBys().empty()) {
+        return 1;
+      }
+      return EstimateRows(plan->GetChildAt(0));
+    case PlanType::Limit:
+      return std::min<double>(EstimateRows(plan->GetChildAt(0)),
+                              dynamic_cast<const LimitPlanNode &>(*plan).GetLimit());
+    case PlanType::TopN:
+      return std::min<double>(EstimateRows(plan->GetChildAt(0)), dynamic_cast<const TopNPlanNode &>(*plan).GetN());
+    default: {
+      // Outer joins produce at least every row of the left input.
+      double rows = plan->GetChildren().empty() ? DEFAULT_ROWS : 0;
+      for (const auto &child : plan->GetChildren()) {
+        rows = std::max(rows, EstimateRows(child));
+      }
+      return rows;
+    }
+  }
+}
+
+auto Optimizer::OptimizeReorderJoins(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  if (!IsJoinTree(*plan)) {
+    std::vector<AbstractPlanNodeRef> children;
+    for (const auto &child : plan->GetChildren()) {
+      children.emplace_back(OptimizeReorderJoins(child));
+    }
+    return plan->CloneWithChildren(std::move(children));
+  }
+
+  // Collect the inputs of the join tree and split its predicates into conjuncts over global column indexes.
+  std::vector<JoinInput> inputs;
+  std::vector<AbstractExpressionRef> predicates;
+  size_t num_columns = 0;
+  std::function<std::vector<size_t>(const AbstractPlanNodeRef &)> flatten =
+      [&](const AbstractPlanNodeRef &node) -> std::vector<size_t> {
+    // A filter on an input is one more predicate, so a filtered table scan can still be looked up in an index.
+    if (!IsJoinTree(*node) && node->GetType() != PlanType::Filter) {
+      auto input = OptimizeReorderJoins(node);
+      auto num_input_columns = input->OutputSchema().GetColumnCount();
+      std::vector<size_t> columns(num_input_columns);
+      std::iota(columns.begin(), columns.end(), num_columns);
+      inputs.push_back(JoinInput{std::move(input), num_columns, 0, "", {}});
+      num_columns += num_input_columns;
+      return columns;
+    }
+    if (node->GetType() == PlanType::Projection) {
+      auto child_columns = flatten(node->GetChildAt(0));
+      std::vector<size_t> columns;
+      for (const auto &expr : dynamic_cast<const ProjectionPlanNode &>(*node).GetExpressions()) {
+        columns.push_back(child_columns[dynamic_cast<const ColumnValueExpression &>(*expr).GetColIdx()]);
+      }
+      return columns;
+    }
+    std::vector<std::vector<size_t>> children_columns;
+    for (const auto &child : node->GetChildren()) {
+      children_columns.push_back(flatten(child));
+    }
+    const auto &predicate = node->GetType() == PlanType::Filter
+                                ? dynamic_cast<const FilterPlanNode &>(*node).GetPredicate()
+                                : dynamic_cast<const NestedLoopJoinPlanNode &>(*node).predicate_;
+    predicates.push_back(RewriteColumns(predicate, [&](const ColumnValueExpression &column) {
+      return std::make_shared<ColumnValueExpression>(
+          0, children_columns[column.GetTupleIdx()][column.GetColIdx()], column.GetReturnType());
+    }));
+    std::vector<size_t> columns;
+    for (const auto &child_columns : children_columns) {
+      columns.insert(columns.end(), child_columns.begin(), child_columns.end());
+    }
+    return columns;
+  };
+  auto output_columns = flatten(plan);
+
+  // Two inputs keep the order they are written in.
+  if (inputs.size() < 3 || inputs.size() > MAX_INPUTS) {
+    std::vector<AbstractPlanNodeRef> children;
+    for (const auto &child : plan->GetChildren()) {
+      children.emplace_back(OptimizeReorderJoins(child));
+    }
+    return plan->CloneWithChildren(std::move(children));
+  }
+
+  for (auto &input : inputs) {
+    input.rows_ = std::max(EstimateRows(input.plan_), 1.0);
+    input.indexed_.assign(input.plan_->OutputSchema().GetColumnCount(), false);
+    if (input.plan_->GetType() == PlanType::SeqScan) {
+      const auto &seq_scan = dynamic_cast<const SeqScanPlanNode &>(*input.plan_);
+      input.table_name_ = seq_scan.table_name_;
+      for (uint32_t col = 0; col < input.indexed_.size() && seq_scan.filter_predicate_ == nullptr; col++) {
+        input.indexed_[col] = MatchIndex(seq_scan.table_name_, col).has_value();
+      }
+    }
+  }
+  auto input_of = [&](size_t column) { return InputOf(inputs, column); };
+  // Without statistics, a column is assumed to be a key of its input.
+  auto distinct_count = [&](size_t column) -> double {
+    const auto &input = inputs[input_of(column)];
+    if (auto *table_info = catalog_.GetTable(input.table_name_); table_info != nullptr) {
+      if (const auto *stats = table_info->stats_.GetColumnStats(column - input.offset_); stats != nullptr) {
+        return std::max<double>(stats->GetDistinctCount(), 1);
+      }
+    }
+    return input.rows_;
+  };
+
+  std::vector<JoinConjunct> conjuncts;
+  for (const auto &predicate : predicates) {
+    std::vector<AbstractExpressionRef> terms;
+    FlattenLogic(predicate, LogicType::And, &terms);
+    for (auto &term : terms) {
+      if (IsPredicateTrue(*term)) {
+        continue;
+      }
+      uint64_t term_inputs = 0;
+      RewriteColumns(term, [&](const ColumnValueExpression &column) -> AbstractExpressionRef {
+        term_inputs |= uint64_t{1} << input_of(column.GetColIdx());
+        return std::make_shared<ColumnValueExpression>(column);
+      });
+      // Constant conjuncts are checked on the first input.
+      term_inputs = term_inputs == 0 ? 1 : term_inputs;
+      JoinConjunct conjunct{term, term_inputs, 0, std::nullopt};
+
+      const auto *comparison_expr = dynamic_cast<const ComparisonExpression *>(term.get());
+      const auto *left_column = dynamic_cast<const ColumnValueExpression *>(term->GetChildAt(0).get());
+      const auto *right_column =
+          term->GetChildren().size() == 2 ? dynamic_cast<const ColumnValueExpression *>(term->GetChildAt(1).get())
+                                          : nullptr;
+      if ((term_inputs & (term_inputs - 1)) == 0) {
+        const auto &input = inputs[__builtin_ctzll(term_inputs)];
+        conjunct.selectivity_ = EstimateSelectivity(
+            input.table_name_, RewriteColumns(term, [&](const ColumnValueExpression &column) {
+              return std::make_shared<ColumnValueExpression>(0, column.GetColIdx() - input.offset_,
+                                                             column.GetReturnType());
+            }));
+      } else if (comparison_expr != nullptr && comparison_expr->comp_type_ == ComparisonType::Equal &&
+                 left_column != nullptr && right_column != nullptr) {
+        conjunct.equi_columns_ = std::make_pair(left_column->GetColIdx(), right_column->GetColIdx());
+        conjunct.selectivity_ =
+            1 / std::max(distinct_count(left_column->GetColIdx()), distinct_count(right_column->GetColIdx()));
+      } else {
+        conjunct.selectivity_ = EstimateSelectivity("", term);
+      }
+      conjuncts.push_back(std::move(conjunct));
+    }
+  }
+
+  JoinOrder join_order(std::move(inputs), std::move(conjuncts));
+  join_order.Enumerate();
+  auto joined = join_order.Build();
+
+  // Restore the columns of the original join tree.
+  if (joined.columns_ == output_columns) {
+    auto joined_plan = joined.plan_->CloneWithChildren(joined.plan_->GetChildren());
+    joined_plan->output_schema_ = plan->output_schema_;
+    return joined_plan;
+  }
+  std::vector<AbstractExpressionRef> exprs;
+  for (size_t i = 0; i < output_columns.size(); i++) {
+    auto pos = std::find(joined.columns_.begin(), joined.columns_.end(), output_columns[i]) - joined.columns_.begin();
+    exprs.push_back(std::make_shared<ColumnValueExpression>(0, pos, plan->OutputSchema().GetColumn(i).GetType()));
+  }
+  return std::make_shared<ProjectionPlanNode>(plan->output_schema_, std::move(exprs), joined.plan_);
+}
+
+}  // namespace bustub
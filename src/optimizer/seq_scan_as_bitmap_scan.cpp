@@ -0,0 +1,115 @@
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "execution/expressions/parameter_value_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/bitmap_heap_scan_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+auto Optimizer::MatchBitmapLookup(const std::string &table_name, const AbstractExpressionRef &expr)
+    -> std::optional<BitmapIndexLookup> {
+  // A disjunction of lookups into the same index, e.g. `v1 = 1 or v1 = 2`, is a lookup of all their keys.
+  if (const auto *logic_expr = dynamic_cast<const LogicExpression *>(expr.get());
+      logic_expr != nullptr && logic_expr->logic_type_ == LogicType::Or) {
+    auto left = MatchBitmapLookup(table_name, expr->GetChildAt(0));
+    auto right = MatchBitmapLookup(table_name, expr->GetChildAt(1));
+    if (!left.has_value() || !right.has_value() || left->index_oid_ != right->index_oid_) {
+      return std::nullopt;
+    }
+    left->keys_.insert(left->keys_.end(), right->keys_.begin(), right->keys_.end());
+    return left;
+  }
+
+  const auto *comparison_expr = dynamic_cast<const ComparisonExpression *>(expr.get());
+  if (comparison_expr == nullptr || comparison_expr->comp_type_ != ComparisonType::Equal) {
+    return std::nullopt;
+  }
+  // The key is a constant, or a parameter whose value is looked up when the plan runs.
+  auto column_side = dynamic_cast<const ColumnValueExpression *>(expr->GetChildAt(0).get()) != nullptr ? 0 : 1;
+  const auto *column_value_expr = dynamic_cast<const ColumnValueExpression *>(expr->GetChildAt(column_side).get());
+  const auto &key = expr->GetChildAt(1 - column_side);
+  if (dynamic_cast<const ConstantValueExpression *>(key.get()) == nullptr &&
+      dynamic_cast<const ParameterValueExpression *>(key.get()) == nullptr) {
+    return std::nullopt;
+  }
+  // Index keys are serialized with the column type, so the key must have exactly that type.
+  if (column_value_expr == nullptr || column_value_expr->GetReturnType() != key->GetReturnType()) {
+    return std::nullopt;
+  }
+  auto index = MatchIndex(table_name, column_value_expr->GetColIdx());
+  if (!index.has_value()) {
+    return std::nullopt;
+  }
+  return BitmapIndexLookup{std::get<0>(*index), std::get<1>(*index), {key}, std::nullopt, std::nullopt};
+}
+
+auto Optimizer::OptimizeSeqScanAsBitmapScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeSeqScanAsBitmapScan(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  const SeqScanPlanNode *seq_scan_plan = nullptr;
+  AbstractExpressionRef predicate;
+  if (optimized_plan->GetType() == PlanType::Filter &&
+      optimized_plan->GetChildAt(0)->GetType() == PlanType::SeqScan) {
+    seq_scan_plan = dynamic_cast<const SeqScanPlanNode *>(optimized_plan->GetChildAt(0).get());
+    if (seq_scan_plan->filter_predicate_ != nullptr) {
+      return optimized_plan;
+    }
+    predicate = dynamic_cast<const FilterPlanNode &>(*optimized_plan).GetPredicate();
+  } else if (optimized_plan->GetType() == PlanType::SeqScan) {
+    seq_scan_plan = dynamic_cast<const SeqScanPlanNode *>(optimized_plan.get());
+    predicate = seq_scan_plan->filter_predicate_;
+  }
+  if (predicate == nullptr) {
+    return optimized_plan;
+  }
+
+  // Every conjunct matching an index narrows down the RIDs. The predicate is still checked on every tuple read, so
+  // conjuncts without an index need no special care.
+  std::vector<BitmapIndexLookup> lookups;
+  auto combine_type = LogicType::And;
+  std::vector<AbstractExpressionRef> conjuncts;
+  FlattenLogic(predicate, LogicType::And, &conjuncts);
+  for (const auto &conjunct : conjuncts) {
+    if (auto lookup = MatchBitmapLookup(seq_scan_plan->table_name_, conjunct); lookup.has_value()) {
+      lookups.push_back(std::move(*lookup));
+    }
+  }
+
+  // A disjunction over different indexes reads the union of their RIDs, but only if every term has an index.
+  if (lookups.empty() && conjuncts.size() == 1) {
+    std::vector<AbstractExpressionRef> disjuncts;
+    FlattenLogic(predicate, LogicType::Or, &disjuncts);
+    combine_type = LogicType::Or;
+    for (const auto &disjunct : disjuncts) {
+      auto lookup = MatchBitmapLookup(seq_scan_plan->table_name_, disjunct);
+      if (!lookup.has_value()) {
+        lookups.clear();
+        break;
+      }
+      lookups.push_back(std::move(*lookup));
+    }
+  }
+  if (lookups.empty()) {
+    return optimized_plan;
+  }
+  return std::make_shared<BitmapHeapScanPlanNode>(seq_scan_plan->output_schema_, seq_scan_plan->table_oid_,
+                                                  seq_scan_plan->table_name_, std::move(lookups), combine_type,
+                                                  std::move(predicate));
+}
+
+}  // namespace bustub
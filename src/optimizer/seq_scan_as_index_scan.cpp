@@ -0,0 +1,171 @@
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/bitmap_heap_scan_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+namespace {
+
+/** Reading a tuple through the index costs about as much as reading this many tuples in a sequential scan */
+constexpr double INDEX_SCAN_COST = 4;
+
+/** The range of keys of one index allowed by a set of conjuncts */
+struct IndexRange {
+  /** The index name, for display only */
+  std::string index_name_;
+  std::optional<IndexScanBound> lower_;
+  std::optional<IndexScanBound> upper_;
+  /** The positions of the conjuncts the range checks */
+  std::vector<size_t> conjuncts_;
+};
+
+/** Narrow a bound of a range down to a key if the key is more restrictive */
+void Tighten(std::optional<IndexScanBound> *bound, const Value &key, bool inclusive, bool is_lower) {
+  if (!bound->has_value()) {
+    *bound = IndexScanBound{key, inclusive};
+    return;
+  }
+  auto narrower = is_lower ? key.CompareGreaterThan((*bound)->key_) : key.CompareLessThan((*bound)->key_);
+  if (narrower == CmpBool::CmpTrue || (!inclusive && key.CompareEquals((*bound)->key_) == CmpBool::CmpTrue)) {
+    *bound = IndexScanBound{key, inclusive};
+  }
+}
+
+}  // namespace
+
+auto Optimizer::OptimizeSeqScanAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeSeqScanAsIndexScan(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  const SeqScanPlanNode *seq_scan_plan = nullptr;
+  AbstractExpressionRef predicate;
+  if (optimized_plan->GetType() == PlanType::Filter &&
+      optimized_plan->GetChildAt(0)->GetType() == PlanType::SeqScan) {
+    seq_scan_plan = dynamic_cast<const SeqScanPlanNode *>(optimized_plan->GetChildAt(0).get());
+    if (seq_scan_plan->filter_predicate_ != nullptr) {
+      return optimized_plan;
+    }
+    predicate = dynamic_cast<const FilterPlanNode &>(*optimized_plan).GetPredicate();
+  } else if (optimized_plan->GetType() == PlanType::SeqScan) {
+    seq_scan_plan = dynamic_cast<const SeqScanPlanNode *>(optimized_plan.get());
+    predicate = seq_scan_plan->filter_predicate_;
+  }
+  if (predicate == nullptr) {
+    return optimized_plan;
+  }
+
+  std::vector<AbstractExpressionRef> conjuncts;
+  FlattenLogic(predicate, LogicType::And, &conjuncts);
+  std::unordered_map<index_oid_t, IndexRange> ranges;
+  for (size_t i = 0; i < conjuncts.size(); i++) {
+    // Equality lookups are left to the bitmap heap scan, which also combines several indexes.
+    if (MatchBitmapLookup(seq_scan_plan->table_name_, conjuncts[i]).has_value()) {
+      return optimized_plan;
+    }
+    const auto *comparison_expr = dynamic_cast<const ComparisonExpression *>(conjuncts[i].get());
+    if (comparison_expr == nullptr || comparison_expr->comp_type_ == ComparisonType::Equal ||
+        comparison_expr->comp_type_ == ComparisonType::NotEqual) {
+      continue;
+    }
+    const auto *column_value_expr = dynamic_cast<const ColumnValueExpression *>(comparison_expr->GetChildAt(0).get());
+    const auto *constant_value_expr =
+        dynamic_cast<const ConstantValueExpression *>(comparison_expr->GetChildAt(1).get());
+    auto column_on_left = column_value_expr != nullptr;
+    if (!column_on_left) {
+      column_value_expr = dynamic_cast<const ColumnValueExpression *>(comparison_expr->GetChildAt(1).get());
+      constant_value_expr = dynamic_cast<const ConstantValueExpression *>(comparison_expr->GetChildAt(0).get());
+    }
+    // Index keys are serialized with the column type, so the constant must have exactly that type.
+    if (column_value_expr == nullptr || constant_value_expr == nullptr || constant_value_expr->val_.IsNull() ||
+        column_value_expr->GetReturnType() != constant_value_expr->val_.GetTypeId()) {
+      continue;
+    }
+    auto index = MatchIndex(seq_scan_plan->table_name_, column_value_expr->GetColIdx());
+    if (!index.has_value()) {
+      continue;
+    }
+
+    // `column < constant` bounds the keys from above, as does `constant > column`.
+    auto comp_type = comparison_expr->comp_type_;
+    auto is_less = comp_type == ComparisonType::LessThan || comp_type == ComparisonType::LessThanOrEqual;
+    auto inclusive = comp_type == ComparisonType::LessThanOrEqual || comp_type == ComparisonType::GreaterThanOrEqual;
+    auto is_lower = is_less != column_on_left;
+    auto &range = ranges[std::get<0>(*index)];
+    range.index_name_ = std::get<1>(*index);
+    Tighten(is_lower ? &range.lower_ : &range.upper_, constant_value_expr->val_, inclusive, is_lower);
+    range.conjuncts_.push_back(i);
+  }
+
+  // Read the smallest range of an index, if reading its tuples is cheaper than reading the whole table.
+  std::optional<index_oid_t> best_index;
+  auto best_selectivity = 1 / INDEX_SCAN_COST;
+  for (const auto &[index_oid, range] : ranges) {
+    std::vector<AbstractExpressionRef> range_conjuncts;
+    for (auto i : range.conjuncts_) {
+      range_conjuncts.push_back(conjuncts[i]);
+    }
+    auto selectivity = EstimateSelectivity(seq_scan_plan->table_name_, MakeConjunction(range_conjuncts));
+    if (selectivity < best_selectivity) {
+      best_index = index_oid;
+      best_selectivity = selectivity;
+    }
+  }
+  if (!best_index.has_value()) {
+    return optimized_plan;
+  }
+
+  const auto &range = ranges.at(*best_index);
+  std::vector<AbstractExpressionRef> residual;
+  for (size_t i = 0, j = 0; i < conjuncts.size(); i++) {
+    if (j < range.conjuncts_.size() && range.conjuncts_[j] == i) {
+      j++;
+    } else {
+      residual.push_back(conjuncts[i]);
+    }
+  }
+  // The tuples are read in RID order rather than key order, so every table page is fetched once. Consumers that need
+  // the key order turn the scan back into an index scan, see RangeScanAsIndexScan().
+  std::vector<BitmapIndexLookup> lookups;
+  lookups.push_back(BitmapIndexLookup{*best_index, range.index_name_, {}, range.lower_, range.upper_});
+  return std::make_shared<BitmapHeapScanPlanNode>(seq_scan_plan->output_schema_, seq_scan_plan->table_oid_,
+                                                  seq_scan_plan->table_name_, std::move(lookups), LogicType::And,
+                                                  residual.empty() ? nullptr : MakeConjunction(residual));
+}
+
+auto Optimizer::RangeScanAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  if (plan->GetType() != PlanType::BitmapHeapScan) {
+    return nullptr;
+  }
+  const auto &bitmap_scan = dynamic_cast<const BitmapHeapScanPlanNode &>(*plan);
+  if (bitmap_scan.GetLookups().size() != 1 || !bitmap_scan.GetLookups()[0].IsRange()) {
+    return nullptr;
+  }
+  const auto &lookup = bitmap_scan.GetLookups()[0];
+  AbstractPlanNodeRef index_scan =
+      std::make_shared<IndexScanPlanNode>(bitmap_scan.output_schema_, lookup.index_oid_, lookup.lower_, lookup.upper_);
+  if (bitmap_scan.filter_predicate_ == nullptr) {
+    return index_scan;
+  }
+  return std::make_shared<FilterPlanNode>(bitmap_scan.output_schema_, bitmap_scan.filter_predicate_,
+                                          std::move(index_scan));
+}
+
+}  // namespace bustub
@@ -1,10 +1,152 @@
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "binder/bound_order_by.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/hash_join_plan.h"
+#include "execution/plans/limit_plan.h"
+#include "execution/plans/nested_index_join_plan.h"
+#include "execution/plans/nested_loop_join_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "execution/plans/sort_plan.h"
+#include "execution/plans/topn_plan.h"
 #include "optimizer/optimizer.h"
 
 namespace bustub {
 
+namespace {
+
+/** @return whether every column `expr` reads is one of the first `column_cnt` columns */
+auto ReadsOnlyFirstColumns(const AbstractExpression &expr, size_t column_cnt) -> bool {
+  if (const auto *column_value_expr = dynamic_cast<const ColumnValueExpression *>(&expr);
+      column_value_expr != nullptr) {
+    return column_value_expr->GetColIdx() < column_cnt;
+  }
+  return std::all_of(expr.GetChildren().begin(), expr.GetChildren().end(),
+                     [&](const auto &child) { return ReadsOnlyFirstColumns(*child, column_cnt); });
+}
+
+/** @return the column count of the outer side of a left join, `nullopt` if the plan is no left join */
+auto LeftJoinOuterColumnCount(const AbstractPlanNode &plan) -> std::optional<size_t> {
+  // The join executors read the left input once, in order, and produce at least one row for every left row before
+  // moving on to the next one.
+  if (const auto *nlj_plan = dynamic_cast<const NestedLoopJoinPlanNode *>(&plan);
+      nlj_plan != nullptr && nlj_plan->GetJoinType() == JoinType::LEFT) {
+    return nlj_plan->GetLeftPlan()->OutputSchema().GetColumnCount();
+  }
+  if (const auto *hash_join_plan = dynamic_cast<const HashJoinPlanNode *>(&plan);
+      hash_join_plan != nullptr && hash_join_plan->GetJoinType() == JoinType::LEFT) {
+    return hash_join_plan->GetLeftPlan()->OutputSchema().GetColumnCount();
+  }
+  if (const auto *index_join_plan = dynamic_cast<const NestedIndexJoinPlanNode *>(&plan);
+      index_join_plan != nullptr && index_join_plan->GetJoinType() == JoinType::LEFT) {
+    return index_join_plan->GetChildPlan()->OutputSchema().GetColumnCount();
+  }
+  return std::nullopt;
+}
+
+}  // namespace
+
 auto Optimizer::OptimizeSortLimitAsTopN(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
-  // TODO(student): implement sort + limit -> top N optimizer rule
-  return plan;
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeSortLimitAsTopN(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  if (optimized_plan->GetType() == PlanType::Limit) {
+    const auto &limit_plan = dynamic_cast<const LimitPlanNode &>(*optimized_plan);
+    return PushDownLimit(limit_plan.GetChildPlan(), limit_plan.GetLimit());
+  }
+  return optimized_plan;
+}
+
+auto Optimizer::PushDownLimit(const AbstractPlanNodeRef &plan, size_t limit) -> AbstractPlanNodeRef {
+  switch (plan->GetType()) {
+    case PlanType::Projection:
+      // A projection produces one row for every input row.
+      return plan->CloneWithChildren({PushDownLimit(plan->GetChildAt(0), limit)});
+    case PlanType::Limit: {
+      const auto &limit_plan = dynamic_cast<const LimitPlanNode &>(*plan);
+      return PushDownLimit(limit_plan.GetChildPlan(), std::min(limit, limit_plan.GetLimit()));
+    }
+    case PlanType::Sort: {
+      const auto &sort_plan = dynamic_cast<const SortPlanNode &>(*plan);
+      return PushDownTopN(sort_plan.GetChildPlan(), sort_plan.GetOrderBy(), limit);
+    }
+    case PlanType::TopN: {
+      const auto &topn_plan = dynamic_cast<const TopNPlanNode &>(*plan);
+      if (topn_plan.GetN() <= limit) {
+        return plan;
+      }
+      return std::make_shared<TopNPlanNode>(topn_plan.output_schema_, topn_plan.GetChildPlan(),
+                                            topn_plan.GetOrderBy(), limit);
+    }
+    case PlanType::BitmapHeapScan:
+      // An index scan stops after the first n keys of the range, a bitmap heap scan looks all of them up first.
+      if (auto index_scan = RangeScanAsIndexScan(plan); index_scan != nullptr) {
+        return std::make_shared<LimitPlanNode>(plan->output_schema_, std::move(index_scan), limit);
+      }
+      break;
+    default:
+      break;
+  }
+
+  auto limited_plan = plan;
+  if (LeftJoinOuterColumnCount(*plan).has_value()) {
+    // The first n rows of the join come from the first n left rows at most.
+    auto children = plan->GetChildren();
+    children[0] = PushDownLimit(children[0], limit);
+    limited_plan = plan->CloneWithChildren(std::move(children));
+  }
+  return std::make_shared<LimitPlanNode>(plan->output_schema_, std::move(limited_plan), limit);
+}
+
+auto Optimizer::PushDownTopN(const AbstractPlanNodeRef &plan,
+                             std::vector<std::pair<OrderByType, AbstractExpressionRef>> order_bys, size_t n)
+    -> AbstractPlanNodeRef {
+  // An input already ordered on the key needs no sorting at all, only its first n rows are read.
+  if (order_bys.size() == 1 &&
+      (order_bys[0].first == OrderByType::ASC || order_bys[0].first == OrderByType::DEFAULT)) {
+    if (const auto *column_value_expr = dynamic_cast<const ColumnValueExpression *>(order_bys[0].second.get());
+        column_value_expr != nullptr) {
+      if (auto ordered = MakeOrderedOn(plan, column_value_expr->GetColIdx(), true); ordered != nullptr) {
+        return PushDownLimit(ordered, n);
+      }
+    }
+  }
+
+  switch (plan->GetType()) {
+    case PlanType::Projection: {
+      // Ordering the output on the projected expressions is ordering the input on their definitions.
+      const auto &exprs = dynamic_cast<const ProjectionPlanNode &>(*plan).GetExpressions();
+      for (auto &[order_type, expr] : order_bys) {
+        expr = RewriteColumns(expr, [&](const ColumnValueExpression &column) { return exprs[column.GetColIdx()]; });
+      }
+      return plan->CloneWithChildren({PushDownTopN(plan->GetChildAt(0), std::move(order_bys), n)});
+    }
+    case PlanType::Sort:
+      // The order of the input does not matter, a top N orders all rows it keeps.
+      return PushDownTopN(plan->GetChildAt(0), std::move(order_bys), n);
+    default:
+      break;
+  }
+
+  auto limited_plan = plan;
+  if (auto outer_column_cnt = LeftJoinOuterColumnCount(*plan);
+      outer_column_cnt.has_value() && std::all_of(order_bys.begin(), order_bys.end(), [&](const auto &order_by) {
+        return ReadsOnlyFirstColumns(*order_by.second, *outer_column_cnt);
+      })) {
+    // Keys over the outer side only: every left row outside of its first n produces rows sorting after n others.
+    auto children = plan->GetChildren();
+    children[0] = PushDownTopN(children[0], order_bys, n);
+    limited_plan = plan->CloneWithChildren(std::move(children));
+  }
+  return std::make_shared<TopNPlanNode>(plan->output_schema_, std::move(limited_plan), std::move(order_bys), n);
 }
 
 }  // namespace bustub
@@ -91,12 +91,12 @@ auto Planner::PlanSelectAgg(const SelectStatement &statement, AbstractPlanNodeRe
     output_col_names.emplace_back(std::move(col_name));
   }
 
-  // Rewrite all agg call inside having.
+  // Collect all agg calls inside having.
   if (!statement.having_->IsInvalid()) {
     AddAggCallToContext(*statement.having_);
   }
 
-  // Rewrite all agg call inside expression to a pseudo one.
+  // Collect all agg calls inside expression.
   for (auto &item : statement.select_list_) {
     AddAggCallToContext(*item);
   }
@@ -107,12 +107,8 @@ auto Planner::PlanSelectAgg(const SelectStatement &statement, AbstractPlanNodeRe
   auto agg_begin_idx = group_by_exprs.size();  // agg-calls will be after group-bys in the output of agg.
 
   size_t term_idx = 0;
-  for (const auto &item : ctx_.aggregations_) {
-    if (item->type_ != ExpressionType::AGG_CALL) {
-      throw NotImplementedException("alias for agg call is not supported for now");
-    }
-    const auto &agg_call = dynamic_cast<const BoundAggCall &>(*item);
-    auto [agg_type, exprs] = PlanAggCall(agg_call, {child});
+  for (const auto *agg_call : ctx_.aggregations_) {
+    auto [agg_type, exprs] = PlanAggCall(*agg_call, {child});
     if (exprs.size() > 1) {
       throw bustub::NotImplementedException("only agg call of zero/one arg is supported");
     }
@@ -126,7 +122,8 @@ auto Planner::PlanSelectAgg(const SelectStatement &statement, AbstractPlanNodeRe
     agg_types.push_back(agg_type);
     output_col_names.emplace_back(fmt::format("agg#{}", term_idx));
     ctx_.expr_in_agg_.emplace_back(
-        std::make_unique<ColumnValueExpression>(0, agg_begin_idx + term_idx, TypeId::INTEGER));
+        std::make_unique<ColumnValueExpression>(0, agg_begin_idx + term_idx,
+                                                AggregationPlanNode::InferAggType(agg_type, input_exprs.back())));
 
     term_idx += 1;
   }
@@ -0,0 +1,108 @@
+#include "planner/plan_cache.h"
+
+#include <algorithm>
+#include <cctype>
+
+namespace bustub {
+
+auto PlanCache::Normalize(const std::string &sql) -> std::string {
+  std::string key;
+  key.reserve(sql.size());
+  char quote = 0;
+  bool pending_space = false;
+  for (char c : sql) {
+    if (quote == 0 && std::isspace(static_cast<unsigned char>(c)) != 0) {
+      pending_space = !key.empty();
+      continue;
+    }
+    if (pending_space) {
+      key.push_back(' ');
+      pending_space = false;
+    }
+    if (quote == 0 && (c == '\'' || c == '"')) {
+      quote = c;
+    } else if (c == quote) {
+      quote = 0;
+    }
+    key.push_back(c);
+  }
+  while (!key.empty() && (key.back() == ';' || key.back() == ' ')) {
+    key.pop_back();
+  }
+  return key;
+}
+
+auto PlanCache::Get(const std::string &key, uint64_t catalog_version) -> std::optional<CachedPlan> {
+  std::scoped_lock lock(latch_);
+  auto iter = index_.find(key);
+  if (iter == index_.end()) {
+    misses_++;
+    return std::nullopt;
+  }
+  if (iter->second->second.catalog_version_ != catalog_version) {
+    entries_.erase(iter->second);
+    index_.erase(iter);
+    misses_++;
+    return std::nullopt;
+  }
+  entries_.splice(entries_.begin(), entries_, iter->second);
+  hits_++;
+  return iter->second->second;
+}
+
+void PlanCache::Put(const std::string &key, CachedPlan plan) {
+  std::scoped_lock lock(latch_);
+  if (auto iter = index_.find(key); iter != index_.end()) {
+    entries_.erase(iter->second);
+    index_.erase(iter);
+  }
+  if (capacity_ == 0) {
+    return;
+  }
+  if (entries_.size() == capacity_) {
+    index_.erase(entries_.back().first);
+    entries_.pop_back();
+  }
+  entries_.emplace_front(key, std::move(plan));
+  index_.emplace(key, entries_.begin());
+}
+
+auto PlanCache::GetPrepared(const std::string &name, uint64_t catalog_version, const std::vector<Value> &parameters)
+    -> std::optional<CachedPlan> {
+  std::scoped_lock lock(latch_);
+  auto iter = prepared_.find(name);
+  if (iter == prepared_.end()) {
+    misses_++;
+    return std::nullopt;
+  }
+  // The optimizer matches parameters against index keys by their type.
+  const auto &planned = *iter->second.parameters_;
+  auto same_types = std::equal(planned.begin(), planned.end(), parameters.begin(), parameters.end(),
+                               [](const Value &a, const Value &b) { return a.GetTypeId() == b.GetTypeId(); });
+  if (iter->second.catalog_version_ != catalog_version || !same_types) {
+    prepared_.erase(iter);
+    misses_++;
+    return std::nullopt;
+  }
+  hits_++;
+  return iter->second;
+}
+
+void PlanCache::PutPrepared(const std::string &name, CachedPlan plan) {
+  std::scoped_lock lock(latch_);
+  prepared_.insert_or_assign(name, std::move(plan));
+}
+
+void PlanCache::ErasePrepared(const std::string &name) {
+  std::scoped_lock lock(latch_);
+  prepared_.erase(name);
+}
+
+void PlanCache::Clear() {
+  std::scoped_lock lock(latch_);
+  entries_.clear();
+  index_.clear();
+  prepared_.clear();
+}
+
+}  // namespace bustub
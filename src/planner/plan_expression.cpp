@@ -7,6 +7,7 @@
 #include "binder/expressions/bound_binary_op.h"
 #include "binder/expressions/bound_column_ref.h"
 #include "binder/expressions/bound_constant.h"
+#include "binder/expressions/bound_parameter.h"
 #include "binder/expressions/bound_unary_op.h"
 #include "binder/statement/select_statement.h"
 #include "common/exception.h"
@@ -14,6 +15,7 @@
 #include "common/util/string_util.h"
 #include "execution/expressions/column_value_expression.h"
 #include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/parameter_value_expression.h"
 #include "execution/plans/abstract_plan.h"
 #include "fmt/format.h"
 #include "planner/planner.h"
@@ -99,27 +101,47 @@ auto Planner::PlanConstant(const BoundConstant &expr, const std::vector<Abstract
   return std::make_shared<ConstantValueExpression>(expr.val_);
 }
 
-void Planner::AddAggCallToContext(BoundExpression &expr) {
+auto Planner::PlanParameter(const BoundParameter &expr) -> AbstractExpressionRef {
+  if (parameters_ == nullptr || expr.index_ >= parameters_->size()) {
+    throw Exception(fmt::format("no value given for parameter {}", expr));
+  }
+  return std::make_shared<ParameterValueExpression>(expr.index_, (*parameters_)[expr.index_].GetTypeId(), parameters_);
+}
+
+auto Planner::PlanConstantValue(const BoundExpression &expr) -> std::optional<Value> {
+  switch (expr.type_) {
+    case ExpressionType::CONSTANT:
+      return dynamic_cast<const BoundConstant &>(expr).val_;
+    case ExpressionType::PARAMETER: {
+      const auto &parameter_expr = dynamic_cast<const BoundParameter &>(expr);
+      PlanParameter(parameter_expr);
+      uses_parameter_values_ = true;
+      return (*parameters_)[parameter_expr.index_];
+    }
+    default:
+      return std::nullopt;
+  }
+}
+
+void Planner::AddAggCallToContext(const BoundExpression &expr) {
   switch (expr.type_) {
     case ExpressionType::AGG_CALL: {
-      auto &agg_call_expr = dynamic_cast<BoundAggCall &>(expr);
-      auto agg_name = fmt::format("__pseudo_agg#{}", ctx_.aggregations_.size());
-      auto agg_call =
-          BoundAggCall(agg_name, agg_call_expr.is_distinct_, std::vector<std::unique_ptr<BoundExpression>>{});
-      // Replace the agg call in the original bound expression with a pseudo one, add agg call to the context.
-      ctx_.AddAggregation(std::make_unique<BoundAggCall>(std::exchange(agg_call_expr, std::move(agg_call))));
+      // Agg calls are collected in the order `PlanExpression` visits them later, which is how it finds their output.
+      // The bound statement is left untouched, so that a prepared statement can be planned again.
+      ctx_.AddAggregation(&dynamic_cast<const BoundAggCall &>(expr));
       return;
     }
     case ExpressionType::COLUMN_REF: {
       return;
     }
     case ExpressionType::BINARY_OP: {
-      auto &binary_op_expr = dynamic_cast<BoundBinaryOp &>(expr);
+      const auto &binary_op_expr = dynamic_cast<const BoundBinaryOp &>(expr);
       AddAggCallToContext(*binary_op_expr.larg_);
       AddAggCallToContext(*binary_op_expr.rarg_);
       return;
     }
-    case ExpressionType::CONSTANT: {
+    case ExpressionType::CONSTANT:
+    case ExpressionType::PARAMETER: {
       return;
     }
     case ExpressionType::ALIAS: {
@@ -154,6 +176,10 @@ auto Planner::PlanExpression(const BoundExpression &expr, const std::vector<Abst
       const auto &constant_expr = dynamic_cast<const BoundConstant &>(expr);
       return std::make_tuple(UNNAMED_COLUMN, PlanConstant(constant_expr, children));
     }
+    case ExpressionType::PARAMETER: {
+      const auto &parameter_expr = dynamic_cast<const BoundParameter &>(expr);
+      return std::make_tuple(UNNAMED_COLUMN, PlanParameter(parameter_expr));
+    }
     case ExpressionType::ALIAS: {
       const auto &alias_expr = dynamic_cast<const BoundAlias &>(expr);
       auto [_1, expr] = PlanExpression(*alias_expr.child_, children);
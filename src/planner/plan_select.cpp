@@ -118,11 +118,9 @@ auto Planner::PlanSelect(const SelectStatement &statement) -> AbstractPlanNodeRe
     std::optional<size_t> limit = std::nullopt;
 
     if (!statement.limit_count_->IsInvalid()) {
-      if (statement.limit_count_->type_ == ExpressionType::CONSTANT) {
-        const auto &constant_expr = dynamic_cast<BoundConstant &>(*statement.limit_count_);
-        const auto val = constant_expr.val_.CastAs(TypeId::INTEGER);
-        if (constant_expr.val_.GetTypeId() == TypeId::INTEGER) {
-          limit = std::make_optional(constant_expr.val_.GetAs<int32_t>());
+      if (auto val = PlanConstantValue(*statement.limit_count_); val.has_value()) {
+        if (val->GetTypeId() == TypeId::INTEGER) {
+          limit = std::make_optional(val->GetAs<int32_t>());
         } else {
           throw NotImplementedException("LIMIT clause must be an integer constant.");
         }
@@ -132,11 +130,9 @@ auto Planner::PlanSelect(const SelectStatement &statement) -> AbstractPlanNodeRe
     }
 
     if (!statement.limit_offset_->IsInvalid()) {
-      if (statement.limit_offset_->type_ == ExpressionType::CONSTANT) {
-        const auto &constant_expr = dynamic_cast<BoundConstant &>(*statement.limit_offset_);
-        const auto val = constant_expr.val_.CastAs(TypeId::INTEGER);
-        if (constant_expr.val_.GetTypeId() == TypeId::INTEGER) {
-          offset = std::make_optional(constant_expr.val_.GetAs<int32_t>());
+      if (auto val = PlanConstantValue(*statement.limit_offset_); val.has_value()) {
+        if (val->GetTypeId() == TypeId::INTEGER) {
+          offset = std::make_optional(val->GetAs<int32_t>());
         } else {
           throw NotImplementedException("OFFSET clause must be an integer constant.");
         }
@@ -52,6 +52,63 @@ auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
   return true;
 }
 
+/*
+ * Batched point query over keys sorted in ascending order. Consecutive keys
+ * usually share a leaf or sit in the next one, so instead of one root-to-leaf
+ * descent per key, the leaf chain is followed and the tree is only descended
+ * again when a key is beyond the next leaf.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::GetValues(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *results,
+                               Transaction *transaction) {
+  results->assign(keys.size(), {});
+  if (keys.empty()) {
+    return;
+  }
+  root_page_id_latch_.RLock();
+  if (IsEmpty()) {
+    root_page_id_latch_.RUnlock();
+    return;
+  }
+  auto *page = FindLeaf(keys[0], Operation::SEARCH, transaction);
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  auto release = [&](Page *p) {
+    p->RUnlatch();
+    buffer_pool_manager_->UnpinPage(p->GetPageId(), false);
+  };
+  auto is_past_leaf = [&](const KeyType &key, LeafPage *node) {
+    return node->GetSize() == 0 || comparator_(key, node->KeyAt(node->GetSize() - 1)) > 0;
+  };
+
+  for (size_t i = 0; i < keys.size(); i++) {
+    const auto &key = keys[i];
+    if (is_past_leaf(key, leaf) && leaf->GetNextPageId() != INVALID_PAGE_ID) {
+      // Step to the right sibling, latching it before letting go of the current leaf.
+      auto *next_page = buffer_pool_manager_->FetchPage(leaf->GetNextPageId());
+      next_page->RLatch();
+      release(page);
+      page = next_page;
+      leaf = reinterpret_cast<LeafPage *>(page->GetData());
+      if (is_past_leaf(key, leaf) && leaf->GetNextPageId() != INVALID_PAGE_ID) {
+        // The key is further away, descending is cheaper than walking the chain.
+        release(page);
+        root_page_id_latch_.RLock();
+        if (IsEmpty()) {
+          root_page_id_latch_.RUnlock();
+          return;
+        }
+        page = FindLeaf(key, Operation::SEARCH, transaction);
+        leaf = reinterpret_cast<LeafPage *>(page->GetData());
+      }
+    }
+    ValueType value;
+    if (leaf->Lookup(key, &value, comparator_)) {
+      (*results)[i].push_back(value);
+    }
+  }
+  release(page);
+}
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
@@ -131,7 +188,6 @@ auto BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value,
 
   // 取0号元素作为插入父节点元素
   auto risen_key = right_sibling_leaf_node->KeyAt(0);
-  std::cout << "risen_key " << risen_key << std::endl;
   InsertIntoParent(bplus_page, risen_key, right_sibling_leaf_node, transaction);
 
   ReleaseLatchFromQueue(transaction);
@@ -242,7 +298,6 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &ke
   auto parent_new_sibling_node = Split(copy_parent_node);
   //
   auto new_key = parent_new_sibling_node->KeyAt(0);
-  std::cout << "new_key  " << new_key << std::endl;
   // 从临时page 拷贝到原来父节点page
   std::memcpy(parent_page->GetData(), mem,
               INTERNAL_PAGE_HEADER_SIZE + sizeof(MappingType) * copy_parent_node->GetMinSize());
@@ -483,6 +538,15 @@ auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
   auto buffer_page = FindLeaf(key, Operation::SEARCH);
   auto *leaf_node = reinterpret_cast<LeafPage *>(buffer_page->GetData());
   auto idx = leaf_node->KeyIndex(key, comparator_);
+  // All keys of the leaf are smaller, so the first larger key is the first of the next leaf.
+  if (idx == leaf_node->GetSize() && leaf_node->GetNextPageId() != INVALID_PAGE_ID) {
+    auto next_page = buffer_pool_manager_->FetchPage(leaf_node->GetNextPageId());
+    next_page->RLatch();
+    buffer_page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(buffer_page->GetPageId(), false);
+    buffer_page = next_page;
+    idx = 0;
+  }
   return INDEXITERATOR_TYPE(buffer_pool_manager_, buffer_page, idx);
 }
 /*
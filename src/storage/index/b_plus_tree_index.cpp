@@ -11,6 +11,8 @@
 
 #include "storage/index/b_plus_tree_index.h"
 
+#include <algorithm>
+
 namespace bustub {
 /*
  * Constructor
@@ -48,6 +50,36 @@ void BPLUSTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, T
   container_.GetValue(index_key, result, transaction);
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *results,
+                                    Transaction *transaction) {
+  std::vector<KeyType> index_keys(keys.size());
+  std::vector<size_t> order(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    index_keys[i].SetFromKey(keys[i]);
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(),
+            [&](size_t a, size_t b) { return comparator_(index_keys[a], index_keys[b]) < 0; });
+
+  // Look every distinct key up once, in ascending order.
+  std::vector<KeyType> sorted_keys;
+  std::vector<size_t> key_of(keys.size());
+  for (auto i : order) {
+    if (sorted_keys.empty() || comparator_(sorted_keys.back(), index_keys[i]) != 0) {
+      sorted_keys.push_back(index_keys[i]);
+    }
+    key_of[i] = sorted_keys.size() - 1;
+  }
+  std::vector<std::vector<RID>> sorted_results;
+  container_.GetValues(sorted_keys, &sorted_results, transaction);
+
+  results->resize(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    (*results)[i] = sorted_results[key_of[i]];
+  }
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_INDEX_TYPE::GetBeginIterator() -> INDEXITERATOR_TYPE { return container_.Begin(); }
 
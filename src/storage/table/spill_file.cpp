@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// spill_file.cpp
+//
+// Identification: src/storage/table/spill_file.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/spill_file.h"
+
+#include "common/exception.h"
+#include "common/io_counters.h"
+
+namespace bustub {
+
+SpillFile::~SpillFile() {
+  for (auto page_id : page_ids_) {
+    bpm_->DeletePage(page_id);
+  }
+}
+
+void SpillFile::Append(const Tuple &tuple) {
+  if (staged_page_ == nullptr) {
+    staged_page_ = std::make_unique<TmpTuplePage>();
+    staged_page_->Init(INVALID_PAGE_ID, BUSTUB_PAGE_SIZE);
+  }
+  TmpTuple location(INVALID_PAGE_ID, 0);
+  if (!staged_page_->Insert(tuple, &location)) {
+    FlushStagedPage();
+    auto inserted = staged_page_->Insert(tuple, &location);
+    BUSTUB_ENSURE(inserted, "tuple does not fit into a temporary page");
+  }
+  staged_page_dirty_ = true;
+  tuple_count_++;
+  size_ += TmpTuplePage::GetStorageSize(tuple);
+}
+
+void SpillFile::Rewind() {
+  if (staged_page_dirty_) {
+    FlushStagedPage();
+  }
+  staged_page_ = nullptr;
+  read_buffer_.clear();
+  read_cursor_ = 0;
+  next_read_page_ = 0;
+}
+
+auto SpillFile::Next(Tuple *tuple) -> bool {
+  while (read_cursor_ == read_buffer_.size()) {
+    if (next_read_page_ == page_ids_.size()) {
+      return false;
+    }
+    auto page_id = page_ids_[next_read_page_++];
+    auto *page = reinterpret_cast<TmpTuplePage *>(bpm_->FetchPage(page_id));
+    if (page == nullptr) {
+      throw ExecutionException("no free frame to read back spilled tuples");
+    }
+    // Tuples are stored back to front, so collect their offsets first and read them in reverse.
+    std::vector<uint32_t> offsets;
+    for (auto offset = page->GetFirstTupleOffset(); offset < BUSTUB_PAGE_SIZE;
+         offset = page->GetNextTupleOffset(offset)) {
+      offsets.push_back(offset);
+    }
+    read_buffer_.clear();
+    read_buffer_.resize(offsets.size());
+    for (size_t i = 0; i < offsets.size(); i++) {
+      page->Get(offsets[offsets.size() - 1 - i], &read_buffer_[i]);
+    }
+    read_cursor_ = 0;
+    bpm_->UnpinPage(page_id, false);
+  }
+  *tuple = std::move(read_buffer_[read_cursor_++]);
+  return true;
+}
+
+void SpillFile::FlushStagedPage() {
+  page_id_t page_id;
+  auto *page = reinterpret_cast<TmpTuplePage *>(bpm_->NewPage(&page_id));
+  if (page == nullptr) {
+    throw ExecutionException("no free frame to spill tuples");
+  }
+  memcpy(page->GetData(), staged_page_->GetData(), BUSTUB_PAGE_SIZE);
+  page->SetTablePageId(page_id);
+  bpm_->UnpinPage(page_id, true);
+  page_ids_.push_back(page_id);
+  thread_io_counters.bytes_spilled_ += BUSTUB_PAGE_SIZE;
+  staged_page_->Init(INVALID_PAGE_ID, BUSTUB_PAGE_SIZE);
+  staged_page_dirty_ = false;
+}
+
+}  // namespace bustub
@@ -196,6 +196,69 @@ auto TableHeap::Begin(Transaction *txn) -> TableIterator {
   return {this, rid, txn};
 }
 
+auto TableHeap::GetPageIds(Transaction *txn) -> std::vector<page_id_t> {
+  std::vector<page_id_t> page_ids;
+  auto page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    if (page == nullptr) {
+      txn->SetState(TransactionState::ABORTED);
+      break;
+    }
+    page_ids.push_back(page_id);
+    page->RLatch();
+    auto next_page_id = page->GetNextPageId();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  return page_ids;
+}
+
+auto TableHeap::GetPageTuples(page_id_t page_id, std::vector<std::pair<Tuple, RID>> *tuples, Transaction *txn)
+    -> page_id_t {
+  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  if (page == nullptr) {
+    txn->SetState(TransactionState::ABORTED);
+    return INVALID_PAGE_ID;
+  }
+  page->RLatch();
+  RID rid;
+  for (bool found = page->GetFirstTupleRid(&rid); found; found = page->GetNextTupleRid(rid, &rid)) {
+    Tuple tuple;
+    if (page->GetTuple(rid, &tuple, txn, lock_manager_)) {
+      tuples->emplace_back(std::move(tuple), rid);
+    }
+  }
+  auto next_page_id = page->GetNextPageId();
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  return next_page_id;
+}
+
+void TableHeap::GetPageTuples(const std::vector<RID> &rids, std::vector<std::pair<Tuple, RID>> *tuples,
+                              Transaction *txn) {
+  if (rids.empty()) {
+    return;
+  }
+  auto page_id = rids[0].GetPageId();
+  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  if (page == nullptr) {
+    txn->SetState(TransactionState::ABORTED);
+    return;
+  }
+  page->RLatch();
+  for (const auto &rid : rids) {
+    BUSTUB_ASSERT(rid.GetPageId() == page_id, "rids must be on the same page");
+    Tuple tuple;
+    if (page->GetTuple(rid, &tuple, txn, lock_manager_)) {
+      tuples->emplace_back(std::move(tuple), rid);
+    }
+  }
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+}
+
 auto TableHeap::End() -> TableIterator { return {this, RID(INVALID_PAGE_ID, 0), nullptr}; }
 
 }  // namespace bustub
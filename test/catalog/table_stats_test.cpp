@@ -0,0 +1,180 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_stats_test.cpp
+//
+// Identification: test/catalog/table_stats_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "catalog/table_stats.h"
+#include "common/bustub_instance.h"
+#include "common/util/hyperloglog.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(TableStatsTest, HyperLogLogEstimate) {
+  for (int num_distinct : {1, 10, 1000, 100000}) {
+    HyperLogLog sketch;
+    for (int i = 0; i < num_distinct; i++) {
+      // Every value is added twice, duplicates must not count.
+      sketch.Add(ValueFactory::GetIntegerValue(i));
+      sketch.Add(ValueFactory::GetIntegerValue(i));
+    }
+    sketch.Add(ValueFactory::GetNullValueByType(TypeId::INTEGER));
+    EXPECT_NEAR(sketch.Estimate(), num_distinct, num_distinct * 0.05 + 1) << num_distinct;
+  }
+
+  HyperLogLog left;
+  HyperLogLog right;
+  for (int i = 0; i < 20000; i++) {
+    left.Add(ValueFactory::GetVarcharValue("key" + std::to_string(i)));
+    right.Add(ValueFactory::GetVarcharValue("key" + std::to_string(i + 10000)));
+  }
+  left.Merge(right);
+  EXPECT_NEAR(left.Estimate(), 30000, 30000 * 0.05);
+}
+
+// NOLINTNEXTLINE
+TEST(TableStatsTest, HistogramSelectivity) {
+  std::vector<Value> sample;
+  HyperLogLog sketch;
+  for (int i = 0; i < 10000; i++) {
+    sample.push_back(ValueFactory::GetIntegerValue(i));
+    sketch.Add(sample.back());
+  }
+  for (int i = 0; i < 2500; i++) {
+    sample.push_back(ValueFactory::GetNullValueByType(TypeId::INTEGER));
+  }
+  ColumnStats stats(std::move(sample), sketch, 64);
+
+  EXPECT_DOUBLE_EQ(stats.GetNullFraction(), 0.2);
+  EXPECT_NEAR(stats.GetDistinctCount(), 10000, 500);
+  EXPECT_EQ(stats.GetHistogramBounds().size(), 65);
+  EXPECT_EQ(stats.GetHistogramBounds().front().GetAs<int32_t>(), 0);
+  EXPECT_EQ(stats.GetHistogramBounds().back().GetAs<int32_t>(), 9999);
+
+  EXPECT_NEAR(stats.EstimateEqual(ValueFactory::GetIntegerValue(42)), 0.8 / 10000, 0.1 / 10000);
+  EXPECT_EQ(stats.EstimateEqual(ValueFactory::GetIntegerValue(-1)), 0);
+  EXPECT_EQ(stats.EstimateEqual(ValueFactory::GetIntegerValue(10000)), 0);
+
+  EXPECT_NEAR(stats.EstimateLess(ValueFactory::GetIntegerValue(5000), false), 0.4, 0.01);
+  EXPECT_NEAR(stats.EstimateLess(ValueFactory::GetIntegerValue(1234), true), 0.8 * 0.1234, 0.01);
+  EXPECT_NEAR(stats.EstimateGreater(ValueFactory::GetDecimalValue(7500.5), false), 0.2, 0.01);
+  EXPECT_EQ(stats.EstimateLess(ValueFactory::GetIntegerValue(-5), false), 0);
+  EXPECT_NEAR(stats.EstimateLess(ValueFactory::GetIntegerValue(20000), false), 0.8, 1e-9);
+  EXPECT_NEAR(stats.EstimateGreater(ValueFactory::GetIntegerValue(-5), true), 0.8, 1e-9);
+}
+
+// NOLINTNEXTLINE
+TEST(TableStatsTest, SkewedAndStringColumns) {
+  std::vector<Value> ints;
+  std::vector<Value> strings;
+  HyperLogLog int_sketch;
+  HyperLogLog string_sketch;
+  for (int i = 0; i < 1000; i++) {
+    // Nine rows in ten hold the same value.
+    ints.push_back(ValueFactory::GetIntegerValue(i % 10 == 0 ? i : 7));
+    int_sketch.Add(ints.back());
+    strings.push_back(ValueFactory::GetVarcharValue(fmt::format("s{:04}", i)));
+    string_sketch.Add(strings.back());
+  }
+  ColumnStats int_stats(std::move(ints), int_sketch, 16);
+  ColumnStats string_stats(std::move(strings), string_sketch, 16);
+
+  // Most of the histogram collapses onto the frequent value, so ranges around it see its weight.
+  EXPECT_GT(int_stats.EstimateLess(ValueFactory::GetIntegerValue(8), false), 0.8);
+  EXPECT_LT(int_stats.EstimateLess(ValueFactory::GetIntegerValue(7), false), 0.2);
+
+  EXPECT_NEAR(string_stats.EstimateLess(ValueFactory::GetVarcharValue("s0500"), false), 0.5, 0.05);
+  EXPECT_NEAR(string_stats.EstimateEqual(ValueFactory::GetVarcharValue("s0500")), 0.001, 0.0002);
+  // Values that cannot be compared without casting fall back to defaults instead of throwing.
+  EXPECT_GT(string_stats.EstimateLess(ValueFactory::GetIntegerValue(3), false), 0);
+}
+
+class AnalyzeTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    bustub_ = std::make_unique<BustubInstance>();
+    bustub_->GenerateTestTable();
+  }
+
+  auto Execute(const std::string &sql) -> std::string {
+    std::stringstream ss;
+    SimpleStreamWriter writer(ss, true, " ");
+    EXPECT_TRUE(bustub_->ExecuteSql(sql, writer));
+    return ss.str();
+  }
+
+  auto Stats(const std::string &table_name) -> const TableStats & {
+    return bustub_->catalog_->GetTable(table_name)->stats_;
+  }
+
+  std::unique_ptr<BustubInstance> bustub_;
+};
+
+// NOLINTNEXTLINE
+TEST_F(AnalyzeTest, AnalyzeTable) {
+  EXPECT_EQ(Stats("test_1").GetRowCount(), 1000);
+  EXPECT_FALSE(Stats("test_1").IsAnalyzed());
+  EXPECT_EQ(Stats("test_1").GetColumnStats(0), nullptr);
+
+  auto version = bustub_->catalog_->GetVersion();
+  EXPECT_EQ(Execute("analyze test_1;"), "Analyzed 1 table(s) \n");
+  EXPECT_NE(bustub_->catalog_->GetVersion(), version);
+  EXPECT_FALSE(Stats("test_2").IsAnalyzed());
+
+  const auto &stats = Stats("test_1");
+  ASSERT_TRUE(stats.IsAnalyzed());
+  EXPECT_EQ(stats.GetRowCount(), 1000);
+  // colA is serial, colB is uniform over 0..9.
+  EXPECT_NEAR(stats.GetColumnStats(0)->GetDistinctCount(), 1000, 50);
+  EXPECT_EQ(stats.GetColumnStats(1)->GetDistinctCount(), 10);
+  EXPECT_NEAR(stats.GetColumnStats(0)->EstimateLess(ValueFactory::GetIntegerValue(250), false), 0.25, 0.02);
+  EXPECT_NEAR(stats.GetColumnStats(1)->EstimateEqual(ValueFactory::GetIntegerValue(3)), 0.1, 1e-9);
+}
+
+// NOLINTNEXTLINE
+TEST_F(AnalyzeTest, AnalyzeAll) {
+  Execute("create table t1(k int, v int, s varchar(8));");
+  Execute("insert into t1 values (1, null, 'a'), (2, 20, 'b'), (3, null, 'a'), (4, 40, 'b');");
+  Execute("analyze;");
+  EXPECT_TRUE(Stats("test_1").IsAnalyzed());
+  EXPECT_TRUE(Stats("test_2").IsAnalyzed());
+  ASSERT_TRUE(Stats("t1").IsAnalyzed());
+  EXPECT_DOUBLE_EQ(Stats("t1").GetColumnStats(1)->GetNullFraction(), 0.5);
+  EXPECT_EQ(Stats("t1").GetColumnStats(1)->GetDistinctCount(), 2);
+  EXPECT_EQ(Stats("t1").GetColumnStats(2)->GetDistinctCount(), 2);
+  EXPECT_DOUBLE_EQ(Stats("t1").GetColumnStats(2)->EstimateEqual(ValueFactory::GetVarcharValue("a")), 0.5);
+
+  std::stringstream ss;
+  SimpleStreamWriter writer(ss, true, " ");
+  EXPECT_THROW(bustub_->ExecuteSql("analyze no_such_table;", writer), Exception);
+}
+
+// NOLINTNEXTLINE
+TEST_F(AnalyzeTest, RowCountFollowsWrites) {
+  Execute("create table t1(k int, v int);");
+  EXPECT_EQ(Stats("t1").GetRowCount(), 0);
+  Execute("insert into t1 values (1, 10), (2, 20), (3, 30);");
+  EXPECT_EQ(Stats("t1").GetRowCount(), 3);
+  Execute("analyze t1;");
+  Execute("insert into t1 values (4, 40);");
+  Execute("delete from t1 where k < 3;");
+  // The row count stays exact between ANALYZEs, the column statistics do not change.
+  EXPECT_EQ(Stats("t1").GetRowCount(), 2);
+  EXPECT_EQ(Stats("t1").GetColumnStats(0)->GetHistogramBounds().back().GetAs<int32_t>(), 3);
+}
+
+}  // namespace bustub
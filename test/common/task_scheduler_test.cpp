@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// task_scheduler_test.cpp
+//
+// Identification: test/common/task_scheduler_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include "common/task_scheduler.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(TaskSchedulerTest, RunAllTasks) {
+  TaskScheduler scheduler(4);
+  std::atomic<int> sum{0};
+  TaskGroup group(&scheduler);
+  for (int i = 1; i <= 1000; i++) {
+    group.Run([&sum, i] { sum += i; });
+  }
+  group.Wait();
+  EXPECT_EQ(500500, sum);
+}
+
+TEST(TaskSchedulerTest, NestedTasks) {
+  // Tasks that spawn and wait for more tasks must not deadlock, even with a single worker.
+  TaskScheduler scheduler(1);
+  std::atomic<int> count{0};
+  TaskGroup outer(&scheduler);
+  for (int i = 0; i < 8; i++) {
+    outer.Run([&scheduler, &count] {
+      TaskGroup inner(&scheduler);
+      for (int j = 0; j < 8; j++) {
+        inner.Run([&count] { count++; });
+      }
+      inner.Wait();
+    });
+  }
+  outer.Wait();
+  EXPECT_EQ(64, count);
+}
+
+TEST(TaskSchedulerTest, WorkerIndex) {
+  TaskScheduler scheduler(2);
+  EXPECT_EQ(2, scheduler.GetCurrentWorkerIndex());
+  std::vector<size_t> indexes(100);
+  TaskGroup group(&scheduler);
+  for (size_t i = 0; i < indexes.size(); i++) {
+    group.Run([&scheduler, &indexes, i] { indexes[i] = scheduler.GetCurrentWorkerIndex(); });
+  }
+  group.Wait();
+  for (auto index : indexes) {
+    // The waiting thread helps out with queued tasks, so it may show up as well.
+    EXPECT_LE(index, 2);
+  }
+}
+
+TEST(TaskSchedulerTest, PropagateException) {
+  TaskScheduler scheduler(2);
+  TaskGroup group(&scheduler);
+  std::atomic<int> count{0};
+  for (int i = 0; i < 10; i++) {
+    group.Run([&count, i] {
+      if (i == 5) {
+        throw std::runtime_error("task failed");
+      }
+      count++;
+    });
+  }
+  EXPECT_THROW(group.Wait(), std::runtime_error);
+  EXPECT_EQ(9, count);
+  // The error has been consumed.
+  group.Wait();
+}
+
+TEST(TaskSchedulerTest, InlineGroup) {
+  TaskGroup group(nullptr);
+  int count = 0;
+  for (int i = 0; i < 10; i++) {
+    group.Run([&count] { count++; });
+  }
+  EXPECT_EQ(10, count);
+  group.Wait();
+}
+
+}  // namespace bustub
@@ -0,0 +1,221 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregation_executor_test.cpp
+//
+// Identification: test/execution/aggregation_executor_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/bustub_instance.h"
+#include "common/config.h"
+#include "common/util/string_util.h"
+#include "execution/executors/aggregation_executor.h"
+#include "execution/expressions/column_value_expression.h"
+#include "executor_test_util.h"  // NOLINT
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+class AggregationExecutorTest : public ExecutorTest {};
+
+// NOLINTNEXTLINE
+TEST_F(AggregationExecutorTest, SpillDistinctGroups) {
+  // Every row is its own group, so most groups go through several levels of partitioning.
+  operator_memory_limit = 64 << 10;
+  auto rows = Query("select x, count(*), sum(y), min(y) from __mock_t2_100k group by x;");
+  ASSERT_EQ(rows.size(), 100000);
+  std::vector<bool> seen(100000, false);
+  for (const auto &row : rows) {
+    ASSERT_EQ(row.size(), 4);
+    auto x = std::stoi(row[0]);
+    ASSERT_EQ(row[1], "1");
+    ASSERT_EQ(std::stoi(row[2]), x * 100);
+    ASSERT_EQ(std::stoi(row[3]), x * 100);
+    ASSERT_FALSE(seen[x]);
+    seen[x] = true;
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(AggregationExecutorTest, SpillRepeatedGroups) {
+  // Only a few of the 100 groups fit, the others keep being spilled while the ones in memory are updated in place.
+  operator_memory_limit = 2 << 10;
+  auto rows = Query("select v3, count(*), sum(v2), min(v2), max(v2), count(v6) from __mock_agg_input_big group by v3;");
+  ASSERT_EQ(rows.size(), 100);
+  std::vector<bool> seen(100, false);
+  for (const auto &row : rows) {
+    ASSERT_EQ(row.size(), 6);
+    auto v3 = std::stoi(row[0]);
+    auto first = (v3 + 50) % 100;
+    ASSERT_EQ(row[1], "100");
+    ASSERT_EQ(std::stoi(row[2]), first * 100 + 495000);
+    ASSERT_EQ(std::stoi(row[3]), first);
+    ASSERT_EQ(std::stoi(row[4]), first + 9900);
+    ASSERT_EQ(row[5], "100");
+    ASSERT_FALSE(seen[v3]);
+    seen[v3] = true;
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(AggregationExecutorTest, SharedQueryBudget) {
+  // The join gives its memory back after the probe, while the aggregation above it is still spilling groups.
+  NoopWriter writer;
+  ASSERT_TRUE(bustub_->ExecuteSql("set query_memory_limit=500000;", writer));
+  auto rows = Query(
+      "select count(*), sum(c) from (select a.x as g, count(*) as c from __mock_t1_50k a join __mock_t2_100k b "
+      "on a.x = b.x group by a.x);");
+  ASSERT_EQ(rows, std::vector<std::vector<std::string>>({{"10000", "10000"}}));
+
+  // Without any budget, even the single group of an aggregation without group bys is spilled.
+  ASSERT_TRUE(bustub_->ExecuteSql("set query_memory_limit=1;", writer));
+  rows = Query("select count(*), min(x), max(x) from __mock_t1_50k;");
+  ASSERT_EQ(rows, std::vector<std::vector<std::string>>({{"50000", "0", "499990"}}));
+}
+
+// NOLINTNEXTLINE
+TEST_F(AggregationExecutorTest, VarcharGroups) {
+  operator_memory_limit = 1 << 10;
+  auto rows = Query("select v6, v1, count(*), max(v4) from __mock_agg_input_big group by v6, v1;");
+  // v6 repeats every 16 rows and v1 every 10, so there are lcm(16, 10) = 80 groups of 125 rows each.
+  ASSERT_EQ(rows.size(), 80);
+  std::set<std::pair<std::string, std::string>> groups;
+  for (const auto &row : rows) {
+    ASSERT_EQ(row.size(), 4);
+    ASSERT_EQ(row[2], "125");
+    ASSERT_TRUE(groups.emplace(row[0], row[1]).second);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(AggregationExecutorTest, VarcharMinMax) {
+  NoopWriter writer;
+  ASSERT_TRUE(bustub_->ExecuteSql("create table t(a int, s varchar(16));", writer));
+  ASSERT_TRUE(bustub_->ExecuteSql(
+      "insert into t values (1, 'pear'), (1, 'apple'), (2, 'zz'), (1, 'banana'), (2, 'z'), (2, 'zza'), (3, 'b');",
+      writer));
+  for (auto memory_limit : {saved_memory_limit_, size_t{0}}) {
+    operator_memory_limit = memory_limit;
+    auto rows = Query("select a, min(s), max(s) from t group by a;");
+    std::sort(rows.begin(), rows.end());
+    ASSERT_EQ(rows, std::vector<std::vector<std::string>>(
+                        {{"1", "apple", "pear"}, {"2", "z", "zza"}, {"3", "b", "b"}}));
+    ASSERT_EQ(Query("select min(s), max(s), count(s) from t;"),
+              std::vector<std::vector<std::string>>({{"apple", "zza", "7"}}));
+    ASSERT_EQ(Query("select min(s), max(s) from t where a > 5;"),
+              std::vector<std::vector<std::string>>({{"varlen_null", "varlen_null"}}));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(AggregationExecutorTest, ParallelAggregation) {
+  const std::vector<std::string> queries{
+      "select v1, count(*), sum(v2), min(v4), max(v2), count(v6) from __mock_agg_input_big group by v1;",
+      "select v6, v3, count(*), sum(v2) from __mock_agg_input_big where v2 > 100 group by v6, v3;",
+      "select x, sum(y) from __mock_t2_100k where x < 30000 group by x;",
+      "select count(*), sum(x), min(y), max(y) from __mock_t1_50k where x < 100000;",
+      "select count(*), sum(x) from __mock_t1_50k where x < 0;",
+      "select x, count(*) from __mock_t1_50k where x < 0 group by x;",
+      "select v1, min(v6), max(v6), count(*) from __mock_agg_input_big group by v1;",
+  };
+  NoopWriter writer;
+  for (const auto &query : queries) {
+    auto expected = Query(query);
+    std::sort(expected.begin(), expected.end());
+    bustub_->ExecuteSql("set execution_threads = 4;", writer);
+    auto rows = Query(query);
+    std::sort(rows.begin(), rows.end());
+    ASSERT_EQ(rows, expected) << query;
+    // The partials outgrow the memory limit and spill.
+    operator_memory_limit = 64 << 10;
+    rows = Query(query);
+    std::sort(rows.begin(), rows.end());
+    ASSERT_EQ(rows, expected) << query;
+    operator_memory_limit = saved_memory_limit_;
+    bustub_->ExecuteSql("set execution_threads = 1;", writer);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(AggregationExecutorTest, ParallelAggregationStaysWithinBudget) {
+  // Almost every group is spilled by the first phase, and the final tables must spill them again to fit the budget.
+  constexpr size_t memory_limit = 256 << 10;
+  NoopWriter writer;
+  ASSERT_TRUE(bustub_->ExecuteSql("set execution_threads = 4;", writer));
+  ASSERT_TRUE(bustub_->ExecuteSql("set query_memory_limit = " + std::to_string(memory_limit) + ";", writer));
+  ASSERT_EQ(Query("select count(*), sum(c) from (select x, count(*) as c from __mock_t2_100k group by x);"),
+            std::vector<std::vector<std::string>>({{"100000", "100000"}}));
+  // A table may go over its share of the budget by one growth step before it starts spilling.
+  ASSERT_LE(PeakMemory("select x, count(*) from __mock_t2_100k group by x;"), memory_limit * 2);
+}
+
+// NOLINTNEXTLINE
+TEST_F(AggregationExecutorTest, ParallelAggregationChargesItsTables) {
+  // Nothing spills, the 100000 groups are held by the partials and then by the final tables.
+  NoopWriter writer;
+  ASSERT_TRUE(bustub_->ExecuteSql("set execution_threads = 4;", writer));
+  ASSERT_GE(PeakMemory("select x, count(*) from __mock_t2_100k group by x;"), 100000 * 3 * sizeof(uint64_t));
+}
+
+// NOLINTNEXTLINE
+TEST(AggregationHashTableTest, NegativeZeroDecimalKey) {
+  Schema schema({Column("d", TypeId::DECIMAL)});
+  std::vector<AbstractExpressionRef> exprs{std::make_shared<ColumnValueExpression>(0, 0, TypeId::DECIMAL)};
+  std::vector<AggregationType> agg_types{AggregationType::CountStarAggregate};
+  AggregationHashTable table(exprs, exprs, agg_types);
+  AggregationHashTable::GroupKey key;
+  for (auto d : {0.0, -0.0, 1.0}) {
+    Tuple tuple({ValueFactory::GetDecimalValue(d)}, &schema);
+    table.EncodeKey(tuple, schema, &key);
+    table.Update(table.FindGroup(key, true), tuple, schema);
+  }
+  ASSERT_EQ(table.Size(), 2);
+  ASSERT_EQ(table.GetGroupValues(0)[1].GetAs<int32_t>(), 2);
+}
+
+// NOLINTNEXTLINE
+TEST_F(AggregationExecutorTest, StreamAggregation) {
+  // The test tables take the header page, which the B+ tree index keeps its root in.
+  bustub_->GenerateTestTable();
+  Execute("create table t(x int, y int);");
+  Execute("insert into t select x, y from __mock_t2_100k where x < 5000;");
+  Execute("create index tx on t(x);");
+  // A range scan or a limit reads the index in key order and aggregates group by group, the same aggregation over
+  // the mock table hashes its groups and gives the expected rows.
+  const std::vector<std::pair<std::string, std::string>> queries{
+      {"select x, count(*), sum(y), min(y), max(y) from {} where x >= 1000 and x < 4000 group by x", ""},
+      {"select x, sum(y) from {} where x >= 2000 and x < 2500 group by x", "order by x"},
+      {"select x, count(*) from {} group by x", "order by x limit 100"},
+  };
+  for (const auto &[query, order_by] : queries) {
+    auto sql = [&](const char *table) {
+      return fmt::format("{} {};", fmt::format(fmt::runtime(query), table), order_by);
+    };
+    auto plan = Execute("explain (o) " + sql("t"));
+    ASSERT_TRUE(StringUtil::Contains(plan, "StreamAgg")) << plan;
+    auto rows = Query(sql("t"));
+    auto expected = Query(sql("__mock_t2_100k"));
+    if (order_by.empty()) {
+      std::sort(rows.begin(), rows.end());
+      std::sort(expected.begin(), expected.end());
+    }
+    ASSERT_FALSE(rows.empty()) << query;
+    ASSERT_EQ(rows, expected) << query;
+  }
+  // Without an ordered input the groups are hashed and sorted afterwards.
+  auto plan = Execute("explain (o) select x, count(*) from t group by x order by x;");
+  ASSERT_FALSE(StringUtil::Contains(plan, "StreamAgg")) << plan;
+}
+
+}  // namespace bustub
@@ -0,0 +1,89 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// explain_analyze_test.cpp
+//
+// Identification: test/execution/explain_analyze_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "common/util/string_util.h"
+#include "executor_test_util.h"  // NOLINT
+#include "fmt/format.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+class ExplainAnalyzeTest : public ExecutorTest {
+ protected:
+  void SetUp() override {
+    ExecutorTest::SetUp();
+    // Operators inside parallel pipelines are not instrumented, so profile serial plans only.
+    Execute("set execution_threads = 1;");
+  }
+
+  /** Run EXPLAIN ANALYZE and return the lines of the annotated plan */
+  auto Analyze(const std::string &sql) -> std::vector<std::string> {
+    auto lines = StringUtil::Split(Execute("explain analyze " + sql), '\n');
+    auto header = std::find(lines.begin(), lines.end(), "=== ANALYZE ===");
+    EXPECT_NE(header, lines.end());
+    return {header == lines.end() ? header : header + 1, lines.end()};
+  }
+};
+
+// NOLINTNEXTLINE
+TEST_F(ExplainAnalyzeTest, RowsPerOperator) {
+  auto lines = Analyze("select x from __mock_t1_50k where x < 1000;");
+  ASSERT_GE(lines.size(), 3);
+  // The projection produces what the filter lets through, out of all rows of the scan.
+  EXPECT_EQ(lines[0].rfind("Projection", 0), 0) << lines[0];
+  EXPECT_NE(lines[0].find("(rows=100,"), std::string::npos) << lines[0];
+  EXPECT_NE(lines[1].find("Filter"), std::string::npos) << lines[1];
+  EXPECT_NE(lines[1].find("(rows=100,"), std::string::npos) << lines[1];
+  EXPECT_NE(lines[2].find("MockScan"), std::string::npos) << lines[2];
+  EXPECT_NE(lines[2].find("(rows=50000,"), std::string::npos) << lines[2];
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExplainAnalyzeTest, PagesAndSpills) {
+  Execute("create table t1(v1 int, v2 int);");
+  std::string values;
+  for (int i = 0; i < 2000; i++) {
+    values += fmt::format("{}({}, {})", i == 0 ? "" : ", ", i, 2000 - i);
+  }
+  Execute(fmt::format("insert into t1 values {};", values));
+
+  auto lines = Analyze("select * from t1;");
+  ASSERT_GE(lines.size(), 1);
+  EXPECT_NE(lines[0].find("(rows=2000,"), std::string::npos) << lines[0];
+  EXPECT_EQ(lines[0].find("pages=0,"), std::string::npos) << lines[0];
+
+  // A sort that does not fit its memory spills runs to temporary pages.
+  operator_memory_limit = 16 << 10;
+  lines = Analyze("select * from t1 order by v2;");
+  ASSERT_GE(lines.size(), 2);
+  EXPECT_EQ(lines[0].rfind("Sort", 0), 0) << lines[0];
+  EXPECT_NE(lines[0].find("(rows=2000,"), std::string::npos) << lines[0];
+  EXPECT_EQ(lines[0].find("spilled=0)"), std::string::npos) << lines[0];
+  EXPECT_NE(lines[1].find("spilled=0)"), std::string::npos) << lines[1];
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExplainAnalyzeTest, CombinesWithOtherOptions) {
+  auto output = Execute("explain (o, analyze) select * from __mock_t3_1k;");
+  EXPECT_NE(output.find("=== OPTIMIZER ==="), std::string::npos);
+  EXPECT_NE(output.find("=== ANALYZE ==="), std::string::npos);
+  EXPECT_EQ(output.find("=== PLANNER ==="), std::string::npos);
+  // A plain EXPLAIN does not run the query.
+  EXPECT_EQ(Execute("explain select * from __mock_t3_1k;").find("=== ANALYZE ==="), std::string::npos);
+}
+
+}  // namespace bustub
@@ -0,0 +1,160 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_join_executor_test.cpp
+//
+// Identification: test/execution/hash_join_executor_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "common/config.h"
+#include "common/util/hash_util.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/runtime_filter.h"
+#include "executor_test_util.h"  // NOLINT
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+class HashJoinExecutorTest : public ExecutorTest {};
+
+// NOLINTNEXTLINE
+TEST_F(HashJoinExecutorTest, SpillInnerJoin) {
+  // Force the 100k rows of the build side through several levels of Grace partitioning.
+  operator_memory_limit = 8 << 10;
+  auto rows = Query("select * from __mock_t3_1k a inner join __mock_t2_100k b on a.x = b.x;");
+  ASSERT_EQ(rows.size(), 1000);
+  std::vector<bool> seen(1000, false);
+  for (const auto &row : rows) {
+    ASSERT_GE(row.size(), 4);
+    auto x = std::stoi(row[0]);
+    ASSERT_EQ(row[2], row[0]);
+    ASSERT_EQ(std::stoi(row[3]), x * 100);
+    ASSERT_FALSE(seen[x / 100]);
+    seen[x / 100] = true;
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(HashJoinExecutorTest, SpillLeftJoin) {
+  operator_memory_limit = 64 << 10;
+  auto rows = Query(
+      "select * from __mock_t3_1k a left join (select * from __mock_t2_100k where x < 50000) b on a.x = b.x;");
+  ASSERT_EQ(rows.size(), 1000);
+  size_t matched = 0;
+  for (const auto &row : rows) {
+    auto x = std::stoi(row[0]);
+    if (x < 50000) {
+      ASSERT_EQ(row[2], row[0]);
+      matched++;
+    } else {
+      ASSERT_EQ(row[2], "integer_null");
+    }
+  }
+  ASSERT_EQ(matched, 500);
+}
+
+// NOLINTNEXTLINE
+TEST(HashJoinKeyTest, IntegerKeysDoNotCollide) {
+  // Every bit of the hash picks partitions at some depth, so every byte of it should be evenly spread.
+  constexpr int num_keys = 1 << 20;
+  std::unordered_set<hash_t> hashes;
+  std::vector<size_t> low_bytes(256);
+  std::vector<size_t> high_bytes(256);
+  for (int i = 0; i < num_keys; i++) {
+    auto hash = HashUtil::HashKey(ValueFactory::GetIntegerValue(i));
+    hashes.insert(hash);
+    low_bytes[hash & 0xFF]++;
+    high_bytes[hash >> 56]++;
+  }
+  ASSERT_EQ(hashes.size(), num_keys);
+  for (size_t i = 0; i < 256; i++) {
+    ASSERT_NEAR(low_bytes[i], num_keys / 256, num_keys / 256 / 10);
+    ASSERT_NEAR(high_bytes[i], num_keys / 256, num_keys / 256 / 10);
+  }
+  ASSERT_EQ(HashUtil::HashKey(ValueFactory::GetIntegerValue(42)), HashUtil::HashKey(ValueFactory::GetBigIntValue(42)));
+}
+
+// NOLINTNEXTLINE
+TEST(RuntimeFilterTest, FilterTest) {
+  Schema schema({Column("k", TypeId::INTEGER)});
+  RuntimeFilter filter(std::make_shared<ColumnValueExpression>(0, 0, TypeId::INTEGER));
+  auto make_tuple = [&](const Value &key) { return Tuple({key}, &schema); };
+
+  for (int i = 0; i < 20000; i += 2) {
+    filter.Insert(ValueFactory::GetIntegerValue(i));
+  }
+  // Nothing is filtered before the filter is built.
+  ASSERT_TRUE(filter.MayContain(make_tuple(ValueFactory::GetIntegerValue(-1)), schema));
+  filter.Build();
+
+  for (int i = 0; i < 20000; i += 2) {
+    ASSERT_TRUE(filter.MayContain(make_tuple(ValueFactory::GetIntegerValue(i)), schema));
+  }
+  size_t false_positives = 0;
+  for (int i = 1; i < 20000; i += 2) {
+    false_positives += filter.MayContain(make_tuple(ValueFactory::GetIntegerValue(i)), schema) ? 1 : 0;
+  }
+  ASSERT_LT(false_positives, 200);
+  // Keys out of the build side range and null keys never pass.
+  ASSERT_FALSE(filter.MayContain(make_tuple(ValueFactory::GetIntegerValue(-2)), schema));
+  ASSERT_FALSE(filter.MayContain(make_tuple(ValueFactory::GetIntegerValue(20000)), schema));
+  ASSERT_FALSE(filter.MayContain(make_tuple(ValueFactory::GetNullValueByType(TypeId::INTEGER)), schema));
+
+  filter.Clear();
+  ASSERT_TRUE(filter.MayContain(make_tuple(ValueFactory::GetIntegerValue(-2)), schema));
+  filter.Build();
+  ASSERT_FALSE(filter.MayContain(make_tuple(ValueFactory::GetIntegerValue(0)), schema));
+}
+
+// NOLINTNEXTLINE
+TEST(RuntimeFilterTest, MemoryLimit) {
+  Schema schema({Column("k", TypeId::INTEGER)});
+  RuntimeFilter filter(std::make_shared<ColumnValueExpression>(0, 0, TypeId::INTEGER));
+  auto make_tuple = [&](const Value &key) { return Tuple({key}, &schema); };
+
+  // Far more keys than fit into the limit, the filter stops buffering their hashes and sets their bits directly.
+  constexpr size_t memory_limit = 64 << 10;
+  filter.Clear(memory_limit);
+  for (int i = 0; i < 100000; i += 2) {
+    filter.Insert(ValueFactory::GetIntegerValue(i));
+    ASSERT_LE(filter.GetMemoryUsage(), memory_limit);
+  }
+  filter.Build();
+  ASSERT_LE(filter.GetMemoryUsage(), memory_limit);
+  for (int i = 0; i < 100000; i += 2) {
+    ASSERT_TRUE(filter.MayContain(make_tuple(ValueFactory::GetIntegerValue(i)), schema));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(HashJoinExecutorTest, SelectiveBuildSide) {
+  // The build side keeps 50 of the 100k probe side keys, the others are dropped by the runtime filter in the scan.
+  auto check = [](const std::vector<std::vector<std::string>> &rows) {
+    ASSERT_EQ(rows.size(), 50);
+    for (const auto &row : rows) {
+      ASSERT_EQ(row[0], row[2]);
+      ASSERT_LT(std::stoi(row[0]), 5000);
+    }
+  };
+  const std::string sql =
+      "select * from __mock_t2_100k a inner join (select * from __mock_t3_1k where x < 5000) b on a.x = b.x;";
+  check(Query(sql));
+  Query("set execution_threads = 4;");
+  check(Query(sql));
+  // Nested joins push one filter each into the shared probe side.
+  auto rows = Query(
+      "select * from __mock_t2_100k a inner join (select * from __mock_t3_1k where x < 5000) b on a.x = b.x "
+      "inner join (select * from __mock_t1_50k where x < 3000) c on a.x = c.x;");
+  ASSERT_EQ(rows.size(), 30);
+}
+
+}  // namespace bustub
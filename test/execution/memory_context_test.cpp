@@ -0,0 +1,85 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// memory_context_test.cpp
+//
+// Identification: test/execution/memory_context_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "common/bustub_instance.h"
+#include "common/config.h"
+#include "common/util/string_util.h"
+#include "execution/memory_context.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+class MemoryContextTest : public ::testing::Test {
+ protected:
+  void SetUp() override { saved_memory_limit_ = operator_memory_limit; }
+
+  void TearDown() override { operator_memory_limit = saved_memory_limit_; }
+
+  size_t saved_memory_limit_;
+};
+
+// NOLINTNEXTLINE
+TEST_F(MemoryContextTest, ReservationTest) {
+  operator_memory_limit = 800;
+  MemoryContext context(1000);
+  auto first = context.MakeReservation();
+  auto second = context.MakeReservation();
+
+  ASSERT_TRUE(first->Resize(600));
+  ASSERT_EQ(second->GetBudget(), 400);
+  ASSERT_TRUE(second->Resize(400));
+  // Over the query limit, but the reservation still records what the operator holds.
+  ASSERT_FALSE(second->Resize(500));
+  ASSERT_EQ(context.GetUsage(), 1100);
+  ASSERT_TRUE(second->Resize(300));
+
+  // Over the operator limit with room left in the query.
+  ASSERT_TRUE(first->Resize(100));
+  ASSERT_EQ(first->GetBudget(), 700);
+  ASSERT_FALSE(first->Resize(900));
+  ASSERT_EQ(first->GetPeakBytes(), 900);
+
+  first = nullptr;
+  ASSERT_EQ(context.GetUsage(), 300);
+  ASSERT_EQ(context.GetPeakUsage(), 1200);
+}
+
+// NOLINTNEXTLINE
+TEST_F(MemoryContextTest, QueryLimitTest) {
+  auto bustub = std::make_unique<BustubInstance>();
+  bustub->GenerateMockTable();
+  std::stringstream ss;
+  SimpleStreamWriter writer(ss, true, " ");
+  // Every operator would be allowed 64 MB, the query budget alone forces the sort and the join to spill.
+  ASSERT_TRUE(bustub->ExecuteSql("set query_memory_limit=16384", writer));
+  ASSERT_TRUE(bustub->ExecuteSql(
+      "select t1.x, t2.y from __mock_t1_50k t1 inner join __mock_t2_100k t2 on t1.x = t2.x order by t1.x desc;",
+      writer));
+  std::vector<std::vector<std::string>> rows;
+  for (const auto &line : StringUtil::Split(ss.str(), '\n')) {
+    if (!line.empty()) {
+      rows.push_back(StringUtil::Split(line, ' '));
+    }
+  }
+  ASSERT_EQ(rows.size(), 10000);
+  for (size_t i = 0; i < rows.size(); i++) {
+    auto x = static_cast<int>(9999 - i) * 10;
+    ASSERT_EQ(std::stoi(rows[i][0]), x);
+    ASSERT_EQ(std::stoi(rows[i][1]), x * 100);
+  }
+}
+
+}  // namespace bustub
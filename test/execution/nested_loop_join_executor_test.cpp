@@ -0,0 +1,57 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// nested_loop_join_executor_test.cpp
+//
+// Identification: test/execution/nested_loop_join_executor_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <string>
+
+#include "common/config.h"
+#include "executor_test_util.h"  // NOLINT
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+class NestedLoopJoinExecutorTest : public ExecutorTest {};
+
+// NOLINTNEXTLINE
+TEST_F(NestedLoopJoinExecutorTest, ThetaJoinManyBlocks) {
+  // A tiny budget splits the outer side into blocks of a few tuples each.
+  operator_memory_limit = 256;
+  auto rows = Query("select * from __mock_t3_1k a inner join __mock_table_123 b on a.x < b.number + 200;");
+  // x = 0, 100 and 200 pass for every b, none of the other x values do.
+  ASSERT_EQ(rows.size(), 9);
+  for (const auto &row : rows) {
+    ASSERT_LT(std::stoi(row[0]), std::stoi(row[2]) + 200);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(NestedLoopJoinExecutorTest, LeftThetaJoinManyBlocks) {
+  operator_memory_limit = 256;
+  auto rows = Query("select * from __mock_t3_1k a left join __mock_table_123 b on a.x < b.number;");
+  ASSERT_EQ(rows.size(), 3 + 999);
+  size_t unmatched = 0;
+  for (const auto &row : rows) {
+    if (row[2] == "integer_null") {
+      ASSERT_NE(row[0], "0");
+      unmatched++;
+    }
+  }
+  ASSERT_EQ(unmatched, 999);
+}
+
+// NOLINTNEXTLINE
+TEST_F(NestedLoopJoinExecutorTest, BlockStaysWithinBudget) {
+  constexpr size_t memory_limit = 1000;
+  Execute("set query_memory_limit = " + std::to_string(memory_limit) + ";");
+  ASSERT_LE(PeakMemory("select * from __mock_t3_1k a inner join __mock_table_123 b on a.x < b.number;"), memory_limit);
+}
+
+}  // namespace bustub
@@ -0,0 +1,141 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_executor_test.cpp
+//
+// Identification: test/execution/sort_executor_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <string>
+#include <vector>
+
+#include "common/bustub_instance.h"
+#include "common/config.h"
+#include "execution/loser_tree.h"
+#include "executor_test_util.h"  // NOLINT
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+class SortExecutorTest : public ExecutorTest {};
+
+// NOLINTNEXTLINE
+TEST(LoserTreeTest, MergeTest) {
+  std::vector<std::vector<int>> streams{{1, 4, 9}, {}, {2, 3, 10, 11}, {0, 5}, {6, 7, 8}};
+  std::vector<size_t> cursors(streams.size(), 0);
+  auto exhausted = [&](size_t i) { return cursors[i] == streams[i].size(); };
+  LoserTree tree(streams.size(), [&](size_t a, size_t b) {
+    if (exhausted(a) || exhausted(b)) {
+      return !exhausted(a) || (exhausted(b) && a < b);
+    }
+    return streams[a][cursors[a]] < streams[b][cursors[b]];
+  });
+  std::vector<int> merged;
+  while (!exhausted(tree.Top())) {
+    merged.push_back(streams[tree.Top()][cursors[tree.Top()]++]);
+    tree.Replay();
+  }
+  ASSERT_EQ(merged, std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11}));
+}
+
+// NOLINTNEXTLINE
+TEST_F(SortExecutorTest, ExternalSort) {
+  // Spill a few hundred runs, so that they have to be merged in more than one pass.
+  operator_memory_limit = 16 << 10;
+  auto rows = Query("select * from __mock_t1_50k order by y desc;");
+  ASSERT_EQ(rows.size(), 50000);
+  for (size_t i = 0; i < rows.size(); i++) {
+    ASSERT_EQ(std::stoi(rows[i][0]), static_cast<int>(49999 - i) * 10);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(SortExecutorTest, ExternalSortMultipleKeys) {
+  operator_memory_limit = 16 << 10;
+  auto rows = Query("select v1, v6, v2 from __mock_agg_input_big order by v1 desc, v6, v2;");
+  ASSERT_EQ(rows.size(), 10000);
+  for (size_t i = 1; i < rows.size(); i++) {
+    const auto &prev = rows[i - 1];
+    const auto &row = rows[i];
+    ASSERT_GE(std::stoi(prev[0]), std::stoi(row[0]));
+    if (prev[0] == row[0]) {
+      ASSERT_LE(prev[1], row[1]);
+      if (prev[1] == row[1]) {
+        ASSERT_LT(std::stoi(prev[2]), std::stoi(row[2]));
+      }
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(SortExecutorTest, NormalizedKeys) {
+  // Strings share prefixes longer than the normalized key, and the left join produces null keys.
+  NoopWriter writer;
+  std::string values;
+  for (int i = 0; i < 1000; i++) {
+    auto b = i % 7 == 0 ? std::string(i % 2 == 0 ? "r" : "row") : "row_prefix_" + std::to_string(i % 23);
+    values += fmt::format("{}({}, '{}')", i == 0 ? "" : ", ", (i * 37) % 101 - 50, b);
+  }
+  ASSERT_TRUE(bustub_->ExecuteSql("create table t(a int, b varchar(32));", writer));
+  ASSERT_TRUE(bustub_->ExecuteSql("create table u(a int);", writer));
+  ASSERT_TRUE(bustub_->ExecuteSql("insert into t values " + values + ";", writer));
+  ASSERT_TRUE(bustub_->ExecuteSql("insert into u values (-50), (-20), (-1), (0), (7), (31), (50);", writer));
+
+  // Compares cells of integer columns, nulls first.
+  auto compare_int = [](const std::string &lhs, const std::string &rhs) {
+    auto left = lhs == "integer_null" ? INT64_MIN : std::stoll(lhs);
+    auto right = rhs == "integer_null" ? INT64_MIN : std::stoll(rhs);
+    return left < right ? -1 : (left > right ? 1 : 0);
+  };
+  auto compare_string = [](const std::string &lhs, const std::string &rhs) { return lhs.compare(rhs); };
+  for (auto memory_limit : {saved_memory_limit_, size_t{16} << 10}) {
+    operator_memory_limit = memory_limit;
+
+    auto rows = Query("select b, a from t order by b desc, a;");
+    ASSERT_EQ(rows.size(), 1000);
+    for (size_t i = 1; i < rows.size(); i++) {
+      auto cmp = compare_string(rows[i - 1][0], rows[i][0]);
+      ASSERT_TRUE(cmp > 0 || (cmp == 0 && compare_int(rows[i - 1][1], rows[i][1]) <= 0)) << i;
+    }
+
+    rows = Query("select u.a, t.b, t.a from t left join u on t.a = u.a order by u.a desc, t.b, t.a desc;");
+    ASSERT_EQ(rows.size(), 1000);
+    ASSERT_EQ(rows.back()[0], "integer_null");
+    for (size_t i = 1; i < rows.size(); i++) {
+      auto cmp = compare_int(rows[i - 1][0], rows[i][0]);
+      if (cmp == 0) {
+        cmp = -compare_string(rows[i - 1][1], rows[i][1]);
+        if (cmp == 0) {
+          cmp = compare_int(rows[i - 1][2], rows[i][2]);
+        }
+      }
+      ASSERT_GE(cmp, 0) << i;
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(SortExecutorTest, ParallelTopN) {
+  // The sort keys are unique, so the result does not depend on which task sees a row first.
+  const std::vector<std::string> queries{
+      "select * from __mock_t1_50k order by y desc limit 10;",
+      "select x, y from __mock_t2_100k where x > 5000 order by y, x limit 100;",
+      "select v1, v6, v2 from __mock_agg_input_big order by v1 desc, v6, v2 limit 25;",
+      "select * from __mock_t1_50k order by x + y desc limit 3;",
+      "select * from __mock_t1_50k order by x limit 0;",
+      "select * from __mock_t1_50k where x < 0 order by x limit 5;",
+  };
+  NoopWriter writer;
+  for (const auto &query : queries) {
+    auto expected = Query(query);
+    bustub_->ExecuteSql("set execution_threads = 4;", writer);
+    ASSERT_EQ(Query(query), expected) << query;
+    bustub_->ExecuteSql("set execution_threads = 1;", writer);
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,70 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// executor_test_util.h
+//
+// Identification: test/include/executor_test_util.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "common/bustub_instance.h"
+#include "common/config.h"
+#include "common/util/string_util.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+/**
+ * A fixture running SQL against a BusTub instance with the mock tables. Tests may lower `operator_memory_limit` to
+ * force operators to spill, it is restored after every test.
+ */
+class ExecutorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    bustub_ = std::make_unique<BustubInstance>();
+    bustub_->GenerateMockTable();
+    saved_memory_limit_ = operator_memory_limit;
+  }
+
+  void TearDown() override { operator_memory_limit = saved_memory_limit_; }
+
+  /** Run a statement and return its output, with the cells of a row separated by spaces */
+  auto Execute(const std::string &sql) -> std::string {
+    std::stringstream ss;
+    SimpleStreamWriter writer(ss, true, " ");
+    EXPECT_TRUE(bustub_->ExecuteSql(sql, writer));
+    return ss.str();
+  }
+
+  /** Run a query and return its rows, every row split into cells */
+  auto Query(const std::string &sql) -> std::vector<std::vector<std::string>> {
+    std::vector<std::vector<std::string>> rows;
+    for (const auto &line : StringUtil::Split(Execute(sql), '\n')) {
+      if (!line.empty()) {
+        rows.push_back(StringUtil::Split(line, ' '));
+      }
+    }
+    return rows;
+  }
+
+  /** Run a query with EXPLAIN ANALYZE and return the peak memory of the query */
+  auto PeakMemory(const std::string &sql) -> size_t {
+    auto output = Execute("explain analyze " + sql);
+    auto pos = output.find("peak memory: ");
+    EXPECT_NE(pos, std::string::npos) << output;
+    return pos == std::string::npos ? 0 : std::stoul(output.substr(pos + std::string{"peak memory: "}.size()));
+  }
+
+  std::unique_ptr<BustubInstance> bustub_;
+  size_t saved_memory_limit_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,135 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// plan_cache_test.cpp
+//
+// Identification: test/planner/plan_cache_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "common/bustub_instance.h"
+#include "execution/plans/values_plan.h"
+#include "gtest/gtest.h"
+#include "planner/plan_cache.h"
+
+namespace bustub {
+
+class PlanCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    bustub_ = std::make_unique<BustubInstance>();
+    // Index headers live on the first page, which must not belong to the heap of a table indexed later.
+    bustub_->GenerateTestTable();
+    Execute("create table t1(k int, v int);");
+    Execute("insert into t1 values (1, 10), (2, 20), (3, 30);");
+  }
+
+  auto Execute(const std::string &sql) -> std::string {
+    std::stringstream ss;
+    SimpleStreamWriter writer(ss, true, " ");
+    EXPECT_TRUE(bustub_->ExecuteSql(sql, writer));
+    return ss.str();
+  }
+
+  auto Hits() -> size_t { return bustub_->GetPlanCache().GetHits(); }
+
+  std::unique_ptr<BustubInstance> bustub_;
+};
+
+// NOLINTNEXTLINE
+TEST(PlanCacheKeyTest, Normalize) {
+  EXPECT_EQ(PlanCache::Normalize("  select *\n\tfrom   t1 ;; "), "select * from t1");
+  EXPECT_EQ(PlanCache::Normalize("select 'a  b' from t1;"), "select 'a  b' from t1");
+  EXPECT_EQ(PlanCache::Normalize("select 'it''s  ' ,  1"), "select 'it''s  ' , 1");
+}
+
+// NOLINTNEXTLINE
+TEST(PlanCacheKeyTest, Eviction) {
+  PlanCache cache(2);
+  auto make_plan = [](uint64_t version) {
+    auto schema = std::make_shared<Schema>(std::vector<Column>{});
+    return CachedPlan{std::make_shared<ValuesPlanNode>(schema, std::vector<std::vector<AbstractExpressionRef>>{}),
+                      schema, version, nullptr};
+  };
+  cache.Put("a", make_plan(0));
+  cache.Put("b", make_plan(0));
+  ASSERT_TRUE(cache.Get("a", 0).has_value());
+  // `b` is now the least recently used plan.
+  cache.Put("c", make_plan(0));
+  EXPECT_FALSE(cache.Get("b", 0).has_value());
+  EXPECT_TRUE(cache.Get("a", 0).has_value());
+  EXPECT_TRUE(cache.Get("c", 0).has_value());
+  // A plan made against an older catalog is dropped.
+  EXPECT_FALSE(cache.Get("c", 1).has_value());
+  EXPECT_FALSE(cache.Get("c", 0).has_value());
+}
+
+// NOLINTNEXTLINE
+TEST_F(PlanCacheTest, RepeatedStatements) {
+  EXPECT_EQ(Execute("select v from t1 where k = 2;"), "20 \n");
+  auto hits = Hits();
+  EXPECT_EQ(Execute("select v  from t1\nwhere k = 2"), "20 \n");
+  EXPECT_EQ(Hits(), hits + 1);
+
+  // The cached plan sees rows inserted since.
+  EXPECT_EQ(Execute("select v from t1 where k = 4;"), "");
+  Execute("insert into t1 values (4, 40);");
+  hits = Hits();
+  EXPECT_EQ(Execute("select v from t1 where k = 4;"), "40 \n");
+  EXPECT_EQ(Hits(), hits + 1);
+
+  // A new index invalidates the plan, and the one planned next uses the index.
+  Execute("create index t1k on t1(k);");
+  hits = Hits();
+  EXPECT_EQ(Execute("select v from t1 where k = 4;"), "40 \n");
+  EXPECT_EQ(Hits(), hits);
+  EXPECT_EQ(Execute("select v from t1 where k = 4;"), "40 \n");
+  EXPECT_EQ(Hits(), hits + 1);
+  EXPECT_NE(Execute("explain select v from t1 where k = 4;").find("BitmapHeapScan"), std::string::npos);
+}
+
+// NOLINTNEXTLINE
+TEST_F(PlanCacheTest, PreparedStatements) {
+  Execute("prepare q as select v from t1 where k = $1;");
+  EXPECT_EQ(Execute("execute q(1);"), "10 \n");
+  // Later EXECUTEs bind their values to the plan of the first one.
+  auto hits = Hits();
+  EXPECT_EQ(Execute("execute q(3);"), "30 \n");
+  EXPECT_EQ(Execute("execute q(2);"), "20 \n");
+  EXPECT_EQ(Execute("execute q(1);"), "10 \n");
+  EXPECT_EQ(Hits(), hits + 3);
+
+  // Preparing a name again must not run the plan of the statement it had before.
+  Execute("deallocate q;");
+  Execute("prepare q as select k from t1 where v = $1;");
+  EXPECT_EQ(Execute("execute q(30);"), "3 \n");
+  EXPECT_EQ(Execute("execute q(1);"), "");
+}
+
+// NOLINTNEXTLINE
+TEST_F(PlanCacheTest, PreparedLimitIsNotCached) {
+  // The limit is planned with the value given, so the plan does not hold for other values.
+  Execute("prepare q as select k from t1 where k > $1 limit $2;");
+  EXPECT_EQ(Execute("execute q(0, 1);"), "1 \n");
+  auto hits = Hits();
+  EXPECT_EQ(Execute("execute q(0, 2);"), "1 \n2 \n");
+  EXPECT_EQ(Execute("execute q(1, 1);"), "2 \n");
+  EXPECT_EQ(Hits(), hits);
+}
+
+// NOLINTNEXTLINE
+TEST_F(PlanCacheTest, MultipleStatementsAreNotCached) {
+  Execute("select v from t1 where k = 1; select v from t1 where k = 2;");
+  auto hits = Hits();
+  EXPECT_EQ(Execute("select v from t1 where k = 1; select v from t1 where k = 2;"), "10 \n20 \n");
+  EXPECT_EQ(Hits(), hits);
+}
+
+}  // namespace bustub
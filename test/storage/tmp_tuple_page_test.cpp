@@ -19,11 +19,7 @@
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(TmpTuplePageTest, DISABLED_BasicTest) {
-  // There are many ways to do this assignment, and this is only one of them.
-  // If you don't like the TmpTuplePage idea, please feel free to delete this test case entirely.
-  // You will get full credit as long as you are correctly using a linear probe hash table.
-
+TEST(TmpTuplePageTest, BasicTest) {
   TmpTuplePage page{};
   page_id_t page_id = 15445;
   page.Init(page_id, BUSTUB_PAGE_SIZE);
@@ -48,4 +44,43 @@ TEST(TmpTuplePageTest, DISABLED_BasicTest) {
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + BUSTUB_PAGE_SIZE - 4), 123);
 }
 
+// NOLINTNEXTLINE
+TEST(TmpTuplePageTest, IterateTest) {
+  TmpTuplePage page{};
+  page.Init(15445, BUSTUB_PAGE_SIZE);
+
+  std::vector<Column> columns;
+  columns.emplace_back("A", TypeId::INTEGER);
+  columns.emplace_back("B", TypeId::VARCHAR, 16);
+  Schema schema(columns);
+
+  // Fill the page up.
+  int count = 0;
+  while (true) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(count), ValueFactory::GetVarcharValue("tuple")};
+    TmpTuple tmp_tuple(INVALID_PAGE_ID, 0);
+    if (!page.Insert(Tuple(values, &schema), &tmp_tuple)) {
+      break;
+    }
+    ASSERT_EQ(tmp_tuple.GetPageId(), 15445);
+    Tuple tuple;
+    page.Get(tmp_tuple.GetOffset(), &tuple);
+    ASSERT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), count);
+    count++;
+  }
+  ASSERT_GT(count, 100);
+
+  // Tuples are visited in reverse insertion order.
+  auto offset = page.GetFirstTupleOffset();
+  for (int i = count - 1; i >= 0; i--) {
+    ASSERT_LT(offset, BUSTUB_PAGE_SIZE);
+    Tuple tuple;
+    page.Get(offset, &tuple);
+    ASSERT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), i);
+    ASSERT_EQ(tuple.GetValue(&schema, 1).ToString(), "tuple");
+    offset = page.GetNextTupleOffset(offset);
+  }
+  ASSERT_EQ(offset, BUSTUB_PAGE_SIZE);
+}
+
 }  // namespace bustub